@@ -0,0 +1,146 @@
+#include <digital_filters/filters.hpp>
+#include <digital_filters/utilities.hpp>
+#include <digital_filters/design_cache.hpp>
+#include <digital_filters/frequency_response.hpp>
+#include <benchmark/benchmark.h>
+#include <complex>
+#include <vector>
+
+
+// Product of two polynomials of the same size
+template <class Scalar>
+static void BM_PolyProd(
+  benchmark::State& state
+)
+{
+  std::vector<Scalar> p1(state.range(0)), p2(state.range(0));
+  for(std::size_t i=0; i<p1.size(); i++) {
+    p1[i] = static_cast<Scalar>(1.0 / (i+1));
+    p2[i] = static_cast<Scalar>(1.0 - 0.5 / (i+1));
+  }
+  for(auto _ : state)
+    benchmark::DoNotOptimize(digital_filters::polyProd(p1, p2));
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_PolyProd, float)->ArgName("size")->RangeMultiplier(4)->Range(4, 1<<10)->Complexity();
+BENCHMARK_TEMPLATE(BM_PolyProd, double)->ArgName("size")->RangeMultiplier(4)->Range(4, 1<<10)->Complexity();
+
+
+// Design of a Butterworth filter
+template <class Scalar>
+static void BM_Butterworth(
+  benchmark::State& state
+)
+{
+  for(auto _ : state)
+    benchmark::DoNotOptimize(digital_filters::butterworth<Scalar,Scalar>(state.range(0), Scalar(10), Scalar(100)));
+}
+BENCHMARK_TEMPLATE(BM_Butterworth, float)->ArgName("order")->DenseRange(2, 16, 2);
+BENCHMARK_TEMPLATE(BM_Butterworth, double)->ArgName("order")->DenseRange(2, 16, 2);
+
+
+// Coefficients of a Butterworth filter, reusing the output vectors
+template <class Scalar>
+static void BM_ButterworthCoefficients(
+  benchmark::State& state
+)
+{
+  std::vector<Scalar> num, den;
+  for(auto _ : state) {
+    digital_filters::butterworth<Scalar>(state.range(0), Scalar(10), Scalar(100), num, den);
+    benchmark::DoNotOptimize(den.data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ButterworthCoefficients, double)->ArgName("order")->RangeMultiplier(2)->Range(4, 128)->Complexity();
+
+
+// Retune a running Butterworth filter, cycling among cached cutoffs
+template <class Scalar>
+static void BM_ButterworthRetune(
+  benchmark::State& state
+)
+{
+  digital_filters::DesignCache<Scalar> cache;
+  auto F = digital_filters::butterworth<Scalar,Scalar>(state.range(0), Scalar(10), Scalar(100));
+  int k = 0;
+  for(auto _ : state) {
+    const auto& design = cache.butterworth(state.range(0), Scalar(10 + (k++ % 16)), Scalar(100));
+    F.setCoefficients(design.numerator, design.denominator);
+    benchmark::DoNotOptimize(F.filter(Scalar(1)));
+  }
+}
+BENCHMARK_TEMPLATE(BM_ButterworthRetune, float)->ArgName("order")->DenseRange(2, 16, 2);
+BENCHMARK_TEMPLATE(BM_ButterworthRetune, double)->ArgName("order")->DenseRange(2, 16, 2);
+
+
+// Design of a moving average
+template <class Scalar>
+static void BM_Average(
+  benchmark::State& state
+)
+{
+  for(auto _ : state)
+    benchmark::DoNotOptimize(digital_filters::average<Scalar,Scalar>(state.range(0), Scalar(1)));
+}
+BENCHMARK_TEMPLATE(BM_Average, float)->ArgName("window")->RangeMultiplier(8)->Range(2, 1<<12);
+BENCHMARK_TEMPLATE(BM_Average, double)->ArgName("window")->RangeMultiplier(8)->Range(2, 1<<12);
+
+
+// Design of an exponential filter
+template <class Scalar>
+static void BM_Exponential(
+  benchmark::State& state
+)
+{
+  for(auto _ : state)
+    benchmark::DoNotOptimize(digital_filters::exponential<Scalar,Scalar>(Scalar(100), Scalar(0.5)));
+}
+BENCHMARK_TEMPLATE(BM_Exponential, float);
+BENCHMARK_TEMPLATE(BM_Exponential, double);
+
+
+// Response of a Butterworth filter, evaluated one frequency at a time
+template <class Scalar>
+static void BM_ResponseNaive(
+  benchmark::State& state
+)
+{
+  const auto F = digital_filters::butterworth<Scalar,Scalar>(state.range(0), Scalar(10), Scalar(100));
+  const std::size_t points = state.range(1);
+  std::vector<std::complex<Scalar>> H(points);
+  for(auto _ : state) {
+    for(std::size_t i=0; i<points; i++) {
+      const Scalar omega = M_PI * i / points;
+      std::complex<Scalar> num = 0, den = 0;
+      for(std::size_t k=0; k<F.numerator().size(); k++)
+        num += F.numerator()[k] * std::polar(Scalar(1), -omega*k);
+      for(std::size_t k=0; k<F.denominator().size(); k++)
+        den += F.denominator()[k] * std::polar(Scalar(1), -omega*k);
+      H[i] = num / den;
+    }
+    benchmark::DoNotOptimize(H.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points);
+}
+BENCHMARK_TEMPLATE(BM_ResponseNaive, double)->ArgNames({"order", "points"})->ArgsProduct({{4, 16}, {1000, 1024}});
+
+
+// Response and group delay of a Butterworth filter, via FrequencyAnalyzer:
+// 1000 points use Horner's method, 1024 points use the FFT
+template <class Scalar>
+static void BM_ResponseAnalyzer(
+  benchmark::State& state
+)
+{
+  const auto F = digital_filters::butterworth<Scalar,Scalar>(state.range(0), Scalar(10), Scalar(100));
+  const digital_filters::FrequencyAnalyzer<Scalar> analyzer(state.range(1), Scalar(100));
+  for(auto _ : state)
+    benchmark::DoNotOptimize(analyzer.evaluate(F));
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK_TEMPLATE(BM_ResponseAnalyzer, float)->ArgNames({"order", "points"})->ArgsProduct({{4, 16}, {1000, 1024}});
+BENCHMARK_TEMPLATE(BM_ResponseAnalyzer, double)->ArgNames({"order", "points"})->ArgsProduct({{4, 16}, {1000, 1024}});
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,447 @@
+#include <digital_filters/filters.hpp>
+#include <digital_filters/filter_bank.hpp>
+#include <digital_filters/filter_chain.hpp>
+#include <digital_filters/filter_fleet.hpp>
+#include <digital_filters/fixed_point_filter.hpp>
+#include <digital_filters/multirate.hpp>
+#include <digital_filters/rank_filter.hpp>
+#include <digital_filters/streaming_stage.hpp>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+
+
+// Signal used in all benchmarks
+template <class Scalar>
+std::vector<Scalar> signal(
+  std::size_t length
+)
+{
+  std::vector<Scalar> x(length);
+  for(std::size_t k=0; k<length; k++)
+    x[k] = static_cast<Scalar>(std::sin(0.01*k) + 0.5*std::cos(0.3*k));
+  return x;
+}
+
+
+// Butterworth filter of the given order
+template <class Scalar>
+digital_filters::Filter<Scalar,Scalar> design(
+  int order
+)
+{
+  return digital_filters::butterworth<Scalar,Scalar>(order, Scalar(10), Scalar(100));
+}
+
+
+// Orders and signal lengths used in all benchmarks
+static void arguments(
+  benchmark::internal::Benchmark* bench
+)
+{
+  bench->ArgNames({"order", "length"});
+  bench->ArgsProduct({{2, 4, 8}, {1<<10, 1<<16}});
+}
+
+
+// Filter one sample at a time
+template <class Scalar>
+static void BM_FilterSample(
+  benchmark::State& state
+)
+{
+  auto F = design<Scalar>(state.range(0));
+  const auto x = signal<Scalar>(state.range(1));
+  for(auto _ : state) {
+    for(const auto& xk : x)
+      benchmark::DoNotOptimize(F.filter(xk));
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_FilterSample, float)->Apply(arguments);
+BENCHMARK_TEMPLATE(BM_FilterSample, double)->Apply(arguments);
+
+
+// Filter a block of samples, keeping the state
+template <class Scalar>
+static void BM_FilterBlock(
+  benchmark::State& state
+)
+{
+  auto F = design<Scalar>(state.range(0));
+  const auto x = signal<Scalar>(state.range(1));
+  std::vector<Scalar> y(x.size());
+  for(auto _ : state) {
+    F.filter(x.data(), y.data(), x.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_FilterBlock, float)->Apply(arguments);
+BENCHMARK_TEMPLATE(BM_FilterBlock, double)->Apply(arguments);
+
+
+// Filter a whole sequence with explicit initial conditions
+template <class Scalar>
+static void BM_FilterSequence(
+  benchmark::State& state
+)
+{
+  const auto F = design<Scalar>(state.range(0));
+  const auto x = signal<Scalar>(state.range(1));
+  const std::vector<Scalar> x0(F.numerator().size()-1, x[0]);
+  const std::vector<Scalar> y0(F.denominator().size()-1, x[0]);
+  for(auto _ : state)
+    benchmark::DoNotOptimize(F.filter(x, x0, y0));
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_FilterSequence, float)->Apply(arguments);
+BENCHMARK_TEMPLATE(BM_FilterSequence, double)->Apply(arguments);
+
+
+// Bi-directional filtering into a pre-allocated buffer
+template <class Scalar>
+static void BM_Filter2(
+  benchmark::State& state
+)
+{
+  auto F = design<Scalar>(state.range(0));
+  const auto x = signal<Scalar>(state.range(1));
+  std::vector<Scalar> y(x.size());
+  for(auto _ : state) {
+    F.filter2(x.data(), y.data(), x.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_Filter2, float)->Apply(arguments);
+BENCHMARK_TEMPLATE(BM_Filter2, double)->Apply(arguments);
+
+
+// Bi-directional filtering returning a new vector
+template <class Scalar>
+static void BM_Filter2Vector(
+  benchmark::State& state
+)
+{
+  const auto F = design<Scalar>(state.range(0));
+  const auto x = signal<Scalar>(state.range(1));
+  for(auto _ : state)
+    benchmark::DoNotOptimize(F.filter2(x));
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_Filter2Vector, float)->Apply(arguments);
+BENCHMARK_TEMPLATE(BM_Filter2Vector, double)->Apply(arguments);
+
+
+// Filter 64 interleaved channels with a bank, possibly in mixed precision
+template <class DataType, class CoeffType>
+static void BM_BankFrames(
+  benchmark::State& state
+)
+{
+  const std::size_t channels = 64;
+  digital_filters::FilterBank<DataType,CoeffType> bank(design<CoeffType>(state.range(0)).template as<DataType,CoeffType>(), channels);
+  auto x = signal<DataType>(channels * state.range(1));
+  for(auto _ : state) {
+    bank.filter(x.data(), x.data(), state.range(1));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_BankFrames, float, float)->Apply(arguments);
+BENCHMARK_TEMPLATE(BM_BankFrames, float, double)->Apply(arguments);
+
+
+// Filter 64 interleaved channels with a fixed-point cascade
+template <class Format>
+static void BM_FixedPointFrames(
+  benchmark::State& state
+)
+{
+  const std::size_t channels = 64;
+  auto bank = digital_filters::quantize<Format>(
+    digital_filters::butterworthSos<double,double>(state.range(0), 10., 100.),
+    channels
+  );
+  const auto values = signal<double>(channels * state.range(1));
+  std::vector<Format> x(values.size());
+  for(std::size_t i=0; i<x.size(); i++)
+    x[i] = Format(0.5 * values[i]);
+  for(auto _ : state) {
+    bank.filter(x.data(), x.data(), state.range(1));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_FixedPointFrames, digital_filters::Q15)->Apply(arguments);
+BENCHMARK_TEMPLATE(BM_FixedPointFrames, digital_filters::Q31)->Apply(arguments);
+
+
+// Decimate by 8 with an FIR filter of 161 taps, evaluating only kept outputs
+template <class Scalar>
+static void BM_FirDecimator(
+  benchmark::State& state
+)
+{
+  auto D = digital_filters::firDecimator<Scalar,Scalar>(8);
+  const auto x = signal<Scalar>(state.range(0));
+  std::vector<Scalar> y(x.size());
+  for(auto _ : state) {
+    benchmark::DoNotOptimize(D.filter(x.data(), y.data(), x.size()));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_FirDecimator, float)->ArgName("length")->Arg(1<<10)->Arg(1<<16);
+BENCHMARK_TEMPLATE(BM_FirDecimator, double)->ArgName("length")->Arg(1<<10)->Arg(1<<16);
+
+
+// Decimate by 64 with a CIC filter, using the order as number of stages
+static void BM_CicDecimator(
+  benchmark::State& state
+)
+{
+  digital_filters::CicDecimator<int> C(state.range(0), 64);
+  const auto values = signal<double>(state.range(1));
+  std::vector<int> x(values.size()), y(values.size());
+  for(std::size_t i=0; i<x.size(); i++)
+    x[i] = static_cast<int>(1000 * values[i]);
+  for(auto _ : state) {
+    benchmark::DoNotOptimize(C.filter(x.data(), y.data(), x.size()));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK(BM_CicDecimator)->Apply(arguments);
+
+
+// Stream blocks of 64 samples through a stage, on a single thread, to
+// measure the overhead of the queues
+template <class Scalar>
+static void BM_StreamingStage(
+  benchmark::State& state
+)
+{
+  digital_filters::StreamingStage<Scalar,digital_filters::Filter<Scalar,Scalar>> stage(
+    design<Scalar>(state.range(0)),
+    1024
+  );
+  auto x = signal<Scalar>(state.range(1));
+  const std::size_t block = 64;
+  for(auto _ : state) {
+    for(std::size_t k=0; k+block<=x.size(); k+=block) {
+      stage.push(x.data() + k, block);
+      stage.process();
+      stage.pop(x.data() + k, block);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_StreamingStage, float)->Apply(arguments);
+BENCHMARK_TEMPLATE(BM_StreamingStage, double)->Apply(arguments);
+
+
+// Exponential, Butterworth and moving average, one full pass per stage
+template <class Scalar>
+static void BM_ChainPasses(
+  benchmark::State& state
+)
+{
+  auto E = digital_filters::exponential<Scalar,Scalar>(Scalar(0.3));
+  auto B = digital_filters::butterworthSos<Scalar,Scalar>(state.range(0), Scalar(10), Scalar(100));
+  digital_filters::MovingAverage<Scalar,Scalar> M(16);
+  auto x = signal<Scalar>(state.range(1));
+  for(auto _ : state) {
+    E.filter(x.data(), x.data(), x.size());
+    B.filter(x.data(), x.data(), x.size());
+    M.filter(x.data(), x.data(), x.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_ChainPasses, float)->Apply(arguments);
+BENCHMARK_TEMPLATE(BM_ChainPasses, double)->Apply(arguments);
+
+
+// Same stages, fused in a chain that processes L1-sized tiles
+template <class Scalar>
+static void BM_ChainTiles(
+  benchmark::State& state
+)
+{
+  digital_filters::FilterChain<Scalar> chain;
+  chain.append(digital_filters::exponential<Scalar,Scalar>(Scalar(0.3)));
+  chain.append(digital_filters::butterworthSos<Scalar,Scalar>(state.range(0), Scalar(10), Scalar(100)));
+  chain.append(digital_filters::MovingAverage<Scalar,Scalar>(16));
+  auto x = signal<Scalar>(state.range(1));
+  for(auto _ : state) {
+    chain.filter(x.data(), x.data(), x.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_ChainTiles, float)->Apply(arguments);
+BENCHMARK_TEMPLATE(BM_ChainTiles, double)->Apply(arguments);
+
+
+// Smoothed signal and two derivatives, via three FIR filters
+template <class Scalar>
+static void BM_SavitzkyGolayFilters(
+  benchmark::State& state
+)
+{
+  std::vector<digital_filters::Filter<Scalar,Scalar>> filters;
+  for(unsigned int d=0; d<=2; d++)
+    filters.push_back(digital_filters::savitzkyGolay<Scalar,Scalar>(state.range(0), 3, d));
+  const auto x = signal<Scalar>(state.range(1));
+  for(auto _ : state) {
+    for(const auto& xk : x)
+      for(auto& F : filters)
+        benchmark::DoNotOptimize(F.filter(xk));
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_SavitzkyGolayFilters, double)->ArgNames({"window", "length"})->ArgsProduct({{11, 31}, {1<<10, 1<<16}});
+
+
+// Smoothed signal and two derivatives, via the symmetric kernel
+template <class Scalar>
+static void BM_SavitzkyGolayKernel(
+  benchmark::State& state
+)
+{
+  digital_filters::SavitzkyGolay<Scalar,Scalar> S(state.range(0), 3, 2);
+  const auto x = signal<Scalar>(state.range(1));
+  for(auto _ : state) {
+    for(const auto& xk : x)
+      benchmark::DoNotOptimize(S.filter(xk).data());
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_SavitzkyGolayKernel, double)->ArgNames({"window", "length"})->ArgsProduct({{11, 31}, {1<<10, 1<<16}});
+
+
+// Running median, block interface
+template <class Scalar>
+static void BM_MedianFilter(
+  benchmark::State& state
+)
+{
+  auto M = digital_filters::medianFilter<Scalar>(state.range(0));
+  auto x = signal<Scalar>(state.range(1));
+  for(auto _ : state) {
+    M.filter(x.data(), x.data(), x.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK_TEMPLATE(BM_MedianFilter, float)->ArgNames({"window", "length"})->ArgsProduct({{5, 63, 1023}, {1<<10, 1<<16}});
+BENCHMARK_TEMPLATE(BM_MedianFilter, double)->ArgNames({"window", "length"})->ArgsProduct({{5, 63, 1023}, {1<<10, 1<<16}});
+
+
+// Decaying tail after an impulse, for each denormal policy
+static void BM_DenormalTail(
+  benchmark::State& state
+)
+{
+  // the state stays in the denormal range for about 50000 samples
+  auto F = digital_filters::exponential<float,float>(0.001f);
+  F.setDenormalPolicy(static_cast<digital_filters::DenormalPolicy>(state.range(0)));
+  std::vector<float> x(1<<17, 0.f), y(x.size());
+  x[0] = 1.f;
+  for(auto _ : state) {
+    F.initInput(0.f);
+    F.filter(x.data(), y.data(), x.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK(BM_DenormalTail)->ArgName("policy")->DenseRange(0, 3);
+
+
+// Same as above, one sample at a time
+static void BM_DenormalTailSamples(
+  benchmark::State& state
+)
+{
+  auto F = digital_filters::exponential<float,float>(0.001f);
+  F.setDenormalPolicy(static_cast<digital_filters::DenormalPolicy>(state.range(0)));
+  std::vector<float> x(1<<17, 0.f);
+  x[0] = 1.f;
+  for(auto _ : state) {
+    F.initInput(0.f);
+    for(const auto& xk : x)
+      benchmark::DoNotOptimize(F.filter(xk));
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK(BM_DenormalTailSamples)->ArgName("policy")->DenseRange(0, 3);
+
+
+// Warm restart of a large bank from a checkpoint
+static void BM_BankRestore(
+  benchmark::State& state
+)
+{
+  const std::size_t channels = state.range(0);
+  digital_filters::FilterBank<float,double> bank(design<double>(8).as<float,double>(), channels);
+  auto x = signal<float>(channels);
+  bank.filter(x.data(), x.data());
+  std::vector<unsigned char> buffer;
+  bank.checkpoint(buffer);
+  digital_filters::FilterBank<float,double> other(bank);
+  for(auto _ : state) {
+    other.restore(buffer.data(), buffer.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_BankRestore)->ArgName("channels")->Arg(1000)->Arg(100000);
+
+
+// Heterogeneous channels, one Filter each
+static void BM_FleetFilters(
+  benchmark::State& state
+)
+{
+  const std::size_t channels = state.range(0);
+  std::vector<digital_filters::Filter<float,double>> filters;
+  for(std::size_t c=0; c<channels; c++)
+    filters.push_back(design<double>(2 + 2*(c%4)).as<float,double>());
+  auto x = signal<float>(channels);
+  for(auto _ : state) {
+    for(std::size_t c=0; c<channels; c++)
+      x[c] = filters[c].filter(x[c]);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * channels);
+}
+BENCHMARK(BM_FleetFilters)->ArgName("channels")->Arg(1000)->Arg(100000);
+
+
+// Same channels, in a fleet
+static void BM_FleetSweep(
+  benchmark::State& state
+)
+{
+  const std::size_t channels = state.range(0);
+  digital_filters::FilterFleet<float,double> fleet;
+  std::size_t ids[4];
+  for(int d=0; d<4; d++)
+    ids[d] = fleet.addDesign(design<double>(2 + 2*d).as<float,double>());
+  fleet.reserve(channels, 5*channels);
+  for(std::size_t c=0; c<channels; c++)
+    fleet.add(ids[c%4]);
+  auto x = signal<float>(channels);
+  for(auto _ : state) {
+    fleet.filter(x.data(), x.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * channels);
+}
+BENCHMARK(BM_FleetSweep)->ArgName("channels")->Arg(1000)->Arg(100000);
+
+
+BENCHMARK_MAIN();
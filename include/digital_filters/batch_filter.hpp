@@ -0,0 +1,216 @@
+/** @file batch_filter.hpp
+  * @brief Header file containing the BatchFilter class.
+  */
+#pragma once
+
+#include <digital_filters/filter.hpp>
+#include <digital_filters/thread_pool.hpp>
+#include <vector>
+#include <cstddef>
+
+namespace digital_filters {
+
+/// Applies the same filter to many independent signals in parallel.
+/** Signals are distributed over a ThreadPool. Each worker owns a copy of
+  * the filter, including the buffers it uses for bi-directional filtering,
+  * which is reused across signals: workers do not allocate memory.
+  *
+  * Each signal is processed by exactly the same sequence of operations,
+  * whichever worker runs it. Therefore, results do not depend on the number
+  * of threads, and they are returned in the same order as the inputs.
+  *
+  * If the design has a Probe, workers report to it as well: each signal
+  * (or each long signal, for the chunked algorithm) counts as a block.
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the coefficients of the transfer function.
+  */
+template <class DataType, class CoeffType>
+class BatchFilter {
+public:
+  /// Creates a batch executor.
+  /** @param design filter applied to all signals. Its current state is used
+    *   as initial state when filtering each signal forward.
+    * @param threads number of workers, including the calling thread. If
+    *   zero, the number of hardware threads is used.
+    */
+  BatchFilter(
+    const Filter<DataType,CoeffType>& design,
+    std::size_t threads = 0
+  );
+
+  /// Number of workers, including the calling thread.
+  inline std::size_t threads() const { return pool_.workers(); }
+
+  /// Filter applied to all signals.
+  inline const Filter<DataType,CoeffType>& design() const { return design_; }
+
+  /// Filter each signal forward.
+  /** Each signal is filtered by a copy of design(), including its state.
+    * @param signals signals to be filtered.
+    * @return filtered signals, in the same order as the inputs.
+    */
+  std::vector<std::vector<DataType>> filter(
+    const std::vector<std::vector<DataType>>& signals
+  );
+
+  /// Filter each signal forward, reading from and writing to a matrix.
+  /** Signal \f$ r \f$ starts at `x_in + r*stride` and it has `lengths[r]`
+    * samples. The same layout is used for the outputs.
+    * @param x_in pointer to the first input sample.
+    * @param y_out pointer to the first output sample. It can be equal to
+    *   `x_in`.
+    * @param stride distance between the first samples of consecutive rows.
+    * @param lengths number of samples in each row.
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t stride,
+    const std::vector<std::size_t>& lengths
+  );
+
+  /// Filter a single long signal, splitting it into chunks filtered in
+  /// parallel.
+  /** This produces the same output as Filter::filter(const std::vector<DataType>&, const std::vector<DataType>&, const std::vector<DataType>&)
+    * up to rounding errors. The recursion is evaluated in two steps:
+    * -# Each chunk is filtered in parallel, starting from a zero state
+    *    (except the first one, which uses the given initial conditions).
+    * -# The chunk boundaries are scanned in order: the state entering each
+    *    chunk is propagated through the state-transition matrix of the
+    *    filter, which gives the response to be added to the outputs of the
+    *    chunk and the contribution to the state entering the next one.
+    *    The propagation stops as soon as the state becomes negligible,
+    *    which happens after a few time constants for stable filters.
+    *
+    * Therefore, as long as the chunks are much longer than the time
+    * constants of the filter, the total work is close to the one of the
+    * sequential algorithm, and the speedup scales with the number of
+    * threads.
+    *
+    * Chunks are filtered using a Direct Form II Transposed structure. With
+    * a single thread, or with signals shorter than two chunks, the result
+    * is the one of a sequential Direct Form II Transposed filter. Splitting
+    * the signal adds rounding errors comparable to the ones of the
+    * sequential recursion: for well conditioned filters, outputs differ by
+    * a few tens of `std::numeric_limits<DataType>::epsilon()` times the peak
+    * magnitude of the output.
+    * For poorly conditioned filters (high order and very low cutoff), both
+    * errors grow with the magnitude of the internal state, and so does the
+    * difference with the Direct Form I structure used by Filter.
+    * Marginally stable filters (such as integrators) never reach a
+    * negligible state: the corrections then span whole chunks, and the
+    * computation is effectively sequential.
+    * @param x sequence of inputs.
+    * @param x0 initial conditions on the input (time-ascending).
+    * @param y0 initial conditions on the output (time-ascending).
+    * @return the filtered sequence.
+    */
+  std::vector<DataType> filter(
+    const std::vector<DataType>& x,
+    const std::vector<DataType>& x0,
+    const std::vector<DataType>& y0
+  );
+
+  /// Bi-directional filtering of each signal.
+  /** @param signals signals to be filtered.
+    * @param padding number of samples used to extend each signal on both
+    *   sides. It must be smaller than the length of all signals.
+    * @return filtered signals, in the same order as the inputs.
+    * @see Filter::filter2(const DataType*, DataType*, std::size_t, std::size_t)
+    */
+  std::vector<std::vector<DataType>> filter2(
+    const std::vector<std::vector<DataType>>& signals,
+    std::size_t padding = 0
+  );
+
+  /// Bi-directional filtering of each signal, reading from and writing to
+  /// a matrix.
+  /** @see filter(const DataType*, DataType*, std::size_t, const std::vector<std::size_t>&)
+    * @see Filter::filter2(const DataType*, DataType*, std::size_t, std::size_t)
+    */
+  void filter2(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t stride,
+    const std::vector<std::size_t>& lengths,
+    std::size_t padding = 0
+  );
+
+  /// Filter a block of samples for each of many streams.
+  /** Each stream keeps its own state across calls. Stream \f$ s \f$ reads
+    * `n` samples from `x_in + s*stride` and writes them to
+    * `y_out + s*stride`.
+    * @param streams filters associated to the streams, usually copies of
+    *   design().
+    * @param x_in pointer to the first input sample.
+    * @param y_out pointer to the first output sample. It can be equal to
+    *   `x_in`.
+    * @param stride distance between the first samples of consecutive rows.
+    * @param n number of samples per stream.
+    */
+  void filterStreams(
+    std::vector<Filter<DataType,CoeffType>>& streams,
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t stride,
+    std::size_t n
+  );
+
+private:
+  /// Filter one signal forward using the scratch filter of a worker.
+  void forward(
+    std::size_t worker,
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  );
+
+  /// Filter one signal in both directions using the scratch filter of a
+  /// worker.
+  void bidirectional(
+    std::size_t worker,
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n,
+    std::size_t padding
+  );
+
+  /// Filter a sequence using a Direct Form II Transposed structure.
+  /** @param state state of the filter, updated in-place.
+    * @param x_in pointer to `n` input samples.
+    * @param y_out pointer to `n` output samples.
+    * @param n number of samples.
+    */
+  void transposed(
+    DataType* state,
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  ) const;
+
+  /// Adds the response to an initial state to a sequence of outputs.
+  /** @param state initial state. It is replaced by the state after `n`
+    *   samples.
+    * @param y_out pointer to `n` output samples.
+    * @param n number of samples.
+    */
+  void addStateResponse(
+    DataType* state,
+    DataType* y_out,
+    std::size_t n
+  ) const;
+
+  Filter<DataType,CoeffType> design_; ///< Filter applied to all signals.
+  ThreadPool pool_; ///< Workers.
+  std::vector<Filter<DataType,CoeffType>> filters_; ///< One filter per worker.
+  /// Numerator, padded with zeros to the size of the denominator.
+  std::vector<CoeffType> bp_;
+  /// Denominator, padded with zeros to the size of the numerator.
+  std::vector<CoeffType> ap_;
+  /// Minimum number of samples in each chunk of a long signal.
+  static constexpr std::size_t min_chunk_ = 4096;
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/batch_filter.hxx>
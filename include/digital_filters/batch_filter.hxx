@@ -0,0 +1,273 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+
+namespace digital_filters {
+
+template<class DataType, class CoeffType>
+BatchFilter<DataType,CoeffType>::BatchFilter(
+  const Filter<DataType,CoeffType>& design,
+  std::size_t threads
+)
+: design_(design)
+, pool_(threads)
+, filters_(pool_.workers(), design)
+{
+  const auto& b = design_.numerator();
+  const auto& a = design_.denominator();
+  const std::size_t size = std::max(b.size(), a.size());
+  bp_.assign(size, CoeffType());
+  ap_.assign(size, CoeffType());
+  std::copy(b.begin(), b.end(), bp_.begin());
+  std::copy(a.begin(), a.end(), ap_.begin());
+}
+
+
+template<class DataType, class CoeffType>
+std::vector<std::vector<DataType>> BatchFilter<DataType,CoeffType>::filter(
+  const std::vector<std::vector<DataType>>& signals
+)
+{
+  std::vector<std::vector<DataType>> outputs(signals.size());
+  for(unsigned int i=0; i<signals.size(); i++)
+    outputs[i].resize(signals[i].size());
+  pool_.run(signals.size(), [&](std::size_t task, std::size_t worker) {
+    forward(worker, signals[task].data(), outputs[task].data(), signals[task].size());
+  });
+  return outputs;
+}
+
+
+template<class DataType, class CoeffType>
+void BatchFilter<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t stride,
+  const std::vector<std::size_t>& lengths
+)
+{
+  pool_.run(lengths.size(), [&](std::size_t task, std::size_t worker) {
+    forward(worker, x_in + task*stride, y_out + task*stride, lengths[task]);
+  });
+}
+
+
+template<class DataType, class CoeffType>
+std::vector<DataType> BatchFilter<DataType,CoeffType>::filter(
+  const std::vector<DataType>& x,
+  const std::vector<DataType>& x0,
+  const std::vector<DataType>& y0
+)
+{
+  const auto& b = design_.numerator();
+  const auto& a = design_.denominator();
+  // check sizes
+  if(x0.size() != b.size() - 1) {
+    throw std::runtime_error(
+      "BatchFilter::filter: initial conditions 'x0' have " +
+      std::to_string(x0.size()) + " elements, but " +
+      std::to_string(b.size() - 1) + " are required"
+    );
+  }
+  if(y0.size() != a.size() - 1) {
+    throw std::runtime_error(
+      "BatchFilter::filter: initial conditions 'y0' have " +
+      std::to_string(y0.size()) + " elements, but " +
+      std::to_string(a.size() - 1) + " are required"
+    );
+  }
+
+  // Transposed state equivalent to the initial conditions:
+  //   s_i = sum_{j>i} b_j x_{i-j} - a_j y_{i-j}
+  const std::size_t order = bp_.size() - 1;
+  std::vector<DataType> initial(order, DataType());
+  for(std::size_t i=0; i<order; i++) {
+    for(std::size_t j=i+1; j<b.size(); j++)
+      initial[i] = initial[i] + b[j] * x0[x0.size()+i-j];
+    for(std::size_t j=i+1; j<a.size(); j++)
+      initial[i] = initial[i] - a[j] * y0[y0.size()+i-j];
+  }
+
+  // Split the signal into chunks of equal length (the last one might be
+  // longer), keeping each of them long enough to amortize the corrections
+  const std::size_t n = x.size();
+  const std::size_t chunks = std::max<std::size_t>(1, std::min(threads(), n / min_chunk_));
+  const std::size_t length = n / chunks;
+  std::vector<DataType> y(n);
+  DIGITAL_FILTERS_PROBE_BLOCK(design_.probe(), y.data(), n);
+
+  // Step 1: filter the chunks independently. The end state of each chunk
+  // is the contribution of its own inputs to the state of the next one.
+  std::vector<DataType> states(chunks*order, DataType());
+  std::copy(initial.begin(), initial.end(), states.begin());
+  pool_.run(chunks, [&](std::size_t c, std::size_t) {
+    const std::size_t len = (c+1 == chunks) ? n - c*length : length;
+    transposed(states.data()+c*order, x.data()+c*length, y.data()+c*length, len);
+  });
+  if(chunks == 1)
+    return y;
+
+  // Step 2: scan the chunk boundaries. With zero input, the state evolves as
+  // s_{k+1} = A s_k, with (A s)_i = s_{i+1} - a_{i+1} s_0, and each output is
+  // corrected by the first component of the state. Propagating the incoming
+  // state through a chunk gives both the corrections of its outputs and the
+  // contribution to the state entering the next chunk. For stable filters,
+  // the propagation stops early, once the state is negligible.
+  // NOTE: powers of A are not computed explicitly, since repeated squaring
+  // is numerically unstable for poorly conditioned filters.
+  std::vector<DataType> incoming(states.begin(), states.begin()+order);
+  for(std::size_t c=1; c<chunks; c++) {
+    const std::size_t len = (c+1 == chunks) ? n - c*length : length;
+    addStateResponse(incoming.data(), y.data()+c*length, len);
+    for(std::size_t i=0; i<order; i++)
+      incoming[i] = incoming[i] + states[c*order+i];
+  }
+  return y;
+}
+
+
+template<class DataType, class CoeffType>
+std::vector<std::vector<DataType>> BatchFilter<DataType,CoeffType>::filter2(
+  const std::vector<std::vector<DataType>>& signals,
+  std::size_t padding
+)
+{
+  std::vector<std::vector<DataType>> outputs(signals.size());
+  for(unsigned int i=0; i<signals.size(); i++)
+    outputs[i].resize(signals[i].size());
+  pool_.run(signals.size(), [&](std::size_t task, std::size_t worker) {
+    bidirectional(worker, signals[task].data(), outputs[task].data(), signals[task].size(), padding);
+  });
+  return outputs;
+}
+
+
+template<class DataType, class CoeffType>
+void BatchFilter<DataType,CoeffType>::filter2(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t stride,
+  const std::vector<std::size_t>& lengths,
+  std::size_t padding
+)
+{
+  pool_.run(lengths.size(), [&](std::size_t task, std::size_t worker) {
+    bidirectional(worker, x_in + task*stride, y_out + task*stride, lengths[task], padding);
+  });
+}
+
+
+template<class DataType, class CoeffType>
+void BatchFilter<DataType,CoeffType>::filterStreams(
+  std::vector<Filter<DataType,CoeffType>>& streams,
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t stride,
+  std::size_t n
+)
+{
+  pool_.run(streams.size(), [&](std::size_t task, std::size_t) {
+    streams[task].filter(x_in + task*stride, y_out + task*stride, n);
+  });
+}
+
+
+template<class DataType, class CoeffType>
+void BatchFilter<DataType,CoeffType>::forward(
+  std::size_t worker,
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+)
+{
+  // copy-assignment reuses the memory of the scratch filter
+  Filter<DataType,CoeffType>& filter = filters_[worker];
+  filter = design_;
+  filter.filter(x_in, y_out, n);
+}
+
+
+template<class DataType, class CoeffType>
+void BatchFilter<DataType,CoeffType>::bidirectional(
+  std::size_t worker,
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n,
+  std::size_t padding
+)
+{
+  // the scratch filter owns the buffers used by both passes
+  filters_[worker].filter2(x_in, y_out, n, padding);
+}
+
+
+template<class DataType, class CoeffType>
+void BatchFilter<DataType,CoeffType>::transposed(
+  DataType* state,
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+) const
+{
+  const std::size_t order = bp_.size() - 1;
+  const CoeffType* b = bp_.data();
+  const CoeffType* a = ap_.data();
+  for(std::size_t k=0; k<n; k++) {
+    const DataType x = x_in[k];
+    const DataType y = order > 0 ? b[0] * x + state[0] : b[0] * x;
+    for(std::size_t i=0; i+1<order; i++)
+      state[i] = state[i+1] + b[i+1] * x - a[i+1] * y;
+    if(order > 0)
+      state[order-1] = b[order] * x - a[order] * y;
+    y_out[k] = y;
+  }
+}
+
+
+template<class DataType, class CoeffType>
+void BatchFilter<DataType,CoeffType>::addStateResponse(
+  DataType* state,
+  DataType* y_out,
+  std::size_t n
+) const
+{
+  const std::size_t order = bp_.size() - 1;
+  if(order == 0)
+    return;
+  const CoeffType* a = ap_.data();
+  // stop once the state cannot affect the outputs anymore
+  DataType scale = DataType();
+  DataType threshold = DataType();
+  if constexpr(std::numeric_limits<DataType>::is_iec559) {
+    for(std::size_t i=0; i<order; i++)
+      scale = std::max(scale, std::abs(state[i]));
+    threshold = scale * std::numeric_limits<DataType>::epsilon() * std::numeric_limits<DataType>::epsilon();
+  }
+  for(std::size_t k=0; k<n; k++) {
+    const DataType y = state[0];
+    y_out[k] = y_out[k] + y;
+    for(std::size_t i=0; i+1<order; i++)
+      state[i] = state[i+1] - a[i+1] * y;
+    state[order-1] = - a[order] * y;
+    if constexpr(std::numeric_limits<DataType>::is_iec559) {
+      // checking once per "order" samples keeps the overhead low
+      if(k % order == order-1) {
+        DataType magnitude = DataType();
+        for(std::size_t i=0; i<order; i++)
+          magnitude = std::max(magnitude, std::abs(state[i]));
+        if(magnitude <= threshold) {
+          std::fill(state, state+order, DataType());
+          return;
+        }
+      }
+    }
+  }
+}
+
+
+} // namespace digital_filters
@@ -0,0 +1,237 @@
+/** @file checkpoint.hpp
+  * @brief Header file containing the binary format used to checkpoint and
+  *   restore filters.
+  *
+  * A checkpoint is a sequence of records, each one holding the coefficients
+  * and the exact internal state of an object (Filter, SosFilter, FilterBank
+  * or FilterChain), so that a restored object produces bit-identical outputs.
+  * A record starts with a CheckpointHeader, followed by a list of arrays:
+  * each array starts with its number of elements and the size of each
+  * element, and its values are stored as they are in memory. All offsets are
+  * multiples of checkpointAlignment() from the beginning of the record.
+  *
+  * Values are stored in the byte order of the machine, without conversion:
+  * checkpoints are meant for warm restarts of the same program, not for
+  * long-term storage. Since arrays are aligned, a record can be read in-place
+  * from any buffer aligned to checkpointAlignment(), *e.g.*, from a
+  * memory-mapped file: restoring an object copies its state straight from
+  * the file into the buffers of the object, without parsing or intermediate
+  * allocations.
+  *
+  * Example:
+  * @code
+  * std::vector<unsigned char> buffer;
+  * bank.checkpoint(buffer);
+  * // ... write the buffer to a file, map it back in memory ...
+  * other_bank.restore(mapped_data, mapped_size);
+  * @endcode
+  */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace digital_filters {
+
+/// Version of the checkpoint format written by this library.
+/** Records with a different version are rejected by CheckpointReader.
+  */
+constexpr std::uint16_t checkpointVersion() { return 1; }
+
+
+/// Alignment, in bytes, of all arrays stored in a checkpoint.
+constexpr std::size_t checkpointAlignment() { return 16; }
+
+
+/// Type of object stored in a checkpoint record.
+enum class CheckpointKind : std::uint16_t {
+  /// A Filter.
+  Filter = 1,
+  /// A SosFilter.
+  SosFilter = 2,
+  /// A FilterBank.
+  FilterBank = 3,
+  /// A FilterChain, followed by the records of its stages.
+  FilterChain = 4
+};
+
+
+/// Header of a checkpoint record.
+struct CheckpointHeader {
+  /// Identifies checkpoint records, see checkpointMagic().
+  /** Since it is stored in the byte order of the machine, it also detects
+    * checkpoints written by machines with a different byte order.
+    */
+  std::uint32_t magic;
+  std::uint16_t version; ///< Version of the format.
+  std::uint16_t kind; ///< Type of object, see CheckpointKind.
+  std::uint16_t data_type; ///< Code of the type of the samples.
+  std::uint16_t coeff_type; ///< Code of the type of the coefficients.
+  std::uint16_t accumulator_type; ///< Code of the type of the state.
+  std::uint16_t reserved; ///< Unused, always zero.
+  std::uint64_t size; ///< Size of the whole record, in bytes.
+  std::uint64_t padding; ///< Unused, always zero.
+};
+
+
+/// Value of CheckpointHeader::magic, *i.e.*, the characters "DFCK".
+constexpr std::uint32_t checkpointMagic() { return 0x4B434644; }
+
+
+/// Code that identifies a type in a checkpoint.
+/** The code combines the size of the type with its category (floating
+  * point, signed or unsigned integer, other), so that checkpoints are not
+  * restored into objects that would interpret their bytes differently.
+  * @return zero for `void`.
+  */
+template <class T>
+constexpr std::uint16_t checkpointTypeCode();
+
+
+/// Generates the header of a record.
+/** The size of the record is set by CheckpointWriter::close().
+  * @tparam DataType Type of the samples.
+  * @tparam CoeffType Type of the coefficients, `void` if not relevant.
+  * @tparam Accumulator Type of the state, `void` if not relevant.
+  * @param kind type of the object stored in the record.
+  */
+template <class DataType, class CoeffType = void, class Accumulator = void>
+CheckpointHeader checkpointHeader(
+  CheckpointKind kind
+);
+
+
+/// Whether objects of a given type can be checkpointed.
+/** This is true if the type provides the methods
+  * `checkpoint(std::vector<unsigned char>&) const` and
+  * `restore(const void*, std::size_t)`.
+  */
+template <class T, class = void>
+struct SupportsCheckpoint : std::false_type {};
+
+/// Specialization for checkpointable types.
+template <class T>
+struct SupportsCheckpoint<T, std::void_t<
+  decltype(std::declval<const T&>().checkpoint(std::declval<std::vector<unsigned char>&>())),
+  decltype(std::declval<T&>().restore(std::declval<const void*>(), std::size_t()))
+>> : std::true_type {};
+
+
+/// Appends a record to a checkpoint buffer.
+/** The header is written on construction, then the arrays are appended in
+  * the order given by the caller. Records of other objects, such as the
+  * stages of a chain, can be nested by calling their `checkpoint()` method
+  * before closing the record.
+  */
+class CheckpointWriter {
+public:
+  /// Starts a new record at the end of the buffer.
+  /** @param buffer destination of the record. Its previous content is kept,
+    *   so that multiple records can be stored in the same buffer.
+    * @param header header of the record, see checkpointHeader().
+    */
+  CheckpointWriter(
+    std::vector<unsigned char>& buffer,
+    const CheckpointHeader& header
+  );
+
+  /// Appends an array.
+  /** @param values pointer to `n` values. Their type must be trivially
+    *   copyable.
+    * @param n number of values.
+    */
+  template <class T>
+  void write(
+    const T* values,
+    std::size_t n
+  );
+
+  /// Appends an array with a single value.
+  template <class T>
+  void write(
+    const T& value
+  );
+
+  /// Completes the record, writing its size in the header.
+  void close();
+
+private:
+  /// Appends zeros until the size of the record is aligned.
+  void pad();
+
+  std::vector<unsigned char>& buffer_; ///< Destination of the record.
+  std::size_t start_; ///< Position of the header in the buffer.
+};
+
+
+/// Reads a record of a checkpoint in-place.
+/** Arrays are not copied: they are accessed via pointers into the record,
+  * which must then outlive the pointers.
+  */
+class CheckpointReader {
+public:
+  /// Validates the header of a record.
+  /** @param data pointer to the beginning of the record. It must be aligned
+    *   to checkpointAlignment().
+    * @param size number of bytes available from `data`. It might be larger
+    *   than the record, *e.g.*, if more records follow.
+    * @param expected header that the record should have. Its size is
+    *   ignored.
+    * @note An exception is thrown if the record is not aligned, if it is
+    *   truncated, or if its magic number, version, kind or types differ from
+    *   the expected ones.
+    */
+  CheckpointReader(
+    const void* data,
+    std::size_t size,
+    const CheckpointHeader& expected
+  );
+
+  /// Size of the whole record, in bytes.
+  inline std::size_t size() const { return size_; }
+
+  /// Access the next array.
+  /** @param[out] n number of values in the array.
+    * @return pointer to the values, inside the record.
+    * @note An exception is thrown if the size of the values is not
+    *   `sizeof(T)` or if the array exceeds the record.
+    */
+  template <class T>
+  const T* read(
+    std::size_t& n
+  );
+
+  /// Access the next array, checking its size.
+  /** @param n expected number of values in the array.
+    * @return pointer to the values, inside the record.
+    * @note An exception is thrown if the array does not have `n` values.
+    */
+  template <class T>
+  const T* readExactly(
+    std::size_t n
+  );
+
+  /// Reads the next array, which must have a single value.
+  template <class T>
+  T value();
+
+  /// Restores an object from the next nested record.
+  /** @param object the object to be restored, see SupportsCheckpoint.
+    */
+  template <class Object>
+  void restore(
+    Object& object
+  );
+
+private:
+  const unsigned char* data_; ///< Beginning of the record.
+  std::size_t size_; ///< Size of the record.
+  std::size_t position_; ///< Offset of the next array.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/checkpoint.hxx>
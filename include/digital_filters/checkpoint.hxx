@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+
+namespace digital_filters {
+
+template <class T>
+constexpr std::uint16_t checkpointTypeCode()
+{
+  if constexpr(std::is_void<T>::value)
+    return 0;
+  else {
+    static_assert(sizeof(T) < 256, "checkpointTypeCode: type is too large");
+    std::uint16_t category = 4;
+    if constexpr(std::is_floating_point<T>::value)
+      category = 1;
+    else if constexpr(std::is_integral<T>::value && std::is_signed<T>::value)
+      category = 2;
+    else if constexpr(std::is_integral<T>::value)
+      category = 3;
+    return static_cast<std::uint16_t>((category << 8) | sizeof(T));
+  }
+}
+
+
+template <class DataType, class CoeffType, class Accumulator>
+CheckpointHeader checkpointHeader(
+  CheckpointKind kind
+)
+{
+  CheckpointHeader header;
+  header.magic = checkpointMagic();
+  header.version = checkpointVersion();
+  header.kind = static_cast<std::uint16_t>(kind);
+  header.data_type = checkpointTypeCode<DataType>();
+  header.coeff_type = checkpointTypeCode<CoeffType>();
+  header.accumulator_type = checkpointTypeCode<Accumulator>();
+  header.reserved = 0;
+  header.size = 0;
+  header.padding = 0;
+  return header;
+}
+
+
+inline CheckpointWriter::CheckpointWriter(
+  std::vector<unsigned char>& buffer,
+  const CheckpointHeader& header
+)
+: buffer_(buffer)
+, start_(buffer.size())
+{
+  static_assert(sizeof(CheckpointHeader) % checkpointAlignment() == 0, "CheckpointWriter: misaligned header");
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&header);
+  buffer_.insert(buffer_.end(), bytes, bytes + sizeof(CheckpointHeader));
+}
+
+
+template <class T>
+void CheckpointWriter::write(
+  const T* values,
+  std::size_t n
+)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "CheckpointWriter::write: values must be trivially copyable");
+  const std::uint64_t prefix[2] = {n, sizeof(T)};
+  const auto* bytes = reinterpret_cast<const unsigned char*>(prefix);
+  buffer_.insert(buffer_.end(), bytes, bytes + sizeof(prefix));
+  bytes = reinterpret_cast<const unsigned char*>(values);
+  buffer_.insert(buffer_.end(), bytes, bytes + n*sizeof(T));
+  pad();
+}
+
+
+template <class T>
+void CheckpointWriter::write(
+  const T& value
+)
+{
+  write(&value, 1);
+}
+
+
+inline void CheckpointWriter::close()
+{
+  const std::uint64_t size = buffer_.size() - start_;
+  std::memcpy(buffer_.data() + start_ + offsetof(CheckpointHeader, size), &size, sizeof(size));
+}
+
+
+inline void CheckpointWriter::pad()
+{
+  const std::size_t misalignment = (buffer_.size() - start_) % checkpointAlignment();
+  if(misalignment != 0)
+    buffer_.resize(buffer_.size() + checkpointAlignment() - misalignment, 0);
+}
+
+
+inline CheckpointReader::CheckpointReader(
+  const void* data,
+  std::size_t size,
+  const CheckpointHeader& expected
+)
+: data_(static_cast<const unsigned char*>(data))
+, size_(0)
+, position_(sizeof(CheckpointHeader))
+{
+  if(reinterpret_cast<std::uintptr_t>(data) % checkpointAlignment() != 0)
+    throw std::runtime_error("CheckpointReader: the record is not aligned to " + std::to_string(checkpointAlignment()) + " bytes");
+  if(size < sizeof(CheckpointHeader))
+    throw std::runtime_error("CheckpointReader: the record is truncated");
+  CheckpointHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+  if(header.magic != checkpointMagic())
+    throw std::runtime_error("CheckpointReader: invalid magic number (not a checkpoint, or different byte order)");
+  if(header.version != expected.version) {
+    throw std::runtime_error(
+      "CheckpointReader: unsupported version " + std::to_string(header.version) +
+      " (expected " + std::to_string(expected.version) + ")"
+    );
+  }
+  if(header.kind != expected.kind) {
+    throw std::runtime_error(
+      "CheckpointReader: the record contains an object of kind " +
+      std::to_string(header.kind) + ", but kind " +
+      std::to_string(expected.kind) + " was expected"
+    );
+  }
+  if(header.data_type != expected.data_type || header.coeff_type != expected.coeff_type || header.accumulator_type != expected.accumulator_type)
+    throw std::runtime_error("CheckpointReader: the record was written with different template types");
+  if(header.size < sizeof(CheckpointHeader) || header.size > size || header.size % checkpointAlignment() != 0)
+    throw std::runtime_error("CheckpointReader: the record is truncated");
+  size_ = header.size;
+}
+
+
+template <class T>
+const T* CheckpointReader::read(
+  std::size_t& n
+)
+{
+  std::uint64_t prefix[2];
+  if(size_ - position_ < sizeof(prefix))
+    throw std::runtime_error("CheckpointReader::read: the record is truncated");
+  std::memcpy(prefix, data_ + position_, sizeof(prefix));
+  if(prefix[1] != sizeof(T)) {
+    throw std::runtime_error(
+      "CheckpointReader::read: expected values of " + std::to_string(sizeof(T)) +
+      " bytes, but the array contains values of " + std::to_string(prefix[1]) + " bytes"
+    );
+  }
+  const std::size_t available = size_ - position_ - sizeof(prefix);
+  if(prefix[0] > available / sizeof(T))
+    throw std::runtime_error("CheckpointReader::read: the record is truncated");
+  n = prefix[0];
+  const T* values = reinterpret_cast<const T*>(data_ + position_ + sizeof(prefix));
+  // skip the values and the padding: the record size is aligned
+  const std::size_t bytes = sizeof(prefix) + n*sizeof(T);
+  position_ += (bytes + checkpointAlignment() - 1) / checkpointAlignment() * checkpointAlignment();
+  return values;
+}
+
+
+template <class T>
+const T* CheckpointReader::readExactly(
+  std::size_t n
+)
+{
+  std::size_t m;
+  const T* values = read<T>(m);
+  if(m != n) {
+    throw std::runtime_error(
+      "CheckpointReader::readExactly: expected " + std::to_string(n) +
+      " values, but the array contains " + std::to_string(m)
+    );
+  }
+  return values;
+}
+
+
+template <class T>
+T CheckpointReader::value()
+{
+  T result;
+  std::memcpy(&result, readExactly<T>(1), sizeof(T));
+  return result;
+}
+
+
+template <class Object>
+void CheckpointReader::restore(
+  Object& object
+)
+{
+  position_ += object.restore(data_ + position_, size_ - position_);
+}
+
+} // namespace digital_filters
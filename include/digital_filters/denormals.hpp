@@ -0,0 +1,111 @@
+/** @file denormals.hpp
+  * @brief Header file containing tools that protect recursive filters from
+  *   denormal (subnormal) numbers.
+  */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace digital_filters {
+
+/// Strategies that keep the state of a filter out of the denormal range.
+/** When the input of a recursive filter goes to zero, its state decays
+  * exponentially until it reaches the denormal range, where arithmetic is
+  * 10 to 100 times slower on many CPUs (*e.g.*, x86). The decay can take a
+  * very long time for filters with poles close to \f$ z=1 \f$, such as low
+  * cutoff Butterworth or exponential filters.
+  */
+enum class DenormalPolicy {
+  /// No protection.
+  None,
+  /// Set the FTZ (flush-to-zero) and DAZ (denormals-are-zero) flags of the
+  /// CPU while filtering, see DenormalGuard.
+  /** This is the cheapest policy when filtering blocks of samples. When
+    * filtering one sample at a time, the flags are set and restored at each
+    * call: it is then cheaper to place a single DenormalGuard around the
+    * whole loop.
+    */
+  FlushToZero,
+  /// Add a tiny constant to the recursion.
+  /** The constant denormalThreshold() is added to each output before it is
+    * fed back, which keeps the state in the normal range. Unlike an offset
+    * added to the input, it is not cancelled by filters that block DC. In
+    * mixed precision, the larger threshold between the one of the samples
+    * and the one of the accumulators is used, since outputs are fed back
+    * using both types.
+    * The output changes by a DC offset of denormalThreshold() divided by
+    * \f$ a(1) = \sum_i a_i \f$, which is negligible for any filter that can
+    * be represented with the given types.
+    */
+  Offset,
+  /// Periodically set all state variables smaller than denormalThreshold()
+  /// to zero.
+  /** The state is checked every 1024 samples. Decaying from the threshold
+    * to the denormal range takes as many orders of magnitude as decaying
+    * from one to the threshold, hence slow filters are flushed well before
+    * their state becomes denormal, while fast ones cross the denormal range
+    * in a few samples anyway.
+    */
+  FlushState
+};
+
+
+/// Magnitude below which values are considered negligible by the denormal
+/// policies.
+/** This is the square root of the smallest normal number, *i.e.*, about
+  * \f$ 10^{-19} \f$ for `float` and \f$ 10^{-154} \f$ for `double`. It is
+  * zero for types that are not floating point.
+  */
+template <class T>
+constexpr T denormalThreshold();
+
+
+/// Set to zero all values whose magnitude is smaller than
+/// denormalThreshold().
+/** @param x pointer to `n` values, modified in-place.
+  * @param n number of values.
+  */
+template <class T>
+void flushDenormals(
+  T* x,
+  std::size_t n
+);
+
+
+/// Sets the FTZ and DAZ flags of the current thread while in scope.
+/** With these flags, denormal results are replaced by zero and denormal
+  * operands are treated as zero. Previous flags are restored when the
+  * guard is destroyed. On x86 the flags belong to the SSE control register,
+  * on ARM64 to the FPCR (which only has a flush-to-zero flag); on other
+  * architectures the guard does nothing.
+  *
+  * If the flags are already set, *e.g.*, by an outer guard, the control
+  * register is not written at all.
+  */
+class DenormalGuard {
+public:
+  /// Sets the flags.
+  /** @param enabled if false, the guard does nothing.
+    */
+  explicit DenormalGuard(
+    bool enabled = true
+  );
+
+  /// Restores the flags that were active before the guard was created.
+  ~DenormalGuard();
+
+  DenormalGuard(const DenormalGuard&) = delete;
+  DenormalGuard& operator=(const DenormalGuard&) = delete;
+
+  /// Whether the flags are supported by the current architecture.
+  static constexpr bool supported();
+
+private:
+  std::uint64_t previous_; ///< Control register before the guard.
+  bool restore_; ///< Whether the control register has been changed.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/denormals.hxx>
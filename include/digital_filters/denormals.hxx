@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define DIGITAL_FILTERS_DENORMALS_SSE
+#endif
+
+
+namespace digital_filters {
+
+template <class T>
+constexpr T denormalThreshold()
+{
+  if constexpr(std::is_floating_point<T>::value) {
+    // square root of the smallest normal number, via its exponent
+    T threshold = 1;
+    for(int e=0; e<-std::numeric_limits<T>::min_exponent/2; e++)
+      threshold /= 2;
+    return threshold;
+  }
+  else {
+    return T();
+  }
+}
+
+
+template <class T>
+void flushDenormals(
+  T* x,
+  std::size_t n
+)
+{
+  if constexpr(std::is_floating_point<T>::value) {
+    constexpr T threshold = denormalThreshold<T>();
+    for(std::size_t i=0; i<n; i++)
+      if(std::abs(x[i]) < threshold)
+        x[i] = T(0);
+  }
+}
+
+
+inline DenormalGuard::DenormalGuard(
+  bool enabled
+)
+: previous_(0)
+, restore_(false)
+{
+  if(!enabled)
+    return;
+#if defined(DIGITAL_FILTERS_DENORMALS_SSE)
+  // FTZ is bit 15, DAZ is bit 6
+  constexpr unsigned int flags = 0x8040;
+  const unsigned int csr = _mm_getcsr();
+  if((csr & flags) != flags) {
+    previous_ = csr;
+    restore_ = true;
+    _mm_setcsr(csr | flags);
+  }
+#elif defined(__aarch64__)
+  // FZ is bit 24
+  constexpr std::uint64_t flags = std::uint64_t(1) << 24;
+  std::uint64_t fpcr;
+  asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+  if((fpcr & flags) != flags) {
+    previous_ = fpcr;
+    restore_ = true;
+    fpcr |= flags;
+    asm volatile("msr fpcr, %0" : : "r"(fpcr));
+  }
+#endif
+}
+
+
+inline DenormalGuard::~DenormalGuard()
+{
+  if(!restore_)
+    return;
+#if defined(DIGITAL_FILTERS_DENORMALS_SSE)
+  _mm_setcsr(static_cast<unsigned int>(previous_));
+#elif defined(__aarch64__)
+  asm volatile("msr fpcr, %0" : : "r"(previous_));
+#endif
+}
+
+
+constexpr bool DenormalGuard::supported()
+{
+#if defined(DIGITAL_FILTERS_DENORMALS_SSE) || defined(__aarch64__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace digital_filters
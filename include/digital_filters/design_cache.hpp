@@ -0,0 +1,143 @@
+/** @file design_cache.hpp
+  * @brief Header file containing the DesignCache class.
+  */
+#pragma once
+
+#include <vector>
+#include <map>
+#include <cstddef>
+
+namespace digital_filters {
+
+/// Families of filters whose designs can be stored in a DesignCache.
+enum class DesignFamily {
+  Butterworth, ///< Butterworth low-pass, see butterworth().
+  Average, ///< Moving average, see average().
+  Exponential ///< Exponential smoothing, see exponential().
+};
+
+
+/// Memoized filter designs, to retune filters without redesigning them.
+/** Designing a filter, *e.g.*, a Butterworth one, requires several
+  * polynomial products and memory allocations. When filters are retuned on
+  * the fly, the same designs are often requested many times: this class
+  * stores them, using as key the family, the order and the normalized
+  * parameter of each design (*e.g.*, the ratio between cutoff and sampling
+  * frequencies). Repeated requests only cost a lookup and never allocate.
+  *
+  * The returned coefficients can be passed to Filter::setCoefficients() or
+  * FilterBank::setCoefficients(), which update filters in place:
+  * @code
+  * digital_filters::DesignCache<double> cache;
+  * auto F = digital_filters::butterworth<double,double>(4, 10., 1000.);
+  * // ... later, while filtering:
+  * const auto& design = cache.butterworth(4, cutoff, 1000.);
+  * F.setCoefficients(design.numerator, design.denominator);
+  * @endcode
+  *
+  * The cache stores a bounded number of designs. When it is full, the least
+  * recently used design is replaced. This class is not thread-safe.
+  * @tparam CoeffType Type of the coefficients of the transfer functions.
+  */
+template <class CoeffType>
+class DesignCache {
+public:
+  /// Coefficients of a cached design.
+  struct Design {
+    std::vector<CoeffType> numerator; ///< Numerator of the transfer function.
+    std::vector<CoeffType> denominator; ///< Denominator of the transfer function.
+  };
+
+  /// Creates an empty cache.
+  /** @param capacity maximum number of stored designs. It must be positive.
+    */
+  explicit DesignCache(
+    std::size_t capacity = 64
+  );
+
+  /// Coefficients of a Butterworth filter.
+  /** The design only depends on the ratio `cutoff/sampling`, which is used
+    * as key together with the order.
+    * @param order order of the filter.
+    * @param cutoff cutoff frequency.
+    * @param sampling sampling frequency.
+    * @return reference to the cached design. It remains valid until the
+    *   design is evicted, *i.e.*, until `capacity()` other designs are
+    *   requested, or until clear() is called.
+    */
+  const Design& butterworth(
+    unsigned int order,
+    const CoeffType& cutoff,
+    const CoeffType& sampling
+  );
+
+  /// Coefficients of a moving average with unit gain.
+  /** @param window_size number of averaged samples.
+    * @return reference to the cached design.
+    * @see butterworth() for the lifetime of the returned reference.
+    */
+  const Design& average(
+    int window_size
+  );
+
+  /// Coefficients of an exponential filter.
+  /** @param alpha smoothing coefficient of the filter.
+    * @return reference to the cached design.
+    * @see butterworth() for the lifetime of the returned reference.
+    */
+  const Design& exponential(
+    const CoeffType& alpha
+  );
+
+  /// Maximum number of stored designs.
+  inline std::size_t capacity() const { return capacity_; }
+
+  /// Number of stored designs.
+  inline std::size_t size() const { return entries_.size(); }
+
+  /// Number of requests that were served from the cache.
+  inline std::size_t hits() const { return hits_; }
+
+  /// Number of requests that required a new design.
+  inline std::size_t misses() const { return misses_; }
+
+  /// Remove all stored designs and reset the statistics.
+  void clear();
+
+private:
+  /// Identifies a design.
+  struct Key {
+    DesignFamily family; ///< Family of the filter.
+    int order; ///< Order (or window size) of the filter.
+    CoeffType parameter; ///< Normalized parameter, *e.g.*, the cutoff.
+    /// Lexicographic comparison, used by `std::map`.
+    bool operator<(const Key& other) const;
+  };
+
+  /// A stored design, with the time of its last use.
+  struct Entry {
+    Design design; ///< Coefficients of the filter.
+    std::size_t last_use; ///< Value of `clock_` when last requested.
+  };
+
+  /// Returns the design with the given key, generating it if needed.
+  /** @param key identifier of the design.
+    * @param generate callable that fills the numerator and the denominator
+    *   of a design. It is only invoked in case of a miss.
+    */
+  template <class Generator>
+  const Design& lookup(
+    const Key& key,
+    const Generator& generate
+  );
+
+  std::map<Key,Entry> entries_; ///< Stored designs.
+  std::size_t capacity_; ///< Maximum number of stored designs.
+  std::size_t clock_; ///< Number of requests, used to find unused designs.
+  std::size_t hits_; ///< Number of requests served from the cache.
+  std::size_t misses_; ///< Number of requests that required a new design.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/design_cache.hxx>
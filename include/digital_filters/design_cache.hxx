@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <digital_filters/filters.hpp>
+
+
+namespace digital_filters {
+
+template<class CoeffType>
+DesignCache<CoeffType>::DesignCache(
+  std::size_t capacity
+)
+: capacity_(capacity)
+, clock_(0)
+, hits_(0)
+, misses_(0)
+{
+  if(capacity_ == 0)
+    throw std::runtime_error("DesignCache: the capacity must be positive");
+}
+
+
+template<class CoeffType>
+bool DesignCache<CoeffType>::Key::operator<(
+  const Key& other
+) const
+{
+  return std::tie(family, order, parameter) < std::tie(other.family, other.order, other.parameter);
+}
+
+
+template<class CoeffType>
+const typename DesignCache<CoeffType>::Design& DesignCache<CoeffType>::butterworth(
+  unsigned int order,
+  const CoeffType& cutoff,
+  const CoeffType& sampling
+)
+{
+  const CoeffType normalized = cutoff / sampling;
+  return lookup(
+    Key{DesignFamily::Butterworth, static_cast<int>(order), normalized},
+    [&](Design& design) {
+      digital_filters::butterworth<CoeffType>(order, normalized, CoeffType(1), design.numerator, design.denominator);
+    }
+  );
+}
+
+
+template<class CoeffType>
+const typename DesignCache<CoeffType>::Design& DesignCache<CoeffType>::average(
+  int window_size
+)
+{
+  return lookup(
+    Key{DesignFamily::Average, window_size, CoeffType(1)},
+    [&](Design& design) {
+      digital_filters::average<CoeffType>(window_size, design.numerator, design.denominator);
+    }
+  );
+}
+
+
+template<class CoeffType>
+const typename DesignCache<CoeffType>::Design& DesignCache<CoeffType>::exponential(
+  const CoeffType& alpha
+)
+{
+  return lookup(
+    Key{DesignFamily::Exponential, 1, alpha},
+    [&](Design& design) {
+      digital_filters::exponential<CoeffType>(alpha, design.numerator, design.denominator);
+    }
+  );
+}
+
+
+template<class CoeffType>
+void DesignCache<CoeffType>::clear()
+{
+  entries_.clear();
+  clock_ = 0;
+  hits_ = 0;
+  misses_ = 0;
+}
+
+
+template<class CoeffType>
+template<class Generator>
+const typename DesignCache<CoeffType>::Design& DesignCache<CoeffType>::lookup(
+  const Key& key,
+  const Generator& generate
+)
+{
+  clock_++;
+  auto it = entries_.find(key);
+  if(it != entries_.end()) {
+    hits_++;
+    it->second.last_use = clock_;
+    return it->second.design;
+  }
+
+  // Generate the design before touching the map, so that invalid requests
+  // (which throw) leave the cache unchanged
+  misses_++;
+  Design design;
+  generate(design);
+
+  // when full, the least recently used design is replaced
+  if(entries_.size() >= capacity_) {
+    auto oldest = entries_.begin();
+    for(auto e=entries_.begin(); e!=entries_.end(); ++e)
+      if(e->second.last_use < oldest->second.last_use)
+        oldest = e;
+    entries_.erase(oldest);
+  }
+  it = entries_.emplace(key, Entry{std::move(design), clock_}).first;
+  return it->second.design;
+}
+
+} // namespace digital_filters
@@ -0,0 +1,118 @@
+/** @file fft.hpp
+  * @brief Header file containing a minimal FFT implementation and
+  *   FFT-based convolution routines.
+  */
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+namespace digital_filters {
+
+/// Precomputed data to evaluate Fast Fourier Transforms of a given size.
+/** This is a plain iterative radix-2 implementation, which avoids depending
+  * on external libraries. Twiddle factors and the bit-reversal permutation are
+  * evaluated once in the constructor, so that transforms do not allocate.
+  * @tparam Scalar floating point type of the real and imaginary parts.
+  */
+template <class Scalar>
+class FftPlan {
+public:
+  /// Prepares transforms of the given size.
+  /** @param size number of points of the transforms. It must be a power of
+    *   two.
+    */
+  explicit FftPlan(
+    std::size_t size
+  );
+
+  /// Number of points of the transforms.
+  inline std::size_t size() const { return size_; }
+
+  /// In-place forward transform.
+  /** @param data pointer to size() complex values.
+    */
+  void forward(
+    std::complex<Scalar>* data
+  ) const;
+
+  /// In-place inverse transform.
+  /** The result is scaled by `1/size()`, so that inverse(forward(x)) = x.
+    * @param data pointer to size() complex values.
+    */
+  void inverse(
+    std::complex<Scalar>* data
+  ) const;
+
+private:
+  /// Butterflies shared by forward and inverse transforms.
+  void transform(
+    std::complex<Scalar>* data,
+    bool inverse
+  ) const;
+
+  std::size_t size_; ///< Number of points of the transforms.
+  std::vector<std::size_t> reversed_; ///< Bit-reversal permutation.
+  std::vector<std::complex<Scalar>> twiddles_; ///< Roots of unity.
+};
+
+
+/// Product of two complex numbers.
+/** Unlike `operator*` of `std::complex`, it does not check for infinities and
+  * NaNs, which makes it significantly faster when the compiler is not allowed
+  * to skip the checks (*i.e.*, without `-ffast-math`).
+  */
+template <class Scalar>
+inline std::complex<Scalar> complexProduct(
+  const std::complex<Scalar>& a,
+  const std::complex<Scalar>& b
+);
+
+
+/// Smallest power of two that is not less than `n`.
+inline std::size_t nextPowerOfTwo(
+  std::size_t n
+);
+
+
+/// Linear convolution of two real sequences, evaluated via FFT.
+/** @tparam Scalar floating point type of the sequences.
+  * @param p1 first sequence.
+  * @param p2 second sequence.
+  * @return the full convolution, of size `p1.size()+p2.size()-1`. Its
+  *   entries are the same as the coefficients returned by polyProd(), up to
+  *   rounding errors.
+  */
+template <class Scalar>
+std::vector<Scalar> fftConvolve(
+  const std::vector<Scalar>& p1,
+  const std::vector<Scalar>& p2
+);
+
+
+/// Filters a sequence with a FIR filter using the overlap-save method.
+/** Evaluates \f$ y_k = \sum_{i} h_i x_{k-i} \f$ for \f$ k = 0, \cdots, n-1 \f$
+  * using transforms whose size is proportional to the number of taps, so that
+  * the cost per sample is logarithmic in the number of taps rather than
+  * linear. Two blocks are processed with each complex transform, one in the
+  * real part and one in the imaginary part.
+  * @param h taps of the filter.
+  * @param history past inputs \f$ \cdots, x_{-2}, x_{-1} \f$, in
+  *   time-ascending order. There must be `h.size()-1` of them.
+  * @param x pointer to `n` input samples.
+  * @param y pointer to `n` output samples. It must not overlap with `x`.
+  * @param n number of samples.
+  */
+template <class DataType, class CoeffType>
+void overlapSave(
+  const std::vector<CoeffType>& h,
+  const DataType* history,
+  const DataType* x,
+  DataType* y,
+  std::size_t n
+);
+
+} // namespace digital_filters
+
+#include <digital_filters/fft.hxx>
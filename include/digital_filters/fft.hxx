@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+
+
+namespace digital_filters {
+
+template<class Scalar>
+FftPlan<Scalar>::FftPlan(
+  std::size_t size
+)
+: size_(size)
+{
+  // check the size
+  if(size == 0 || (size & (size-1)) != 0) {
+    throw std::runtime_error(
+      "FftPlan: the size of the transform must be a power of two, but " +
+      std::to_string(size) + " was given"
+    );
+  }
+
+  // bit-reversal permutation
+  std::size_t bits = 0;
+  while((std::size_t(1) << bits) < size)
+    bits++;
+  reversed_.resize(size);
+  for(std::size_t i=0; i<size; i++) {
+    std::size_t r = 0;
+    for(std::size_t b=0; b<bits; b++)
+      if(i & (std::size_t(1) << b))
+        r |= std::size_t(1) << (bits-1-b);
+    reversed_[i] = r;
+  }
+
+  // roots of unity used by the forward transform
+  twiddles_.resize(size/2);
+  for(std::size_t k=0; k<size/2; k++)
+    twiddles_[k] = std::polar(Scalar(1), static_cast<Scalar>(-2*M_PI*k/size));
+}
+
+
+template<class Scalar>
+void FftPlan<Scalar>::forward(
+  std::complex<Scalar>* data
+) const
+{
+  transform(data, false);
+}
+
+
+template<class Scalar>
+void FftPlan<Scalar>::inverse(
+  std::complex<Scalar>* data
+) const
+{
+  transform(data, true);
+  const Scalar scale = Scalar(1) / static_cast<Scalar>(size_);
+  for(std::size_t i=0; i<size_; i++)
+    data[i] = data[i] * scale;
+}
+
+
+template<class Scalar>
+void FftPlan<Scalar>::transform(
+  std::complex<Scalar>* data,
+  bool inverse
+) const
+{
+  // reorder the input
+  for(std::size_t i=0; i<size_; i++) {
+    const std::size_t j = reversed_[i];
+    if(i < j)
+      std::swap(data[i], data[j]);
+  }
+
+  // butterflies
+  for(std::size_t len=2; len<=size_; len<<=1) {
+    const std::size_t half = len/2;
+    const std::size_t step = size_/len;
+    for(std::size_t i=0; i<size_; i+=len) {
+      for(std::size_t k=0; k<half; k++) {
+        const std::complex<Scalar> w = inverse ? std::conj(twiddles_[k*step]) : twiddles_[k*step];
+        const std::complex<Scalar> u = data[i+k];
+        const std::complex<Scalar> v = complexProduct(data[i+k+half], w);
+        data[i+k] = u + v;
+        data[i+k+half] = u - v;
+      }
+    }
+  }
+}
+
+
+template <class Scalar>
+inline std::complex<Scalar> complexProduct(
+  const std::complex<Scalar>& a,
+  const std::complex<Scalar>& b
+)
+{
+  return std::complex<Scalar>(
+    a.real()*b.real() - a.imag()*b.imag(),
+    a.real()*b.imag() + a.imag()*b.real()
+  );
+}
+
+
+inline std::size_t nextPowerOfTwo(
+  std::size_t n
+)
+{
+  std::size_t p = 1;
+  while(p < n)
+    p <<= 1;
+  return p;
+}
+
+
+template <class Scalar>
+std::vector<Scalar> fftConvolve(
+  const std::vector<Scalar>& p1,
+  const std::vector<Scalar>& p2
+)
+{
+  if(p1.size() == 0 || p2.size() == 0)
+    return std::vector<Scalar>();
+  const std::size_t size = p1.size() + p2.size() - 1;
+  const std::size_t N = nextPowerOfTwo(size);
+  FftPlan<Scalar> plan(N);
+
+  // transform both sequences at once, storing them in the real and in the
+  // imaginary parts of a single complex sequence
+  std::vector<std::complex<Scalar>> z(N);
+  for(std::size_t i=0; i<p1.size(); i++)
+    z[i].real(p1[i]);
+  for(std::size_t i=0; i<p2.size(); i++)
+    z[i].imag(p2[i]);
+  plan.forward(z.data());
+
+  // separate the two spectra, using the symmetry of real sequences, and
+  // multiply them
+  std::vector<std::complex<Scalar>> prod(N);
+  for(std::size_t k=0; k<N; k++) {
+    const std::complex<Scalar> zk = z[k];
+    const std::complex<Scalar> zc = std::conj(z[(N-k) % N]);
+    prod[k] = complexProduct(zk + zc, zk - zc) * Scalar(0.25);
+    prod[k] = std::complex<Scalar>(prod[k].imag(), -prod[k].real());
+  }
+
+  // back to the time domain
+  plan.inverse(prod.data());
+  std::vector<Scalar> p(size);
+  for(std::size_t i=0; i<size; i++)
+    p[i] = prod[i].real();
+  return p;
+}
+
+
+template <class DataType, class CoeffType>
+void overlapSave(
+  const std::vector<CoeffType>& h,
+  const DataType* history,
+  const DataType* x,
+  DataType* y,
+  std::size_t n
+)
+{
+  typedef typename std::common_type<DataType,CoeffType>::type Scalar;
+  const std::size_t m = h.size();
+  if(m == 0)
+    throw std::runtime_error("overlapSave: the filter has no taps");
+
+  // Each transform produces L new samples and reuses m-1 old ones
+  const std::size_t N = nextPowerOfTwo(4*m);
+  const std::size_t L = N - (m-1);
+  FftPlan<Scalar> plan(N);
+
+  // spectrum of the filter
+  std::vector<std::complex<Scalar>> H(N);
+  for(std::size_t i=0; i<m; i++)
+    H[i] = static_cast<Scalar>(h[i]);
+  plan.forward(H.data());
+
+  // input samples, including the history and the zero-padding at the end
+  auto sample = [&](std::ptrdiff_t k) -> Scalar {
+    if(k < 0)
+      return static_cast<Scalar>(history[static_cast<std::ptrdiff_t>(m-1) + k]);
+    if(k < static_cast<std::ptrdiff_t>(n))
+      return static_cast<Scalar>(x[k]);
+    return Scalar(0);
+  };
+
+  // process two blocks per transform, one in the real and one in the
+  // imaginary part: since h is real, the two results do not mix
+  std::vector<std::complex<Scalar>> buffer(N);
+  for(std::size_t k0=0; k0<n; k0+=2*L) {
+    const std::ptrdiff_t startA = static_cast<std::ptrdiff_t>(k0) - static_cast<std::ptrdiff_t>(m-1);
+    const std::ptrdiff_t startB = startA + static_cast<std::ptrdiff_t>(L);
+    for(std::size_t j=0; j<N; j++)
+      buffer[j] = std::complex<Scalar>(sample(startA+j), sample(startB+j));
+    plan.forward(buffer.data());
+    for(std::size_t j=0; j<N; j++)
+      buffer[j] = complexProduct(buffer[j], H[j]);
+    plan.inverse(buffer.data());
+    // the first m-1 outputs are corrupted by the circular convolution
+    for(std::size_t j=0; j<L && k0+j<n; j++)
+      y[k0+j] = static_cast<DataType>(buffer[m-1+j].real());
+    for(std::size_t j=0; j<L && k0+L+j<n; j++)
+      y[k0+L+j] = static_cast<DataType>(buffer[m-1+j].imag());
+  }
+}
+
+} // namespace digital_filters
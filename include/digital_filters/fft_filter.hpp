@@ -0,0 +1,129 @@
+/** @file fft_filter.hpp
+  * @brief Header file containing the FftFilter class.
+  */
+#pragma once
+
+#include <digital_filters/filter.hpp>
+#include <digital_filters/fft.hpp>
+#include <vector>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+
+namespace digital_filters {
+
+/// FIR filter evaluated via partitioned FFT convolution.
+/** Long FIR filters (*e.g.*, averages over large windows) are expensive to
+  * evaluate directly, since each sample requires as many products as there
+  * are taps. This class splits the taps into partitions of \f$ B \f$ elements:
+  * - the first partition is evaluated directly, so that no latency is
+  *   introduced with respect to Filter;
+  * - all other partitions are evaluated once every \f$ B \f$ samples using
+  *   a uniformly-partitioned overlap-save scheme, *i.e.*, by multiplying the
+  *   spectra of the last input blocks with the spectra of the partitions.
+  *
+  * The output is the same as the one of a Filter with the same numerator
+  * and unit denominator, up to rounding errors. No memory is allocated while
+  * filtering.
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the coefficients of the transfer function.
+  */
+template <class DataType, class CoeffType>
+class FftFilter {
+  static_assert(std::is_floating_point<DataType>::value, "FftFilter: DataType must be a floating point type");
+  static_assert(std::is_floating_point<CoeffType>::value, "FftFilter: CoeffType must be a floating point type");
+public:
+  /// Type used for the evaluation of the transforms.
+  typedef typename std::common_type<DataType,CoeffType>::type Scalar;
+
+  /// Generates a filter from given taps.
+  /** @param b_num Numerator of the discrete transfer function, *i.e.*, taps
+    *   of the filter.
+    * @param partition size \f$ B \f$ of the partitions. It must be a power of
+    *   two. If zero, a size close to twice the square root of the number of
+    *   taps is used, which balances the cost of the direct and FFT parts.
+    */
+  explicit FftFilter(
+    const std::vector<CoeffType>& b_num,
+    std::size_t partition = 0
+  );
+
+  /// Generates a filter with the same coefficients of a FIR Filter.
+  /** @param filter filter to be converted; its denominator must have size
+    *   one. The internal state is not copied.
+    * @param partition size \f$ B \f$ of the partitions.
+    */
+  explicit FftFilter(
+    const Filter<DataType,CoeffType>& filter,
+    std::size_t partition = 0
+  );
+
+  /// Access the numerator.
+  inline const std::vector<CoeffType>& numerator() const { return b_; }
+
+  /// Size of the partitions.
+  inline std::size_t partition() const { return B_; }
+
+  /// Set all past inputs to zero.
+  void reset();
+
+  /// Set initial conditions on the input.
+  /** @param input value to be used to initialize all past input samples.
+    * @see Filter::initInput(const DataType&)
+    */
+  void initInput(
+    const DataType& input
+  );
+
+  /// Set initial conditions on the input.
+  /** @param input values \f$ \cdots, x_{k-2}, x_{k-1} \f$, sorted in
+    *   time-ascending order. There must be as many values as taps, minus one.
+    * @see Filter::initInput(const std::vector<DataType>&)
+    */
+  void initInput(
+    const std::vector<DataType>& input
+  );
+
+  /// Filter the current input.
+  const DataType& filter(
+    const DataType& x
+  );
+
+  /// Filter a block of samples.
+  /** @param x_in pointer to `n` input samples.
+    * @param y_out pointer to `n` output samples. It can be equal to `x_in`.
+    * @param n number of samples in the block.
+    * @see Filter::filter(const DataType*, DataType*, std::size_t)
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  );
+
+private:
+  /// Size of the partitions used when none is specified.
+  static std::size_t defaultPartition(
+    std::size_t taps
+  );
+
+  /// Evaluates the contribution of the tail partitions for the next block.
+  void processBlock();
+
+  std::vector<CoeffType> b_; ///< Taps of the filter.
+  std::size_t B_; ///< Size of the partitions.
+  std::size_t P_; ///< Number of partitions evaluated via FFT.
+  FftPlan<Scalar> plan_; ///< Transforms of size 2B.
+  std::vector<std::complex<Scalar>> H_; ///< Spectra of the partitions.
+  std::vector<std::complex<Scalar>> X_; ///< Spectra of the last P blocks.
+  std::size_t X_head_; ///< Position of the most recent spectrum in `X_`.
+  std::vector<std::complex<Scalar>> work_; ///< Buffer for the transforms.
+  std::vector<DataType> blocks_; ///< Previous and current input blocks.
+  std::vector<Scalar> tail_; ///< Output of the tail for the current block.
+  std::size_t pos_; ///< Number of samples in the current block.
+  DataType y_; ///< Last output.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/fft_filter.hxx>
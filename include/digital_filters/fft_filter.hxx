@@ -0,0 +1,183 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+
+namespace digital_filters {
+
+template<class DataType, class CoeffType>
+FftFilter<DataType,CoeffType>::FftFilter(
+  const std::vector<CoeffType>& b_num,
+  std::size_t partition
+)
+: b_(b_num)
+, B_(partition == 0 ? defaultPartition(b_num.size()) : partition)
+, P_(b_num.size() > B_ ? (b_num.size() - 1) / B_ : 0)
+, plan_(2*B_)
+, H_(2*B_*P_)
+, X_(2*B_*P_)
+, X_head_(0)
+, work_(2*B_)
+, blocks_(2*B_)
+, tail_(B_)
+, pos_(0)
+, y_()
+{
+  // check sizes
+  if(b_num.size() == 0)
+    throw std::runtime_error("FftFilter: numerator (b) is empty");
+
+  // spectra of the partitions, skipping the first one
+  for(std::size_t p=0; p<P_; p++) {
+    std::fill(work_.begin(), work_.end(), std::complex<Scalar>());
+    for(std::size_t j=0; j<B_ && (p+1)*B_+j<b_.size(); j++)
+      work_[j] = static_cast<Scalar>(b_[(p+1)*B_+j]);
+    plan_.forward(work_.data());
+    std::copy(work_.begin(), work_.end(), H_.begin() + p*2*B_);
+  }
+}
+
+
+template<class DataType, class CoeffType>
+FftFilter<DataType,CoeffType>::FftFilter(
+  const Filter<DataType,CoeffType>& filter,
+  std::size_t partition
+)
+: FftFilter(filter.numerator(), partition)
+{
+  if(filter.denominator().size() != 1) {
+    throw std::runtime_error(
+      "FftFilter: the denominator must have size one, but it has " +
+      std::to_string(filter.denominator().size()) + " elements"
+    );
+  }
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t FftFilter<DataType,CoeffType>::defaultPartition(
+  std::size_t taps
+)
+{
+  return std::max<std::size_t>(16, nextPowerOfTwo(static_cast<std::size_t>(std::ceil(2*std::sqrt(taps)))));
+}
+
+
+template<class DataType, class CoeffType>
+void FftFilter<DataType,CoeffType>::reset()
+{
+  std::fill(X_.begin(), X_.end(), std::complex<Scalar>());
+  std::fill(blocks_.begin(), blocks_.end(), DataType());
+  std::fill(tail_.begin(), tail_.end(), Scalar());
+  X_head_ = 0;
+  pos_ = 0;
+}
+
+
+template<class DataType, class CoeffType>
+void FftFilter<DataType,CoeffType>::initInput(
+  const DataType& input
+)
+{
+  // the easiest way to fill all buffers is to actually filter the samples
+  reset();
+  for(std::size_t i=1; i<b_.size(); i++)
+    filter(input);
+}
+
+
+template<class DataType, class CoeffType>
+void FftFilter<DataType,CoeffType>::initInput(
+  const std::vector<DataType>& input
+)
+{
+  // check sizes
+  if(input.size() != b_.size()-1) {
+    throw std::runtime_error(
+      "FftFilter::initInput: 'input' has " + std::to_string(input.size()) +
+      " elements, but only " + std::to_string(b_.size()-1) +
+      " elements are allowed"
+    );
+  }
+  // the easiest way to fill all buffers is to actually filter the samples
+  reset();
+  for(const auto& x : input)
+    filter(x);
+}
+
+
+template<class DataType, class CoeffType>
+const DataType& FftFilter<DataType,CoeffType>::filter(
+  const DataType& x
+)
+{
+  // store the sample in the current block
+  blocks_[B_+pos_] = x;
+
+  // the first partition is evaluated directly; past samples are contiguous
+  // since the previous block precedes the current one
+  const DataType* xk = &blocks_[B_+pos_];
+  const std::size_t head = std::min(B_, b_.size());
+  Scalar y = tail_[pos_];
+  for(std::size_t i=0; i<head; i++)
+    y = y + b_[i] * xk[-static_cast<std::ptrdiff_t>(i)];
+  y_ = static_cast<DataType>(y);
+
+  // once the block is complete, prepare the tail for the next one
+  if(++pos_ == B_) {
+    processBlock();
+    pos_ = 0;
+  }
+  return y_;
+}
+
+
+template<class DataType, class CoeffType>
+void FftFilter<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+)
+{
+  for(std::size_t k=0; k<n; k++)
+    y_out[k] = filter(x_in[k]);
+}
+
+
+template<class DataType, class CoeffType>
+void FftFilter<DataType,CoeffType>::processBlock()
+{
+  const std::size_t N = 2*B_;
+  if(P_ > 0) {
+    // spectrum of the previous and current blocks (overlap-save segment)
+    for(std::size_t j=0; j<N; j++)
+      work_[j] = static_cast<Scalar>(blocks_[j]);
+    plan_.forward(work_.data());
+
+    // store it in the frequency-domain delay line, most recent first
+    X_head_ = (X_head_ == 0 ? P_ : X_head_) - 1;
+    std::copy(work_.begin(), work_.end(), X_.begin() + X_head_*N);
+
+    // the p-th partition multiplies the spectrum of p blocks ago
+    std::fill(work_.begin(), work_.end(), std::complex<Scalar>());
+    for(std::size_t p=0; p<P_; p++) {
+      const std::complex<Scalar>* Hp = &H_[p*N];
+      const std::complex<Scalar>* Xp = &X_[((X_head_+p) % P_)*N];
+      for(std::size_t j=0; j<N; j++)
+        work_[j] += complexProduct(Hp[j], Xp[j]);
+    }
+
+    // back to the time domain: the second half contains valid samples
+    plan_.inverse(work_.data());
+    for(std::size_t j=0; j<B_; j++)
+      tail_[j] = work_[B_+j].real();
+  }
+
+  // the current block becomes the previous one
+  std::copy(blocks_.begin() + B_, blocks_.end(), blocks_.begin());
+}
+
+} // namespace digital_filters
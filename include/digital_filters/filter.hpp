@@ -3,21 +3,52 @@
   */
 #pragma once
 
+#include <digital_filters/checkpoint.hpp>
+#include <digital_filters/denormals.hpp>
+#include <digital_filters/instrumentation.hpp>
 #include <vector>
-#include <deque>
+#include <cstddef>
+#include <memory>
+#include <utility>
 
 namespace digital_filters {
 
+/// Structures that can be used to realize the difference equation of a filter.
+/** All realizations produce the same output (up to rounding errors), but they
+  * differ in the way the internal state is stored and updated. None of them
+  * allocates memory while filtering.
+  */
+enum class Realization {
+  /// Direct Form I.
+  /** Past inputs and outputs are stored in two contiguous ring buffers. Each
+    * buffer is mirrored, *i.e.*, every sample is written twice, so that the
+    * history is always available as a contiguous slice of memory.
+    */
+  DirectFormI,
+  /// Direct Form II Transposed.
+  /** The filter keeps a single state vector of size \f$ \max(n_b,n_a)-1 \f$,
+    * with \f$ n_b \f$ and \f$ n_a \f$ being the sizes of the numerator and
+    * of the denominator.
+    */
+  DirectFormIITransposed
+};
+
+
 /// Simple class that represents a digital filter.
-/**
+/** The difference equation is evaluated using the type of the products
+  * between coefficients and samples, see Accumulator. As an example, a
+  * `Filter<float,double>` exchanges single precision samples but accumulates
+  * (and stores its transposed state) in double precision, which reduces the
+  * rounding noise of high order or narrow-band filters.
   * @tparam DataType Type of the input/output signals
   * @tparam CoeffType Type of the coefficients of the transfer function.
-  *
-  * @todo Add a method to find initial conditions.
   */
 template <class DataType, class CoeffType>
 class Filter {
 public:
+  /// Type used to accumulate the products between coefficients and samples.
+  typedef decltype(std::declval<CoeffType>() * std::declval<DataType>()) Accumulator;
+
   /// Generates a filter from given coefficients.
   /** Creates a filter whose transfer function in the discrete domain is given
     * as:
@@ -39,10 +70,12 @@ public:
     * @param a_den Denominator of the discrete transfer function. Entries should
     *   be ordered such that `a_den[i]` contains \f$ a_i \f$. Note that the
     *   first element must not be zero.
+    * @param realization structure used to evaluate the difference equation.
     */
   Filter(
     const std::vector<CoeffType>& b_num,
-    const std::vector<CoeffType>& a_den
+    const std::vector<CoeffType>& a_den,
+    Realization realization = Realization::DirectFormI
   );
 
   /// Filters concatenation.
@@ -54,6 +87,7 @@ public:
     * concatenation is a commutative operation).
     * @param other filter that should be concatenated to `this`.
     * @return a new filter which is the concatenation of `this` and `other`.
+    *   It uses the same realization as `this`.
     */
   Filter<DataType,CoeffType> operator*(
     const Filter<DataType,CoeffType>& other
@@ -63,7 +97,8 @@ public:
   /** @tparam OtherDataType new type of the input/output signals.
     * @tparam OtherCoeffType new type of the coefficients.
     * @return A new filter which is a copy of the current one, but with
-    *   different template types.
+    *   different template types. The realization and the internal state are
+    *   preserved as well.
     * @note To perform the conversion, `static_cast` is used. Make sure that
     *   this is not an issue for your datatypes.
     */
@@ -76,6 +111,76 @@ public:
   /// Access the denominator.
   inline const std::vector<CoeffType>& denominator() const { return a_; }
 
+  /// Structure used to evaluate the difference equation.
+  inline Realization realization() const { return realization_; }
+
+  /// Minimum number of taps for FFT-based filtering of sequences.
+  /** @see setFftThreshold()
+    */
+  inline std::size_t fftThreshold() const { return fft_threshold_; }
+
+  /// Set the minimum number of taps for FFT-based filtering of sequences.
+  /** When the denominator has size one, *i.e.*, the filter is FIR, and the
+    * numerator has at least `taps` elements, filter(const std::vector<DataType>&, const std::vector<DataType>&, const std::vector<DataType>&)
+    * evaluates the convolution via FFT (see overlapSave()) rather than
+    * directly. This is only possible if both template types are floating
+    * point types. For streaming applications, use FftFilter.
+    * @param taps new threshold. A value of zero disables FFT-based
+    *   filtering.
+    */
+  inline void setFftThreshold(std::size_t taps) { fft_threshold_ = taps; }
+
+  /// Strategy used to keep the state out of the denormal range.
+  inline DenormalPolicy denormalPolicy() const { return denormal_policy_; }
+
+  /// Set the strategy used to keep the state out of the denormal range.
+  /** The policy is applied by filter(const DataType&), by the block
+    * filtering methods and by filter2(). The remaining methods only apply
+    * DenormalPolicy::FlushToZero and DenormalPolicy::Offset. Policies have
+    * no effect unless the types of the filter are floating point.
+    * @param policy the new policy.
+    */
+  void setDenormalPolicy(
+    DenormalPolicy policy
+  );
+
+  /// Probe that collects runtime statistics, if any.
+  inline const std::shared_ptr<Probe>& probe() const { return probe_; }
+
+  /// Attach a probe that collects runtime statistics.
+  /** The probe is shared with all copies of the filter, but not with
+    * filters obtained via as() or operator*(). Statistics are only collected
+    * if instrumentation is enabled, see instrumentation.hpp.
+    * @param probe the new probe. If null, statistics are not collected.
+    * @see ProbeRegistry::probe(), to obtain named probes.
+    */
+  inline void setProbe(const std::shared_ptr<Probe>& probe) { probe_ = probe; }
+
+  /// Replace the coefficients of the transfer function, keeping the state.
+  /** This allows to retune a filter while it is running, *e.g.*, to move its
+    * cutoff frequency. The new coefficients are normalized as in Filter(),
+    * and they are copied into the existing buffers: no memory is allocated.
+    *
+    * With Realization::DirectFormI, the state consists of past inputs and
+    * outputs: they are preserved, and the new difference equation simply
+    * continues from them. This is the preferred realization for filters
+    * whose coefficients change often. With
+    * Realization::DirectFormIITransposed, the state depends on the
+    * coefficients: it is shifted by the difference between the new and the
+    * old steady-state for the last input (see initSteadyState()). Filters at
+    * rest thus switch without transients, while other signals keep their
+    * deviation from the rest condition.
+    * @param b_num new numerator. It must have the same size as numerator().
+    * @param a_den new denominator. It must have the same size as
+    *   denominator(), and its first element must not be zero.
+    * @note An exception is thrown if the sizes do not match.
+    * @see DesignCache, to obtain coefficients without redesigning filters.
+    */
+  void setCoefficients(
+    const std::vector<CoeffType>& b_num,
+    const std::vector<CoeffType>& a_den
+  );
+
   /// Set initial conditions on the input.
   /** To evaluate the output of the filter at the discrete time-step \f$ k \f$,
     * it is necessary to use the past values of the input,
@@ -98,7 +203,7 @@ public:
     *   sorted in time-ascending order. In other words, the sequence starts
     *   with the oldest value and ends with the most recent sample. Note
     *   that the number of required values equals the dimension of the
-    *   denominator minus one.
+    *   numerator minus one.
     */
   void initInput(
     const std::vector<DataType>& input
@@ -131,11 +236,72 @@ public:
     const std::vector<DataType>& output
   );
 
+  /// Set the state to the steady-state response to a constant input.
+  /** All past inputs are set to `input`, and all past outputs to the
+    * corresponding steady-state output. Filtering again `input` then produces
+    * no transient.
+    * @param input constant input.
+    * @note If the filter has a pole in \f$ z=1 \f$, the steady-state output
+    *   is not defined and an exception is thrown.
+    */
+  void initSteadyState(
+    const DataType& input
+  );
+
+  /// Save the coefficients and the exact state of the filter.
+  /** The denormal policy and the FFT threshold are saved as well, but not
+    * the probe. See checkpoint.hpp for a description of the format.
+    * @param[out] buffer destination of the checkpoint. The record is appended
+    *   to its previous content.
+    */
+  void checkpoint(
+    std::vector<unsigned char>& buffer
+  ) const;
+
+  /// Restore the coefficients and the state saved by checkpoint().
+  /** If the checkpoint has the same number of coefficients and the same
+    * realization as `this`, values are copied into the existing buffers and
+    * no memory is allocated. Otherwise, the filter is rebuilt first. The
+    * probe of the filter is kept.
+    * @param data pointer to the record, aligned to checkpointAlignment().
+    * @param size number of bytes available from `data`.
+    * @return size of the record, *i.e.*, offset of the next record.
+    * @note An exception is thrown if the record is invalid, or if it was
+    *   written by a filter with different template types. In this case, the
+    *   filter is not modified.
+    */
+  std::size_t restore(
+    const void* data,
+    std::size_t size
+  );
+
   /// Filter the current input.
+  /** @note When using Realization::DirectFormIITransposed, past samples are
+    *   not tracked while filtering: the state is updated directly. For this
+    *   reason, initInput() and initOutput() rebuild the state from the last
+    *   input and output histories that were explicitly set (zero by default).
+    */
   const DataType& filter(
     const DataType& x
   );
 
+  /// Filter a block of samples.
+  /** The internal state is used as initial condition and it is updated at
+    * the end of the block, so that consecutive calls behave as if all samples
+    * were passed one at a time to filter(const DataType&). No memory is
+    * allocated.
+    * @param x_in pointer to `n` input samples, sorted in time-ascending order.
+    * @param y_out pointer to `n` output samples. It can be equal to `x_in`,
+    *   in which case the block is filtered in-place; other kinds of overlap
+    *   between the two buffers are not allowed.
+    * @param n number of samples in the block.
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  );
+
   /// Filter a whole sequence.
   /** Internal buffers will not be updated, meaning that the initial conditions
     * of the filter will not change after calling this method.
@@ -151,9 +317,9 @@ public:
     * @return sequence of filtered outputs \f$ y_0, y_1, y_2, \cdots \f$
     */
   std::vector<DataType> filter(
+    const std::vector<DataType>& x,
     const std::vector<DataType>& x0,
-    const std::vector<DataType>& y0,
-    const std::vector<DataType>& x
+    const std::vector<DataType>& y0
   ) const;
 
   /// Bi-directional filtering of a whole sequence.
@@ -162,19 +328,142 @@ public:
     * @param x input signal to be filtered. It should be sorted in
     *   time-ascending order, *i.e.*, so that `x[k]` corresponds to the
     *   discrete-time sample \f$ x_k \f$.
+    * @param padding number of samples used to extend the signal on both
+    *   sides, see filter2(const DataType*, DataType*, std::size_t, std::size_t).
     * @return sequence of filtered outputs \f$ y_0, y_1, y_2, \cdots \f$
-    * @note for the moment, the initial conditions are obtained by holding
-    *   the signal on the left and on the right.
     */
   std::vector<DataType> filter2(
-    const std::vector<DataType>& x
+    const std::vector<DataType>& x,
+    std::size_t padding = 0
   ) const;
 
+  /// Bi-directional filtering of a whole sequence, without allocations.
+  /** Filter a given signal from both sides by applying the filter once and
+    * then a second time, iterating backward over the result. Each pass
+    * starts from the steady-state response to the first sample it
+    * processes, which removes most of the transients at the boundaries
+    * (this is the same approach of SciPy's `filtfilt`). The steady state for
+    * a unit input is computed once, when the filter is created.
+    *
+    * Optionally, the signal can be extended with an odd reflection around
+    * its end points before filtering, *i.e.*, with
+    * \f$ 2 x_0 - x_p, \cdots, 2 x_0 - x_1 \f$ on the left and with
+    * \f$ 2 x_{n-1} - x_{n-2}, \cdots, 2 x_{n-1} - x_{n-1-p} \f$ on the
+    * right, so that the transients decay before reaching the signal.
+    *
+    * The passes use a Direct Form II Transposed structure, independently of
+    * realization(), and they do not affect the state used by filter(). The
+    * buffers used by the passes are members of the filter: memory is only
+    * allocated the first time a larger padding is requested.
+    * @param x_in pointer to `n` input samples, sorted in time-ascending order.
+    * @param y_out pointer to `n` output samples. It can be equal to `x_in`.
+    * @param n number of samples.
+    * @param padding number of samples \f$ p \f$ used to extend the signal on
+    *   both sides. It must be smaller than `n`.
+    * @note If the filter has a pole in \f$ z=1 \f$, the steady state is not
+    *   defined and both passes start from a zero state.
+    */
+  void filter2(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n,
+    std::size_t padding = 0
+  );
+
 private:
+  /// Number of samples between two flushes of the state, see
+  /// DenormalPolicy::FlushState.
+  static constexpr std::size_t flush_interval_ = 1024;
+
+  // Allow conversions between filters with different template types.
+  template <class OtherDataType, class OtherCoeffType>
+  friend class Filter;
+
+  /// Recomputes the transposed state from the input/output histories.
+  void rebuildState();
+
+  /// Recomputes `zi_` from the current coefficients, without allocating.
+  void updateSteadyState();
+
+  /// Filter the current input using the Direct Form I.
+  inline const DataType& stepDirectFormI(
+    const DataType& x
+  );
+
+  /// Filter the current input using the Direct Form II Transposed.
+  inline const DataType& stepTransposed(
+    const DataType& x
+  );
+
+  /// Filter a block of samples, ignoring the denormal policy.
+  void filterBlock(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  );
+
+  /// Set to zero all state variables below denormalThreshold().
+  void flushState();
+
+  /// Advances a Direct Form II Transposed state by one sample.
+  /** @param state pointer to `max(b_.size(),a_.size())-1` state variables.
+    * @param x current input.
+    * @return current output.
+    */
+  inline DataType advanceTransposed(
+    Accumulator* state,
+    const DataType& x
+  ) const;
+
+  /// Implementation of bi-directional filtering using the given buffers.
+  /** @param state pointer to `max(b_.size(),a_.size())-1` state variables.
+    * @param pad pointer to `padding` samples.
+    * @see filter2(const DataType*, DataType*, std::size_t, std::size_t)
+    */
+  void filter2(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n,
+    std::size_t padding,
+    Accumulator* state,
+    DataType* pad
+  ) const;
+
   std::vector<CoeffType> b_; ///< Numerator of the transfer function.
   std::vector<CoeffType> a_; ///< Denominator of the transfer function.
-  std::deque<DataType> in_; ///< Input samples.
-  std::deque<DataType> out_; ///< Output samples.
+  Realization realization_; ///< Structure of the difference equation.
+  /// Input samples.
+  /** With Realization::DirectFormI this is a mirrored ring buffer of size
+    * `2*b_.size()`. With Realization::DirectFormIITransposed it contains the
+    * `b_.size()-1` past inputs set via initInput(), most recent first.
+    */
+  std::vector<DataType> in_;
+  /// Output samples.
+  /** With Realization::DirectFormI this is a mirrored ring buffer of size
+    * `2*a_.size()`. With Realization::DirectFormIITransposed it contains the
+    * `a_.size()-1` past outputs set via initOutput(), most recent first.
+    */
+  std::vector<DataType> out_;
+  unsigned int in_head_; ///< Position of the most recent input in `in_`.
+  unsigned int out_head_; ///< Position of the most recent output in `out_`.
+  std::vector<Accumulator> state_; ///< State of the transposed realization.
+  DataType x_; ///< Last input of the transposed realization.
+  DataType y_; ///< Last output of the transposed realization.
+  std::size_t fft_threshold_; ///< Minimum number of taps to use the FFT.
+  /// Transposed state in steady-state for a unit input.
+  /** It is empty if the filter has a pole in \f$ z=1 \f$. Its capacity is
+    * reserved in the constructor, so that setCoefficients() never allocates.
+    * @see steadyState()
+    */
+  std::vector<CoeffType> zi_;
+  std::vector<Accumulator> scratch_state_; ///< State used by filter2().
+  std::vector<DataType> scratch_pad_; ///< Padding used by filter2().
+  std::shared_ptr<Probe> probe_; ///< Destination of runtime statistics.
+  DenormalPolicy denormal_policy_; ///< Protection against denormals.
+  /// Constant added to each output, see DenormalPolicy::Offset.
+  Accumulator bias_;
+  /// Samples filtered since the last flush, see DenormalPolicy::FlushState.
+  std::size_t unflushed_;
 };
 
 } // namespace digital_filters
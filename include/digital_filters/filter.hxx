@@ -2,7 +2,9 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <type_traits>
 #include <digital_filters/utilities.hpp>
+#include <digital_filters/fft.hpp>
 
 
 namespace digital_filters {
@@ -10,12 +12,20 @@ namespace digital_filters {
 template<class DataType, class CoeffType>
 Filter<DataType,CoeffType>::Filter(
   const std::vector<CoeffType>& b_num,
-  const std::vector<CoeffType>& a_den
+  const std::vector<CoeffType>& a_den,
+  Realization realization
 )
 : b_(b_num)
 , a_(a_den)
-, in_(b_num.size())
-, out_(a_den.size())
+, realization_(realization)
+, in_head_(0)
+, out_head_(0)
+, x_()
+, y_()
+, fft_threshold_(64)
+, denormal_policy_(DenormalPolicy::None)
+, bias_()
+, unflushed_(0)
 {
   // check sizes
   if(b_num.size() == 0)
@@ -28,6 +38,22 @@ Filter<DataType,CoeffType>::Filter(
     bi = bi / a_den[0];
   for(auto& ai : a_)
     ai = ai / a_den[0];
+
+  // allocate all buffers once and for all
+  if(realization_ == Realization::DirectFormI) {
+    in_.resize(2*b_.size());
+    out_.resize(2*a_.size());
+  }
+  else {
+    in_.resize(b_.size()-1);
+    out_.resize(a_.size()-1);
+    state_.resize(std::max(b_.size(), a_.size())-1);
+  }
+
+  // The steady state for a unit input is used to initialize filter2()
+  zi_.reserve(std::max(b_.size(), a_.size())-1);
+  updateSteadyState();
+  scratch_state_.resize(std::max(b_.size(), a_.size())-1);
 }
 
 
@@ -36,7 +62,7 @@ Filter<DataType,CoeffType> Filter<DataType,CoeffType>::operator*(
   const Filter<DataType,CoeffType>& other
 ) const
 {
-  return Filter<DataType,CoeffType>( polyProd(b_, other.b_), polyProd(a_, other.a_) );
+  return Filter<DataType,CoeffType>( polyProd(b_, other.b_), polyProd(a_, other.a_), realization_ );
 }
 
 
@@ -48,15 +74,84 @@ Filter<OtherDataType,OtherCoeffType> Filter<DataType,CoeffType>::as() const
   std::vector<OtherCoeffType> a(a_.begin(), a_.end());
   std::vector<OtherCoeffType> b(b_.begin(), b_.end());
   // create new filter
-  auto filter = Filter<OtherDataType,OtherCoeffType>(b,a);
-  // make sure to initialize the inputs and outputs
-  filter.initInput(std::vector<OtherCoeffType>(in_.begin(), in_.end()-1));
-  filter.initOutput(std::vector<OtherCoeffType>(out_.begin(), out_.end()-1));
+  auto filter = Filter<OtherDataType,OtherCoeffType>(b, a, realization_);
+  // copy-convert the internal state as well: buffers have the same layout
+  filter.in_.assign(in_.begin(), in_.end());
+  filter.out_.assign(out_.begin(), out_.end());
+  filter.in_head_ = in_head_;
+  filter.out_head_ = out_head_;
+  filter.state_.assign(state_.begin(), state_.end());
+  filter.x_ = static_cast<OtherDataType>(x_);
+  filter.y_ = static_cast<OtherDataType>(y_);
+  filter.fft_threshold_ = fft_threshold_;
+  filter.setDenormalPolicy(denormal_policy_);
   // return the result
   return filter;
 }
 
 
+template<class DataType, class CoeffType>
+void Filter<DataType,CoeffType>::setCoefficients(
+  const std::vector<CoeffType>& b_num,
+  const std::vector<CoeffType>& a_den
+)
+{
+  // check sizes
+  if(b_num.size() != b_.size() || a_den.size() != a_.size()) {
+    throw std::runtime_error(
+      "Filter::setCoefficients: expected " + std::to_string(b_.size()) +
+      " numerator and " + std::to_string(a_.size()) + " denominator "
+      "coefficients, but " + std::to_string(b_num.size()) + " and " +
+      std::to_string(a_den.size()) + " were given"
+    );
+  }
+  if(a_den[0] == CoeffType(0))
+    throw std::runtime_error("Filter::setCoefficients: the first denominator coefficient (a0) is zero");
+
+  // The transposed state is shifted only if both the old and the new filter
+  // have a steady-state, i.e., no pole in z=1; otherwise, it is kept as is.
+  CoeffType Sa = a_den[0];
+  for(unsigned int i=1; i<a_den.size(); i++)
+    Sa = Sa + a_den[i];
+  const bool shift = realization_ == Realization::DirectFormIITransposed
+    && zi_.size() == state_.size() && Sa != CoeffType(0);
+
+  // remove the old steady-state contribution of the last input...
+  if(shift)
+    for(std::size_t i=0; i<state_.size(); i++)
+      state_[i] = state_[i] - zi_[i] * x_;
+
+  // ...update the coefficients...
+  for(std::size_t i=0; i<b_.size(); i++)
+    b_[i] = b_num[i] / a_den[0];
+  for(std::size_t i=0; i<a_.size(); i++)
+    a_[i] = a_den[i] / a_den[0];
+  updateSteadyState();
+
+  // ...and add the new one
+  if(shift)
+    for(std::size_t i=0; i<state_.size(); i++)
+      state_[i] = state_[i] + zi_[i] * x_;
+}
+
+
+template<class DataType, class CoeffType>
+void Filter<DataType,CoeffType>::updateSteadyState()
+{
+  // The steady state is not defined if the filter has a pole in z=1, i.e.,
+  // if sum(a)=0. Otherwise, the buffer is resized within its capacity.
+  CoeffType Sa = a_[0];
+  for(unsigned int i=1; i<a_.size(); i++)
+    Sa = Sa + a_[i];
+  if(Sa == CoeffType(0)) {
+    zi_.clear();
+    return;
+  }
+  zi_.resize(std::max(b_.size(), a_.size())-1);
+  steadyState(b_, a_, zi_.data());
+}
+
+
 template<class DataType, class CoeffType>
 void Filter<DataType,CoeffType>::initInput(
   const DataType& input
@@ -64,6 +159,9 @@ void Filter<DataType,CoeffType>::initInput(
 {
   for(auto& val : in_)
     val = input;
+  x_ = input;
+  if(realization_ == Realization::DirectFormIITransposed)
+    rebuildState();
 }
 
 
@@ -73,16 +171,26 @@ void Filter<DataType,CoeffType>::initInput(
 )
 {
   // check sizes
-  if(input.size() != in_.size()-1) {
+  if(input.size() != b_.size()-1) {
     throw std::runtime_error(
       "Filter::initInput: 'input' has " + std::to_string(input.size()) +
-      " elements, but only " + std::to_string(in_.size()-1) +
+      " elements, but only " + std::to_string(b_.size()-1) +
       " elements are allowed"
     );
   }
-  // copy the values
-  for(unsigned int i=0; i<input.size(); i++)
-    in_[i] = input[input.size()-i-1];
+  // copy the values, most recent first
+  if(realization_ == Realization::DirectFormI) {
+    in_head_ = 0;
+    for(unsigned int i=0; i<input.size(); i++)
+      in_[i] = in_[i+b_.size()] = input[input.size()-i-1];
+  }
+  else {
+    for(unsigned int i=0; i<input.size(); i++)
+      in_[i] = input[input.size()-i-1];
+    if(!input.empty())
+      x_ = input.back();
+    rebuildState();
+  }
 }
 
 
@@ -93,6 +201,8 @@ void Filter<DataType,CoeffType>::initOutput(
 {
   for(auto& val : out_)
     val = output;
+  if(realization_ == Realization::DirectFormIITransposed)
+    rebuildState();
 }
 
 
@@ -102,43 +212,325 @@ void Filter<DataType,CoeffType>::initOutput(
 )
 {
   // check sizes
-  if(output.size() != out_.size()-1) {
+  if(output.size() != a_.size()-1) {
     throw std::runtime_error(
-      "Filter::initInput: 'output' has " + std::to_string(output.size()) +
-      " elements, but only " + std::to_string(out_.size()-1) +
+      "Filter::initOutput: 'output' has " + std::to_string(output.size()) +
+      " elements, but only " + std::to_string(a_.size()-1) +
       " elements are allowed"
     );
   }
-  // copy the values
-  for(unsigned int i=0; i<output.size(); i++)
-    out_[i] = output[output.size()-i-1];
+  // copy the values, most recent first
+  if(realization_ == Realization::DirectFormI) {
+    out_head_ = 0;
+    for(unsigned int i=0; i<output.size(); i++)
+      out_[i] = out_[i+a_.size()] = output[output.size()-i-1];
+  }
+  else {
+    for(unsigned int i=0; i<output.size(); i++)
+      out_[i] = output[output.size()-i-1];
+    rebuildState();
+  }
 }
 
 
 template<class DataType, class CoeffType>
-const DataType& Filter<DataType,CoeffType>::filter(
+void Filter<DataType,CoeffType>::initSteadyState(
+  const DataType& input
+)
+{
+  if(zi_.size() != scratch_state_.size()) {
+    throw std::runtime_error(
+      "Filter::initSteadyState: the filter has a pole in z=1, hence the "
+      "steady-state output is not defined"
+    );
+  }
+  // the output is y = b0*x + s0, with s0 being the first state variable
+  const DataType output = static_cast<DataType>(zi_.empty() ? b_[0] * input : (b_[0] + zi_[0]) * input);
+  initInput(input);
+  initOutput(output);
+}
+
+
+template<class DataType, class CoeffType>
+void Filter<DataType,CoeffType>::checkpoint(
+  std::vector<unsigned char>& buffer
+) const
+{
+  CheckpointWriter writer(buffer, checkpointHeader<DataType,CoeffType,Accumulator>(CheckpointKind::Filter));
+  const std::uint64_t fields[6] = {
+    static_cast<std::uint64_t>(realization_), in_head_, out_head_,
+    fft_threshold_, static_cast<std::uint64_t>(denormal_policy_), unflushed_
+  };
+  writer.write(fields, 6);
+  writer.write(b_.data(), b_.size());
+  writer.write(a_.data(), a_.size());
+  writer.write(in_.data(), in_.size());
+  writer.write(out_.data(), out_.size());
+  writer.write(state_.data(), state_.size());
+  const DataType xy[2] = {x_, y_};
+  writer.write(xy, 2);
+  writer.close();
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t Filter<DataType,CoeffType>::restore(
+  const void* data,
+  std::size_t size
+)
+{
+  CheckpointReader reader(data, size, checkpointHeader<DataType,CoeffType,Accumulator>(CheckpointKind::Filter));
+  const std::uint64_t* fields = reader.readExactly<std::uint64_t>(6);
+  std::size_t nb, na, ni, no, ns;
+  const CoeffType* b = reader.read<CoeffType>(nb);
+  const CoeffType* a = reader.read<CoeffType>(na);
+  const DataType* in = reader.read<DataType>(ni);
+  const DataType* out = reader.read<DataType>(no);
+  const Accumulator* state = reader.read<Accumulator>(ns);
+  const DataType* xy = reader.readExactly<DataType>(2);
+
+  // validate the whole record before modifying the filter
+  const Realization realization = static_cast<Realization>(fields[0]);
+  bool valid = nb > 0 && na > 0 && fields[4] <= static_cast<std::uint64_t>(DenormalPolicy::FlushState) && fields[5] < flush_interval_;
+  if(valid && realization == Realization::DirectFormI)
+    valid = ni == 2*nb && no == 2*na && ns == 0 && fields[1] < nb && fields[2] < na;
+  else if(valid && realization == Realization::DirectFormIITransposed)
+    valid = ni == nb-1 && no == na-1 && ns == std::max(nb, na)-1;
+  else
+    valid = false;
+  if(!valid)
+    throw std::runtime_error("Filter::restore: the checkpoint is corrupted");
+
+  // rebuild the filter only if its buffers have a different layout
+  if(nb != b_.size() || na != a_.size() || realization != realization_) {
+    auto probe = probe_;
+    *this = Filter<DataType,CoeffType>(std::vector<CoeffType>(b, b+nb), std::vector<CoeffType>(a, a+na), realization);
+    probe_ = probe;
+  }
+
+  // coefficients are copied as they are, since they were already normalized
+  std::copy(b, b+nb, b_.begin());
+  std::copy(a, a+na, a_.begin());
+  updateSteadyState();
+  std::copy(in, in+ni, in_.begin());
+  std::copy(out, out+no, out_.begin());
+  std::copy(state, state+ns, state_.begin());
+  in_head_ = static_cast<unsigned int>(fields[1]);
+  out_head_ = static_cast<unsigned int>(fields[2]);
+  x_ = xy[0];
+  y_ = xy[1];
+  fft_threshold_ = fields[3];
+  setDenormalPolicy(static_cast<DenormalPolicy>(fields[4]));
+  unflushed_ = fields[5];
+  return reader.size();
+}
+
+
+template<class DataType, class CoeffType>
+void Filter<DataType,CoeffType>::rebuildState()
+{
+  // The i-th state collects the contributions of the past samples that will
+  // affect the output i+1 steps from now:
+  //   s_i = sum_{j>i} b_j x_{k+i-j} - a_j y_{k+i-j}
+  for(unsigned int i=0; i<state_.size(); i++) {
+    state_[i] = Accumulator();
+    for(unsigned int j=i+1; j<b_.size(); j++)
+      state_[i] = state_[i] + b_[j] * in_[j-i-1];
+    for(unsigned int j=i+1; j<a_.size(); j++)
+      state_[i] = state_[i] - a_[j] * out_[j-i-1];
+  }
+}
+
+
+template<class DataType, class CoeffType>
+void Filter<DataType,CoeffType>::setDenormalPolicy(
+  DenormalPolicy policy
+)
+{
+  denormal_policy_ = policy;
+  // the feedback is stored as DataType in the Direct Form I histories, and as
+  // Accumulator otherwise: the bias must be representable in both
+  bias_ = Accumulator();
+  if(policy == DenormalPolicy::Offset) {
+    bias_ = denormalThreshold<Accumulator>();
+    if constexpr(std::is_floating_point<DataType>::value)
+      bias_ = std::max(bias_, static_cast<Accumulator>(denormalThreshold<DataType>()));
+  }
+  unflushed_ = 0;
+}
+
+
+template<class DataType, class CoeffType>
+void Filter<DataType,CoeffType>::flushState()
+{
+  // the mirrored copies of the ring buffers are flushed as well
+  flushDenormals(in_.data(), in_.size());
+  flushDenormals(out_.data(), out_.size());
+  flushDenormals(state_.data(), state_.size());
+  unflushed_ = 0;
+}
+
+
+template<class DataType, class CoeffType>
+const DataType& Filter<DataType,CoeffType>::stepDirectFormI(
   const DataType& x
 )
 {
-  // remove unnecessary input/output
-  in_.pop_back();
-  out_.pop_back();
+  const unsigned int nb = b_.size();
+  const unsigned int na = a_.size();
+
+  // move the heads back so that they point to the slots of the new samples
+  in_head_ = (in_head_ == 0 ? nb : in_head_) - 1;
+  out_head_ = (out_head_ == 0 ? na : out_head_) - 1;
+
+  // store the new input (twice, since the buffer is mirrored)
+  in_[in_head_] = x;
+  in_[in_head_+nb] = x;
+
+  // past samples are now contiguous in memory, most recent first
+  const DataType* xk = &in_[in_head_];
+  const DataType* yk = &out_[out_head_];
+
+  // evaluate the difference equation
+  Accumulator y = x * b_[0] + bias_;
+  for(unsigned int i=1; i<nb; i++)
+    y = y + b_[i] * xk[i];
+  for(unsigned int i=1; i<na; i++)
+    y = y - a_[i] * yk[i];
+
+  // store the new output (twice, since the buffer is mirrored)
+  out_[out_head_+na] = static_cast<DataType>(y);
+  out_[out_head_] = out_[out_head_+na];
+  return out_[out_head_];
+}
 
-  // add new input/output
-  in_.push_front(x);
-  out_.push_front(x * b_[0]);
 
-  // complete the filtering
-  auto& y = out_[0];
+template<class DataType, class CoeffType>
+const DataType& Filter<DataType,CoeffType>::stepTransposed(
+  const DataType& x
+)
+{
+  x_ = x;
+  y_ = advanceTransposed(state_.data(), x);
+  return y_;
+}
 
-  for(unsigned int i=1; i<b_.size(); i++)
-    y = y + b_[i] * in_[i];
-  for(unsigned int i=1; i<a_.size(); i++)
-    y = y - a_[i] * out_[i];
+
+template<class DataType, class CoeffType>
+DataType Filter<DataType,CoeffType>::advanceTransposed(
+  Accumulator* state,
+  const DataType& x
+) const
+{
+  // evaluate the output and then shift the state
+  Accumulator y = x * b_[0] + bias_;
+  const unsigned int ns = std::max(b_.size(), a_.size()) - 1;
+  if(ns > 0) {
+    y = y + state[0];
+    for(unsigned int i=1; i<ns; i++)
+      state[i-1] = state[i];
+    state[ns-1] = Accumulator();
+    for(unsigned int i=1; i<b_.size(); i++)
+      state[i-1] = state[i-1] + b_[i] * x;
+    for(unsigned int i=1; i<a_.size(); i++)
+      state[i-1] = state[i-1] - a_[i] * y;
+  }
+  return static_cast<DataType>(y);
+}
+
+
+template<class DataType, class CoeffType>
+const DataType& Filter<DataType,CoeffType>::filter(
+  const DataType& x
+)
+{
+  DenormalGuard guard(denormal_policy_ == DenormalPolicy::FlushToZero);
+  const DataType& y = realization_ == Realization::DirectFormI ? stepDirectFormI(x) : stepTransposed(x);
+  if(denormal_policy_ == DenormalPolicy::FlushState && ++unflushed_ == flush_interval_)
+    flushState();
+  DIGITAL_FILTERS_PROBE_SAMPLE(probe_, y);
   return y;
 }
 
 
+template<class DataType, class CoeffType>
+void Filter<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+)
+{
+  DIGITAL_FILTERS_PROBE_BLOCK(probe_, y_out, n);
+  DenormalGuard guard(denormal_policy_ == DenormalPolicy::FlushToZero);
+  if(denormal_policy_ != DenormalPolicy::FlushState) {
+    filterBlock(x_in, y_out, n);
+    return;
+  }
+
+  // split the block so that the state is flushed at regular intervals
+  for(std::size_t k=0; k<n; ) {
+    const std::size_t length = std::min(n - k, flush_interval_ - unflushed_);
+    filterBlock(x_in + k, y_out + k, length);
+    k += length;
+    unflushed_ += length;
+    if(unflushed_ == flush_interval_)
+      flushState();
+  }
+}
+
+
+template<class DataType, class CoeffType>
+void Filter<DataType,CoeffType>::filterBlock(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+)
+{
+  // The transposed form only needs the current input, hence it works
+  // in-place as well
+  if(realization_ == Realization::DirectFormIITransposed) {
+    for(std::size_t k=0; k<n; k++)
+      y_out[k] = stepTransposed(x_in[k]);
+    return;
+  }
+
+  // When filtering in-place, past inputs are overwritten by the outputs: the
+  // ring buffer must be used for all samples
+  const std::size_t nb = b_.size();
+  const std::size_t na = a_.size();
+  const std::size_t warmup = std::min(n, std::max(nb, na) - 1);
+  if(x_in == y_out || warmup == n) {
+    for(std::size_t k=0; k<n; k++)
+      y_out[k] = stepDirectFormI(x_in[k]);
+    return;
+  }
+
+  // the first samples need values from the ring buffer
+  for(std::size_t k=0; k<warmup; k++)
+    y_out[k] = stepDirectFormI(x_in[k]);
+
+  // steady-state: all past samples are available in the input/output blocks
+  for(std::size_t k=warmup; k<n; k++) {
+    const DataType* xk = x_in + k;
+    const DataType* yk = y_out + k;
+    Accumulator y = xk[0] * b_[0] + bias_;
+    for(std::size_t i=1; i<nb; i++)
+      y = y + b_[i] * xk[-i];
+    for(std::size_t i=1; i<na; i++)
+      y = y - a_[i] * yk[-i];
+    y_out[k] = static_cast<DataType>(y);
+  }
+
+  // copy the most recent samples back into the ring buffers
+  in_head_ = 0;
+  out_head_ = 0;
+  for(std::size_t i=0; i<nb-1; i++)
+    in_[i] = in_[i+nb] = x_in[n-1-i];
+  for(std::size_t i=0; i<na-1; i++)
+    out_[i] = out_[i+na] = y_out[n-1-i];
+}
+
+
 template<class DataType, class CoeffType>
 std::vector<DataType> Filter<DataType,CoeffType>::filter(
   const std::vector<DataType>& x,
@@ -151,31 +543,42 @@ std::vector<DataType> Filter<DataType,CoeffType>::filter(
     throw std::runtime_error(
       "Filter::filter: initial conditions 'x0' have " +
       std::to_string(x0.size()) + " elements, but " +
-      std::to_string(b_.size()) + " are required"
+      std::to_string(b_.size() - 1) + " are required"
     );
   }
   if(y0.size() != a_.size() - 1) {
     throw std::runtime_error(
       "Filter::filter: initial conditions 'y0' have " +
       std::to_string(y0.size()) + " elements, but " +
-      std::to_string(a_.size()) + " are required"
+      std::to_string(a_.size() - 1) + " are required"
     );
   }
 
   // Prepare the output vector
-  std::vector<DataType> y;
-  y.reserve(x.size());
+  const std::size_t n = x.size();
+  std::vector<DataType> y(n);
+  DIGITAL_FILTERS_PROBE_BLOCK(probe_, y.data(), n);
+  DenormalGuard guard(denormal_policy_ == DenormalPolicy::FlushToZero);
+
+  // Long FIR filters are cheaper to evaluate in the frequency domain
+  if constexpr(std::is_floating_point<DataType>::value && std::is_floating_point<CoeffType>::value) {
+    if(a_.size() == 1 && fft_threshold_ > 0 && b_.size() >= fft_threshold_) {
+      overlapSave(b_, x0.data(), x.data(), y.data(), n);
+      return y;
+    }
+  }
 
-  // main loop: do the filtering
-  for(unsigned int k=0; k<x.size(); k++) {
+  // The first samples need values from the initial conditions
+  const std::size_t warmup = std::min(n, std::max(b_.size(), a_.size()) - 1);
+  for(std::size_t k=0; k<warmup; k++) {
     // Init the "current" output from the corresponding input
-    DataType yk = b_[0] * x[k];
+    Accumulator yk = b_[0] * x[k] + bias_;
 
     // Add the contributions from past inputs
-    for(unsigned int i=1; i<b_.size(); i++) {
+    for(std::size_t i=1; i<b_.size(); i++) {
       if(i > k) {
         // use values from the initial conditions
-        yk = yk + b_[i] * x0[i-k-1];
+        yk = yk + b_[i] * x0[x0.size()+k-i];
       }
       else {
         // use values from the input vector
@@ -184,19 +587,28 @@ std::vector<DataType> Filter<DataType,CoeffType>::filter(
     }
 
     // Add the contributions from past outputs
-    for(unsigned int i=1; i<a_.size(); i++) {
+    for(std::size_t i=1; i<a_.size(); i++) {
       if(i > k) {
         // use values from the initial conditions
-        yk = yk - a_[i] * y0[i-k-1];
+        yk = yk - a_[i] * y0[y0.size()+k-i];
       }
       else {
-        // use values from the input vector
+        // use values from the output vector
         yk = yk - a_[i] * y[k-i];
       }
     }
 
-    // push the computed value into the result vector
-    y.push_back(yk);
+    y[k] = static_cast<DataType>(yk);
+  }
+
+  // Steady-state: all past samples are available, hence no branches
+  for(std::size_t k=warmup; k<n; k++) {
+    Accumulator yk = b_[0] * x[k] + bias_;
+    for(std::size_t i=1; i<b_.size(); i++)
+      yk = yk + b_[i] * x[k-i];
+    for(std::size_t i=1; i<a_.size(); i++)
+      yk = yk - a_[i] * y[k-i];
+    y[k] = static_cast<DataType>(yk);
   }
 
   // return the filtered vector
@@ -206,26 +618,95 @@ std::vector<DataType> Filter<DataType,CoeffType>::filter(
 
 template<class DataType, class CoeffType>
 std::vector<DataType> Filter<DataType,CoeffType>::filter2(
-  const std::vector<DataType>& x
+  const std::vector<DataType>& x,
+  std::size_t padding
 ) const
 {
-  // filter on one side
-  std::vector<DataType> y = filter(
-    x,
-    std::vector<DataType>(b_.size()-1, x.at(0)),
-    std::vector<DataType>(a_.size()-1, x.at(0))
-  );
-  // reverse the signal
-  std::reverse(y.begin(), y.end());
-  // filter again
-  std::vector<DataType> z = filter(
-    y,
-    std::vector<DataType>(b_.size()-1, y.at(0)),
-    std::vector<DataType>(a_.size()-1, y.at(0))
-  );
-  // reverse the final result and return it
-  std::reverse(z.begin(), z.end());
-  return z;
+  std::vector<DataType> y(x.size());
+  std::vector<Accumulator> state(scratch_state_.size());
+  std::vector<DataType> pad(padding);
+  filter2(x.data(), y.data(), x.size(), padding, state.data(), pad.data());
+  return y;
+}
+
+
+template<class DataType, class CoeffType>
+void Filter<DataType,CoeffType>::filter2(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n,
+  std::size_t padding
+)
+{
+  if(scratch_pad_.size() < padding)
+    scratch_pad_.resize(padding);
+  filter2(x_in, y_out, n, padding, scratch_state_.data(), scratch_pad_.data());
+}
+
+
+template<class DataType, class CoeffType>
+void Filter<DataType,CoeffType>::filter2(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n,
+  std::size_t padding,
+  Accumulator* state,
+  DataType* pad
+) const
+{
+  if(n == 0)
+    return;
+  if(padding >= n) {
+    throw std::runtime_error(
+      "Filter::filter2: the padding (" + std::to_string(padding) + " samples)"
+      " must be shorter than the signal (" + std::to_string(n) + " samples)"
+    );
+  }
+  DIGITAL_FILTERS_PROBE_BLOCK(probe_, y_out, n);
+  DenormalGuard guard(denormal_policy_ == DenormalPolicy::FlushToZero);
+
+  // set the state to the steady-state response to the given input
+  const std::size_t ns = scratch_state_.size();
+  const bool steady = zi_.size() == ns;
+  auto init = [&](const DataType& x) {
+    for(std::size_t i=0; i<ns; i++)
+      state[i] = steady ? zi_[i] * x : Accumulator();
+  };
+  // advance the state, flushing it at regular intervals if required
+  const bool flush = denormal_policy_ == DenormalPolicy::FlushState;
+  std::size_t unflushed = 0;
+  auto advance = [&](const DataType& x) {
+    const DataType y = advanceTransposed(state, x);
+    if(flush && ++unflushed == flush_interval_) {
+      flushDenormals(state, ns);
+      unflushed = 0;
+    }
+    return y;
+  };
+
+  // Prepare the right extension now, since the signal might be overwritten
+  // by the forward pass (when filtering in-place)
+  const DataType right = x_in[n-1] + x_in[n-1];
+  for(std::size_t i=0; i<padding; i++)
+    pad[i] = right - x_in[n-2-i];
+
+  // forward pass over the left extension, whose outputs are not needed...
+  const DataType left = x_in[0] + x_in[0];
+  init(padding > 0 ? left - x_in[padding] : x_in[0]);
+  for(std::size_t i=padding; i>0; i--)
+    advance(left - x_in[i]);
+  // ...then over the signal and the right extension
+  for(std::size_t k=0; k<n; k++)
+    y_out[k] = advance(x_in[k]);
+  for(std::size_t i=0; i<padding; i++)
+    pad[i] = advance(pad[i]);
+
+  // backward pass, starting from the end of the right extension
+  init(padding > 0 ? pad[padding-1] : y_out[n-1]);
+  for(std::size_t i=padding; i>0; i--)
+    advance(pad[i-1]);
+  for(std::size_t k=n; k>0; k--)
+    y_out[k-1] = advance(y_out[k-1]);
 }
 
 } // namespace digital_filters
@@ -0,0 +1,204 @@
+/** @file filter_bank.hpp
+  * @brief Header file containing the FilterBank class.
+  */
+#pragma once
+
+#include <digital_filters/checkpoint.hpp>
+#include <digital_filters/filter.hpp>
+#include <digital_filters/simd.hpp>
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+namespace digital_filters {
+
+/// Set of identical filters applied to many channels at once.
+/** Instead of storing one Filter per channel, each one with its own copy of
+  * the coefficients, a bank shares a single set of coefficients among all
+  * channels. The internal state uses a Direct Form II Transposed structure
+  * and it is stored in structure-of-arrays layout: the \f$ i \f$-th state
+  * variable of all channels is contiguous in memory. This allows to update
+  * several channels with a single SIMD instruction, see SimdPack.
+  *
+  * The state is stored using the type of the products between coefficients
+  * and samples (see Filter::Accumulator): a `FilterBank<float,double>`
+  * exchanges single precision samples but accumulates in double precision.
+  * When SIMD instructions are available, this combination is vectorized as
+  * well, converting samples on the fly.
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the coefficients of the transfer function.
+  */
+template <class DataType, class CoeffType>
+class FilterBank {
+public:
+  /// Type used to store the state and to accumulate products.
+  typedef typename Filter<DataType,CoeffType>::Accumulator Accumulator;
+
+  /// Generates a bank from given coefficients.
+  /** @param b_num Numerator of the discrete transfer function.
+    * @param a_den Denominator of the discrete transfer function.
+    * @param channels number of channels in the bank.
+    * @see Filter::Filter()
+    */
+  FilterBank(
+    const std::vector<CoeffType>& b_num,
+    const std::vector<CoeffType>& a_den,
+    std::size_t channels
+  );
+
+  /// Generates a bank that applies the same filter to many channels.
+  /** @param design filter to be applied to each channel. Only its
+    *   coefficients are copied; the state of all channels is set to zero.
+    * @param channels number of channels in the bank.
+    */
+  FilterBank(
+    const Filter<DataType,CoeffType>& design,
+    std::size_t channels
+  );
+
+  /// Number of channels in the bank.
+  inline std::size_t channels() const { return channels_; }
+
+  /// Access the (normalized) numerator.
+  inline const std::vector<CoeffType>& numerator() const { return b_; }
+
+  /// Access the (normalized) denominator.
+  inline const std::vector<CoeffType>& denominator() const { return a_; }
+
+  /// Name of the instruction set used to process the channels.
+  static const char* instructionSet();
+
+  /// Replace the coefficients of the filter, keeping the state.
+  /** The new coefficients are normalized and copied into the existing
+    * buffers, so that no memory is allocated.
+    * @param b_num new numerator. It must have the same size as numerator().
+    * @param a_den new denominator. It must have the same size as
+    *   denominator(), and its first element must not be zero.
+    * @param input if not null, pointer to the last input of each channel. The
+    *   state of each channel is then shifted by the difference between the
+    *   new and the old steady-state for this input, as in
+    *   Filter::setCoefficients(). Otherwise, the state is kept as is.
+    * @note An exception is thrown if the sizes do not match.
+    */
+  void setCoefficients(
+    const std::vector<CoeffType>& b_num,
+    const std::vector<CoeffType>& a_den,
+    const DataType* input = nullptr
+  );
+
+  /// Set the state of all channels to zero.
+  void reset();
+
+  /// Set the state to the steady-state response to constant inputs.
+  /** @param input pointer to one value per channel. After calling this
+    *   method, filtering again the same values produces no transient.
+    */
+  void initSteadyState(
+    const DataType* input
+  );
+
+  /// Save the coefficients and the exact state of all channels.
+  /** The state is stored as a single array, in the same layout used in
+    * memory.
+    * @param[out] buffer destination of the checkpoint. The record is appended
+    *   to its previous content.
+    * @see checkpoint.hpp
+    */
+  void checkpoint(
+    std::vector<unsigned char>& buffer
+  ) const;
+
+  /// Restore the coefficients and the state saved by checkpoint().
+  /** If the checkpoint has the same number of coefficients and channels as
+    * `this`, the state of all channels is copied from the record with a
+    * single `memcpy()` and no memory is allocated. Otherwise, the bank is
+    * rebuilt first.
+    * @param data pointer to the record, aligned to checkpointAlignment().
+    * @param size number of bytes available from `data`.
+    * @return size of the record, *i.e.*, offset of the next record.
+    * @note An exception is thrown if the record is invalid, or if it was
+    *   written by a bank with different template types. In this case, the
+    *   bank is not modified.
+    */
+  std::size_t restore(
+    const void* data,
+    std::size_t size
+  );
+
+  /// Filter one sample per channel.
+  /** @param x_in pointer to one input sample per channel.
+    * @param y_out pointer to one output sample per channel. It can be equal
+    *   to `x_in`, in which case samples are filtered in-place.
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out
+  );
+
+  /// Filter multiple samples per channel.
+  /** @param x_in pointer to `frames*channels()` input samples. Channels are
+    *   interleaved, *i.e.*, `x_in[k*channels()+c]` is the \f$ k \f$-th sample
+    *   of the channel \f$ c \f$.
+    * @param y_out pointer to `frames*channels()` output samples, using the
+    *   same layout as the input. It can be equal to `x_in`.
+    * @param frames number of samples per channel.
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t frames
+  );
+
+private:
+  /// Whether channels can be processed using SIMD packs.
+  /** Packs are used when the coefficients have the same type as the
+    * accumulators, and samples are either of the same type or `float` values
+    * accumulated as `double`.
+    */
+  static constexpr bool packable() {
+    return SimdPack<Accumulator>::width > 1
+      && std::is_same<Accumulator,CoeffType>::value
+      && (std::is_same<DataType,Accumulator>::value
+        || (std::is_same<DataType,float>::value && std::is_same<Accumulator,double>::value));
+  }
+
+  /// Recomputes `zi_` from the current coefficients, without allocating.
+  void updateSteadyState();
+
+  /// Process channels in groups of SimdPack::width elements.
+  /** @return index of the first channel that was not processed.
+    */
+  std::size_t filterPacked(
+    const DataType* x_in,
+    DataType* y_out
+  );
+
+  /// Process channels one at a time.
+  /** @param first index of the first channel to be processed.
+    */
+  void filterScalar(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t first
+  );
+
+  std::size_t channels_; ///< Number of channels in the bank.
+  std::vector<CoeffType> b_; ///< Numerator of the transfer function.
+  std::vector<CoeffType> a_; ///< Denominator of the transfer function.
+  std::vector<CoeffType> bp_; ///< Numerator, zero-padded to the filter order.
+  std::vector<CoeffType> ap_; ///< Denominator, zero-padded to the filter order.
+  /// State of a single channel in steady-state for a unit input.
+  /** It is empty if the filter has a pole in \f$ z=1 \f$.
+    * @see steadyState()
+    */
+  std::vector<CoeffType> zi_;
+  /// State of all channels.
+  /** The \f$ i \f$-th state variable of the channel \f$ c \f$ is stored in
+    * `state_[i*channels_+c]`.
+    */
+  std::vector<Accumulator> state_;
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/filter_bank.hxx>
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <digital_filters/simd.hpp>
+#include <digital_filters/utilities.hpp>
+
+
+namespace digital_filters {
+
+template<class DataType, class CoeffType>
+FilterBank<DataType,CoeffType>::FilterBank(
+  const std::vector<CoeffType>& b_num,
+  const std::vector<CoeffType>& a_den,
+  std::size_t channels
+)
+: channels_(channels)
+, b_(b_num)
+, a_(a_den)
+{
+  // check sizes
+  if(b_num.size() == 0)
+    throw std::runtime_error("FilterBank: numerator (b) is empty");
+  if(a_den.size() == 0)
+    throw std::runtime_error("FilterBank: denominator (a) is empty");
+
+  // normalize numerator and denominator
+  for(auto& bi : b_)
+    bi = bi / a_den[0];
+  for(auto& ai : a_)
+    ai = ai / a_den[0];
+
+  // pad the coefficients, so that all state variables are updated alike
+  const std::size_t n = std::max(b_.size(), a_.size());
+  bp_ = b_;
+  ap_ = a_;
+  bp_.resize(n, CoeffType(0));
+  ap_.resize(n, CoeffType(0));
+  state_.resize((n-1)*channels_);
+  zi_.reserve(n-1);
+  updateSteadyState();
+}
+
+
+template<class DataType, class CoeffType>
+FilterBank<DataType,CoeffType>::FilterBank(
+  const Filter<DataType,CoeffType>& design,
+  std::size_t channels
+)
+: FilterBank(design.numerator(), design.denominator(), channels)
+{
+  // no extra code needed
+}
+
+
+template<class DataType, class CoeffType>
+const char* FilterBank<DataType,CoeffType>::instructionSet()
+{
+  if constexpr(packable())
+    return SimdPack<Accumulator>::name;
+  else
+    return "scalar";
+}
+
+
+template<class DataType, class CoeffType>
+void FilterBank<DataType,CoeffType>::setCoefficients(
+  const std::vector<CoeffType>& b_num,
+  const std::vector<CoeffType>& a_den,
+  const DataType* input
+)
+{
+  // check sizes
+  if(b_num.size() != b_.size() || a_den.size() != a_.size()) {
+    throw std::runtime_error(
+      "FilterBank::setCoefficients: expected " + std::to_string(b_.size()) +
+      " numerator and " + std::to_string(a_.size()) + " denominator "
+      "coefficients, but " + std::to_string(b_num.size()) + " and " +
+      std::to_string(a_den.size()) + " were given"
+    );
+  }
+  if(a_den[0] == CoeffType(0))
+    throw std::runtime_error("FilterBank::setCoefficients: the first denominator coefficient (a0) is zero");
+
+  // shift the state only if both filters have a steady-state
+  CoeffType Sa = a_den[0];
+  for(unsigned int i=1; i<a_den.size(); i++)
+    Sa = Sa + a_den[i];
+  const bool shift = input && zi_.size() == bp_.size()-1 && Sa != CoeffType(0);
+  if(shift)
+    for(std::size_t i=0; i<zi_.size(); i++)
+      for(std::size_t c=0; c<channels_; c++)
+        state_[i*channels_+c] = state_[i*channels_+c] - zi_[i] * input[c];
+
+  // update the coefficients, including the padded ones
+  for(std::size_t i=0; i<b_.size(); i++)
+    bp_[i] = b_[i] = b_num[i] / a_den[0];
+  for(std::size_t i=0; i<a_.size(); i++)
+    ap_[i] = a_[i] = a_den[i] / a_den[0];
+  updateSteadyState();
+
+  if(shift)
+    for(std::size_t i=0; i<zi_.size(); i++)
+      for(std::size_t c=0; c<channels_; c++)
+        state_[i*channels_+c] = state_[i*channels_+c] + zi_[i] * input[c];
+}
+
+
+template<class DataType, class CoeffType>
+void FilterBank<DataType,CoeffType>::updateSteadyState()
+{
+  CoeffType Sa = a_[0];
+  for(unsigned int i=1; i<a_.size(); i++)
+    Sa = Sa + a_[i];
+  if(Sa == CoeffType(0)) {
+    zi_.clear();
+    return;
+  }
+  zi_.resize(bp_.size()-1);
+  steadyState(b_, a_, zi_.data());
+}
+
+
+template<class DataType, class CoeffType>
+void FilterBank<DataType,CoeffType>::reset()
+{
+  for(auto& z : state_)
+    z = Accumulator();
+}
+
+
+template<class DataType, class CoeffType>
+void FilterBank<DataType,CoeffType>::checkpoint(
+  std::vector<unsigned char>& buffer
+) const
+{
+  CheckpointWriter writer(buffer, checkpointHeader<DataType,CoeffType,Accumulator>(CheckpointKind::FilterBank));
+  writer.write(static_cast<std::uint64_t>(channels_));
+  writer.write(b_.data(), b_.size());
+  writer.write(a_.data(), a_.size());
+  writer.write(state_.data(), state_.size());
+  writer.close();
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t FilterBank<DataType,CoeffType>::restore(
+  const void* data,
+  std::size_t size
+)
+{
+  CheckpointReader reader(data, size, checkpointHeader<DataType,CoeffType,Accumulator>(CheckpointKind::FilterBank));
+  const std::uint64_t channels = reader.value<std::uint64_t>();
+  std::size_t nb, na, ns;
+  const CoeffType* b = reader.read<CoeffType>(nb);
+  const CoeffType* a = reader.read<CoeffType>(na);
+  const Accumulator* state = reader.read<Accumulator>(ns);
+  if(nb == 0 || na == 0 || ns != (std::max(nb, na)-1)*channels)
+    throw std::runtime_error("FilterBank::restore: the checkpoint is corrupted");
+
+  // rebuild the bank only if its buffers have a different size
+  if(nb != b_.size() || na != a_.size() || channels != channels_)
+    *this = FilterBank<DataType,CoeffType>(std::vector<CoeffType>(b, b+nb), std::vector<CoeffType>(a, a+na), channels);
+
+  // coefficients are copied as they are, since they were already normalized
+  std::copy(b, b+nb, b_.begin());
+  std::copy(a, a+na, a_.begin());
+  std::copy(b, b+nb, bp_.begin());
+  std::copy(a, a+na, ap_.begin());
+  updateSteadyState();
+  if(ns > 0)
+    std::memcpy(state_.data(), state, ns*sizeof(Accumulator));
+  return reader.size();
+}
+
+
+template<class DataType, class CoeffType>
+void FilterBank<DataType,CoeffType>::initSteadyState(
+  const DataType* input
+)
+{
+  if(zi_.size() != bp_.size()-1) {
+    throw std::runtime_error(
+      "FilterBank::initSteadyState: the filter has a pole in z=1, hence the "
+      "steady-state output is not defined"
+    );
+  }
+  for(std::size_t i=0; i<zi_.size(); i++)
+    for(std::size_t c=0; c<channels_; c++)
+      state_[i*channels_+c] = zi_[i] * input[c];
+}
+
+
+template<class DataType, class CoeffType>
+void FilterBank<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out
+)
+{
+  filterScalar(x_in, y_out, filterPacked(x_in, y_out));
+}
+
+
+template<class DataType, class CoeffType>
+void FilterBank<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t frames
+)
+{
+  for(std::size_t k=0; k<frames; k++)
+    filter(x_in + k*channels_, y_out + k*channels_);
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t FilterBank<DataType,CoeffType>::filterPacked(
+  const DataType* x_in,
+  DataType* y_out
+)
+{
+  if constexpr(packable()) {
+    // samples are converted to the accumulator type by the loads/stores
+    typedef SimdPack<Accumulator> Pack;
+    const std::size_t ns = bp_.size() - 1;
+    const std::size_t packed = channels_ - channels_ % Pack::width;
+    for(std::size_t c=0; c<packed; c+=Pack::width) {
+      Accumulator* z = state_.data() + c;
+      const auto x = Pack::load(x_in + c);
+      auto y = Pack::mul(Pack::broadcast(bp_[0]), x);
+      if(ns > 0) {
+        y = Pack::add(y, Pack::load(z));
+        for(std::size_t i=1; i<ns; i++) {
+          auto zi = Pack::load(z + i*channels_);
+          zi = Pack::add(zi, Pack::mul(Pack::broadcast(bp_[i]), x));
+          zi = Pack::sub(zi, Pack::mul(Pack::broadcast(ap_[i]), y));
+          Pack::store(z + (i-1)*channels_, zi);
+        }
+        auto zn = Pack::mul(Pack::broadcast(bp_[ns]), x);
+        zn = Pack::sub(zn, Pack::mul(Pack::broadcast(ap_[ns]), y));
+        Pack::store(z + (ns-1)*channels_, zn);
+      }
+      Pack::store(y_out + c, y);
+    }
+    return packed;
+  }
+  else {
+    return 0;
+  }
+}
+
+
+template<class DataType, class CoeffType>
+void FilterBank<DataType,CoeffType>::filterScalar(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t first
+)
+{
+  const std::size_t ns = bp_.size() - 1;
+  for(std::size_t c=first; c<channels_; c++) {
+    Accumulator* z = state_.data() + c;
+    const DataType x = x_in[c];
+    Accumulator y = bp_[0] * x;
+    if(ns > 0) {
+      y = y + z[0];
+      for(std::size_t i=1; i<ns; i++)
+        z[(i-1)*channels_] = z[i*channels_] + bp_[i] * x - ap_[i] * y;
+      z[(ns-1)*channels_] = bp_[ns] * x - ap_[ns] * y;
+    }
+    y_out[c] = static_cast<DataType>(y);
+  }
+}
+
+} // namespace digital_filters
@@ -0,0 +1,180 @@
+/** @file filter_chain.hpp
+  * @brief Header file containing the FilterChain class.
+  */
+#pragma once
+
+#include <digital_filters/checkpoint.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace digital_filters {
+
+/// Cascade of heterogeneous filters, executed tile by tile.
+/** Filter::operator*() combines two filters by multiplying their
+  * polynomials, which yields a single high-order filter that is numerically
+  * worse than its factors, and it cannot combine filters of different kinds.
+  * This class instead stores the stages as they are: any object providing
+  * the methods `filter(const DataType&)` and
+  * `filter(const DataType*, DataType*, std::size_t)` (such as Filter,
+  * SosFilter and MovingAverage) can be appended, as well as point-wise
+  * functions, *e.g.*, a saturation.
+  *
+  * Blocks are split into tiles, and each tile passes through all stages
+  * before the next one is loaded. With tiles that fit in the L1 cache, the
+  * intermediate signals are never written to memory: the cost of a chain is
+  * the sum of the costs of its stages, without one full pass over the data
+  * per stage. The tiles are filtered in-place into the output buffer, hence
+  * no memory is allocated while filtering.
+  *
+  * Example:
+  * @code
+  * digital_filters::FilterChain<double> chain;
+  * chain.append(digital_filters::exponential<double,double>(0.3));
+  * chain.append(digital_filters::butterworthSos<double,double>(4, 10., 1000.));
+  * chain.append(digital_filters::MovingAverage<double,double>(8));
+  * chain.filter(x.data(), y.data(), x.size());
+  * @endcode
+  * @tparam DataType Type of the input/output signals.
+  */
+template <class DataType>
+class FilterChain {
+public:
+  /// Creates an empty chain, which returns its input unchanged.
+  /** @param tile_size number of samples that pass through all stages at
+    *   once. If zero, tiles of 8 KiB are used, which fit comfortably in the
+    *   L1 data cache of common processors.
+    */
+  explicit FilterChain(
+    std::size_t tile_size = 0
+  );
+
+  /// Copy a chain, including the state of all its stages.
+  FilterChain(
+    const FilterChain<DataType>& other
+  );
+
+  /// Copy a chain, including the state of all its stages.
+  FilterChain<DataType>& operator=(
+    const FilterChain<DataType>& other
+  );
+
+  FilterChain(FilterChain<DataType>&&) = default;
+  FilterChain<DataType>& operator=(FilterChain<DataType>&&) = default;
+
+  /// Add a stage at the end of the chain.
+  /** @param stage filter to be appended. It is copied (or moved) inside the
+    *   chain, together with its internal state.
+    * @return reference to the stored stage, which can be used to inspect or
+    *   retune it. It remains valid as long as the chain exists.
+    */
+  template <class Stage>
+  Stage& append(
+    Stage stage
+  );
+
+  /// Add a point-wise stage at the end of the chain.
+  /** @param function callable object that maps one sample into one sample,
+    *   *e.g.*, a saturation or a rectifier. It should not have side
+    *   effects, since it might be invoked on tiles of any size.
+    */
+  template <class Function>
+  void appendFunction(
+    Function function
+  );
+
+  /// Number of stages.
+  inline std::size_t size() const { return stages_.size(); }
+
+  /// Number of samples that pass through all stages at once.
+  inline std::size_t tileSize() const { return tile_size_; }
+
+  /// Change the number of samples that pass through all stages at once.
+  /** @param tile_size new size of the tiles. If zero, the default is used.
+    */
+  void setTileSize(
+    std::size_t tile_size
+  );
+
+  /// Save the exact state of all stages.
+  /** The record of the chain is followed by the records of its stages, see
+    * checkpoint.hpp. Point-wise functions are stateless, and they are not
+    * saved at all.
+    * @param[out] buffer destination of the checkpoint. The record is appended
+    *   to its previous content.
+    * @note An exception is thrown if a stage does not support checkpoints,
+    *   see SupportsCheckpoint.
+    */
+  void checkpoint(
+    std::vector<unsigned char>& buffer
+  ) const;
+
+  /// Restore the state of all stages saved by checkpoint().
+  /** The chain must have the same structure as the one that was saved,
+    * *i.e.*, the same number of stages of the same types: only their
+    * coefficients and states are restored.
+    * @param data pointer to the record, aligned to checkpointAlignment().
+    * @param size number of bytes available from `data`.
+    * @return size of the record, including the records of the stages.
+    * The records of the stages are validated on copies of the stages before
+    * any of them is restored, hence references returned by append() remain
+    * valid.
+    * @note An exception is thrown if the record is invalid or if the
+    *   structure of the chain does not match. In this case, the chain is not
+    *   modified.
+    */
+  std::size_t restore(
+    const void* data,
+    std::size_t size
+  );
+
+  /// Filter the current input through all stages.
+  const DataType& filter(
+    const DataType& x
+  );
+
+  /// Filter a block of samples through all stages.
+  /** The state of each stage is updated, so that consecutive calls behave as
+    * if all samples were passed one at a time to filter(const DataType&).
+    * @param x_in pointer to `n` input samples.
+    * @param y_out pointer to `n` output samples. It can be equal to `x_in`.
+    * @param n number of samples in the block.
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  );
+
+private:
+  /// Type-erased interface of the stages.
+  struct StageBase {
+    virtual ~StageBase() = default;
+    /// Filter one sample.
+    virtual DataType filter(const DataType& x) = 0;
+    /// Filter a block in-place.
+    virtual void filter(DataType* y, std::size_t n) = 0;
+    /// Copy the stage, including its state.
+    virtual std::unique_ptr<StageBase> clone() const = 0;
+    /// Append the record of the stage to a checkpoint.
+    virtual void checkpoint(std::vector<unsigned char>& buffer) const = 0;
+    /// Restore the stage from a record, returning its size.
+    virtual std::size_t restore(const void* data, std::size_t size) = 0;
+  };
+
+  /// A filter stored in the chain.
+  template <class Stage>
+  struct FilterStage;
+
+  /// A point-wise function stored in the chain.
+  template <class Function>
+  struct FunctionStage;
+
+  std::vector<std::unique_ptr<StageBase>> stages_; ///< Filters in the chain.
+  std::size_t tile_size_; ///< Samples that pass through all stages at once.
+  DataType y_; ///< Latest output of filter(const DataType&).
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/filter_chain.hxx>
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+namespace digital_filters {
+
+template<class DataType>
+template<class Stage>
+struct FilterChain<DataType>::FilterStage : public StageBase {
+  Stage stage; ///< The wrapped filter.
+
+  explicit FilterStage(Stage&& s) : stage(std::move(s)) {}
+
+  DataType filter(const DataType& x) override { return stage.filter(x); }
+
+  void filter(DataType* y, std::size_t n) override { stage.filter(y, y, n); }
+
+  std::unique_ptr<StageBase> clone() const override {
+    return std::unique_ptr<StageBase>(new FilterStage<Stage>(Stage(stage)));
+  }
+
+  void checkpoint(std::vector<unsigned char>& buffer) const override {
+    if constexpr(SupportsCheckpoint<Stage>::value)
+      stage.checkpoint(buffer);
+    else
+      throw std::runtime_error("FilterChain::checkpoint: a stage does not support checkpoints");
+  }
+
+  std::size_t restore(const void* data, std::size_t size) override {
+    if constexpr(SupportsCheckpoint<Stage>::value)
+      return stage.restore(data, size);
+    else
+      throw std::runtime_error("FilterChain::restore: a stage does not support checkpoints");
+  }
+};
+
+
+template<class DataType>
+template<class Function>
+struct FilterChain<DataType>::FunctionStage : public StageBase {
+  Function function; ///< The wrapped function.
+
+  explicit FunctionStage(Function&& f) : function(std::move(f)) {}
+
+  DataType filter(const DataType& x) override { return function(x); }
+
+  void filter(DataType* y, std::size_t n) override {
+    for(std::size_t k=0; k<n; k++)
+      y[k] = function(y[k]);
+  }
+
+  std::unique_ptr<StageBase> clone() const override {
+    return std::unique_ptr<StageBase>(new FunctionStage<Function>(Function(function)));
+  }
+
+  void checkpoint(std::vector<unsigned char>&) const override {}
+
+  std::size_t restore(const void*, std::size_t) override { return 0; }
+};
+
+
+template<class DataType>
+FilterChain<DataType>::FilterChain(
+  std::size_t tile_size
+)
+: y_()
+{
+  setTileSize(tile_size);
+}
+
+
+template<class DataType>
+FilterChain<DataType>::FilterChain(
+  const FilterChain<DataType>& other
+)
+: tile_size_(other.tile_size_)
+, y_(other.y_)
+{
+  stages_.reserve(other.stages_.size());
+  for(const auto& stage : other.stages_)
+    stages_.push_back(stage->clone());
+}
+
+
+template<class DataType>
+FilterChain<DataType>& FilterChain<DataType>::operator=(
+  const FilterChain<DataType>& other
+)
+{
+  if(this != &other) {
+    FilterChain<DataType> copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+
+template<class DataType>
+template<class Stage>
+Stage& FilterChain<DataType>::append(
+  Stage stage
+)
+{
+  // the wrapper is owned before the vector grows, in case this throws
+  auto wrapper = std::make_unique<FilterStage<Stage>>(std::move(stage));
+  Stage& stored = wrapper->stage;
+  stages_.push_back(std::move(wrapper));
+  return stored;
+}
+
+
+template<class DataType>
+template<class Function>
+void FilterChain<DataType>::appendFunction(
+  Function function
+)
+{
+  stages_.push_back(std::make_unique<FunctionStage<Function>>(std::move(function)));
+}
+
+
+template<class DataType>
+void FilterChain<DataType>::setTileSize(
+  std::size_t tile_size
+)
+{
+  if(tile_size == 0)
+    tile_size = std::max<std::size_t>(1, 8192 / sizeof(DataType));
+  tile_size_ = tile_size;
+}
+
+
+template<class DataType>
+void FilterChain<DataType>::checkpoint(
+  std::vector<unsigned char>& buffer
+) const
+{
+  CheckpointWriter writer(buffer, checkpointHeader<DataType>(CheckpointKind::FilterChain));
+  const std::uint64_t fields[2] = {stages_.size(), tile_size_};
+  writer.write(fields, 2);
+  writer.write(y_);
+  for(const auto& stage : stages_)
+    stage->checkpoint(buffer);
+  writer.close();
+}
+
+
+template<class DataType>
+std::size_t FilterChain<DataType>::restore(
+  const void* data,
+  std::size_t size
+)
+{
+  CheckpointReader reader(data, size, checkpointHeader<DataType>(CheckpointKind::FilterChain));
+  const std::uint64_t* fields = reader.readExactly<std::uint64_t>(2);
+  if(fields[0] != stages_.size()) {
+    throw std::runtime_error(
+      "FilterChain::restore: the checkpoint contains " + std::to_string(fields[0]) +
+      " stages, but the chain has " + std::to_string(stages_.size())
+    );
+  }
+  const std::size_t tile_size = fields[1];
+  const DataType y = reader.value<DataType>();
+  // validate all nested records on copies of the stages first, so that the
+  // chain is not modified if one of them is invalid
+  CheckpointReader validation = reader;
+  for(const auto& stage : stages_) {
+    auto copy = stage->clone();
+    validation.restore(*copy);
+  }
+  for(auto& stage : stages_)
+    reader.restore(*stage);
+  setTileSize(tile_size);
+  y_ = y;
+  return reader.size();
+}
+
+
+template<class DataType>
+const DataType& FilterChain<DataType>::filter(
+  const DataType& x
+)
+{
+  y_ = x;
+  for(auto& stage : stages_)
+    y_ = stage->filter(y_);
+  return y_;
+}
+
+
+template<class DataType>
+void FilterChain<DataType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+)
+{
+  // each tile goes through all the stages while it is still in cache
+  for(std::size_t start=0; start<n; start+=tile_size_) {
+    const std::size_t len = std::min(tile_size_, n - start);
+    if(x_in != y_out)
+      std::copy(x_in + start, x_in + start + len, y_out + start);
+    for(auto& stage : stages_)
+      stage->filter(y_out + start, len);
+  }
+}
+
+} // namespace digital_filters
@@ -0,0 +1,204 @@
+/** @file filter_fleet.hpp
+  * @brief Header file containing the FilterFleet class.
+  */
+#pragma once
+
+#include <digital_filters/filter.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace digital_filters {
+
+/// Large set of channels, each one filtered by one of a few shared designs.
+/** Each Filter owns its coefficients, its input/output histories, its state
+  * and some scratch buffers: several heap allocations and a few hundred
+  * bytes per instance, even when thousands of instances use the same
+  * design. A fleet instead stores:
+  * - each distinct design once (a flyweight): designs are interned when
+  *   added, so that adding the same coefficients twice returns the same
+  *   design, and they cannot be changed afterwards;
+  * - the state of all channels in a single arena, *i.e.*, one contiguous
+  *   buffer where the state of each channel takes exactly as many values as
+  *   the order of its design;
+  * - for each channel, only the index of its design and the position of its
+  *   state in the arena.
+  *
+  * Channels with different designs are filtered together, in a single sweep
+  * that walks the arena sequentially, while the coefficients of the designs
+  * stay in cache. Each channel uses a Direct Form II Transposed structure,
+  * as a FilterBank. Unlike in a bank, channels can have different designs;
+  * when they all share the same one, a FilterBank is faster since it
+  * processes several channels per SIMD instruction.
+  *
+  * Example:
+  * @code
+  * digital_filters::FilterFleet<float,double> fleet;
+  * fleet.reserve(100000, 400000);
+  * const auto slow = fleet.addDesign(digital_filters::butterworth<float,double>(4, 1., 100.));
+  * const auto fast = fleet.addDesign(digital_filters::butterworth<float,double>(4, 20., 100.));
+  * for(std::size_t c=0; c<100000; c++)
+  *   fleet.add(c % 10 == 0 ? fast : slow);
+  * fleet.filter(x.data(), y.data()); // one sample per channel
+  * @endcode
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the coefficients of the transfer function.
+  */
+template <class DataType, class CoeffType>
+class FilterFleet {
+public:
+  /// Type used to store the state and to accumulate products.
+  typedef typename Filter<DataType,CoeffType>::Accumulator Accumulator;
+
+  /// Creates an empty fleet.
+  FilterFleet() = default;
+
+  /// Adds a design, unless an identical one is already stored.
+  /** @param b_num Numerator of the discrete transfer function.
+    * @param a_den Denominator of the discrete transfer function.
+    * @return index of the design. Designs are compared after normalization,
+    *   hence scaled copies of the same transfer function share an index.
+    * @note An exception is thrown if the numerator or the denominator is
+    *   empty, or if the first denominator coefficient is zero.
+    */
+  std::size_t addDesign(
+    const std::vector<CoeffType>& b_num,
+    const std::vector<CoeffType>& a_den
+  );
+
+  /// Adds the design of a filter, unless an identical one is already stored.
+  /** @param design filter whose coefficients are copied. Its state and its
+    *   realization are ignored.
+    * @return index of the design.
+    */
+  std::size_t addDesign(
+    const Filter<DataType,CoeffType>& design
+  );
+
+  /// Adds a channel, with its state set to zero.
+  /** @param design index of the design of the channel, see addDesign().
+    * @return index of the channel. Channels are numbered in the order in
+    *   which they are added.
+    * @note An exception is thrown if the design does not exist.
+    */
+  std::size_t add(
+    std::size_t design
+  );
+
+  /// Reserve memory for channels added later on.
+  /** Adding channels within the reserved capacity does not allocate memory.
+    * @param channels total number of channels.
+    * @param states total number of state variables, *i.e.*, the sum of the
+    *   orders of all channels.
+    */
+  void reserve(
+    std::size_t channels,
+    std::size_t states
+  );
+
+  /// Number of channels in the fleet.
+  inline std::size_t channels() const { return channels_.size(); }
+
+  /// Number of distinct designs in the fleet.
+  inline std::size_t designs() const { return designs_.size(); }
+
+  /// Index of the design of a channel.
+  inline std::size_t design(std::size_t channel) const { return channels_[channel].design; }
+
+  /// Access the (normalized) numerator of a design.
+  inline const std::vector<CoeffType>& numerator(std::size_t design) const { return designs_[design].numerator; }
+
+  /// Access the (normalized) denominator of a design.
+  inline const std::vector<CoeffType>& denominator(std::size_t design) const { return designs_[design].denominator; }
+
+  /// Number of bytes allocated for the channels and their states.
+  /** Designs are not included, since they are shared by all channels.
+    */
+  std::size_t memoryUsage() const;
+
+  /// Set the state of all channels to zero.
+  void reset();
+
+  /// Set the state to the steady-state response to constant inputs.
+  /** @param input pointer to one value per channel. After calling this
+    *   method, filtering again the same values produces no transient.
+    * @note An exception is thrown if the design of a channel has a pole in
+    *   \f$ z=1 \f$. In this case, no state is modified.
+    */
+  void initSteadyState(
+    const DataType* input
+  );
+
+  /// Filter one sample of a single channel.
+  /** @param channel index of the channel.
+    * @param x current input of the channel.
+    * @return current output of the channel.
+    */
+  DataType filter(
+    std::size_t channel,
+    const DataType& x
+  );
+
+  /// Filter one sample per channel.
+  /** @param x_in pointer to one input sample per channel.
+    * @param y_out pointer to one output sample per channel. It can be equal
+    *   to `x_in`, in which case samples are filtered in-place.
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out
+  );
+
+  /// Filter multiple samples per channel.
+  /** @param x_in pointer to `frames*channels()` input samples. Channels are
+    *   interleaved, as in FilterBank::filter().
+    * @param y_out pointer to `frames*channels()` output samples, using the
+    *   same layout as the input. It can be equal to `x_in`.
+    * @param frames number of samples per channel.
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t frames
+  );
+
+private:
+  /// A stored design.
+  struct Design {
+    std::vector<CoeffType> numerator; ///< Normalized numerator.
+    std::vector<CoeffType> denominator; ///< Normalized denominator.
+    /// State for a unit input, empty if there is a pole in \f$ z=1 \f$.
+    std::vector<CoeffType> steady_state;
+    /// Position of the padded coefficients in `coefficients_`.
+    /** The numerator and the denominator are zero-padded to `order+1`
+      * coefficients and stored one after the other.
+      */
+    std::size_t offset;
+    std::size_t order; ///< Number of state variables.
+  };
+
+  /// Minimal description of a channel.
+  struct Channel {
+    std::uint32_t design; ///< Index of the design.
+    std::uint32_t state; ///< Position of the state in `state_`.
+  };
+
+  /// Filter the current input of a channel.
+  inline DataType step(
+    const Channel& channel,
+    const DataType& x
+  );
+
+  /// Index of each design, by normalized numerator and denominator.
+  std::map<std::pair<std::vector<CoeffType>,std::vector<CoeffType>>,std::size_t> index_;
+  std::vector<Design> designs_; ///< Distinct designs.
+  std::vector<CoeffType> coefficients_; ///< Padded coefficients of all designs.
+  std::vector<Channel> channels_; ///< All channels, in order.
+  std::vector<Accumulator> state_; ///< Arena containing the state of all channels.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/filter_fleet.hxx>
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <digital_filters/utilities.hpp>
+
+
+namespace digital_filters {
+
+template<class DataType, class CoeffType>
+std::size_t FilterFleet<DataType,CoeffType>::addDesign(
+  const std::vector<CoeffType>& b_num,
+  const std::vector<CoeffType>& a_den
+)
+{
+  // check sizes
+  if(b_num.size() == 0)
+    throw std::runtime_error("FilterFleet::addDesign: numerator (b) is empty");
+  if(a_den.size() == 0)
+    throw std::runtime_error("FilterFleet::addDesign: denominator (a) is empty");
+  if(a_den[0] == CoeffType(0))
+    throw std::runtime_error("FilterFleet::addDesign: the first denominator coefficient (a0) is zero");
+
+  // normalize numerator and denominator, then look for an identical design
+  Design design;
+  design.numerator = b_num;
+  design.denominator = a_den;
+  for(auto& bi : design.numerator)
+    bi = bi / a_den[0];
+  for(auto& ai : design.denominator)
+    ai = ai / a_den[0];
+  auto key = std::make_pair(design.numerator, design.denominator);
+  const auto found = index_.find(key);
+  if(found != index_.end())
+    return found->second;
+
+  // steady-state for a unit input, if defined
+  CoeffType Sa = design.denominator[0];
+  for(std::size_t i=1; i<design.denominator.size(); i++)
+    Sa = Sa + design.denominator[i];
+  if(Sa != CoeffType(0))
+    design.steady_state = steadyState(design.numerator, design.denominator);
+
+  // append the padded coefficients to the shared pool
+  design.order = std::max(b_num.size(), a_den.size()) - 1;
+  design.offset = coefficients_.size();
+  coefficients_.resize(design.offset + 2*(design.order+1), CoeffType(0));
+  std::copy(design.numerator.begin(), design.numerator.end(), coefficients_.begin() + design.offset);
+  std::copy(design.denominator.begin(), design.denominator.end(), coefficients_.begin() + design.offset + design.order + 1);
+
+  designs_.push_back(std::move(design));
+  index_.emplace(std::move(key), designs_.size()-1);
+  return designs_.size()-1;
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t FilterFleet<DataType,CoeffType>::addDesign(
+  const Filter<DataType,CoeffType>& design
+)
+{
+  return addDesign(design.numerator(), design.denominator());
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t FilterFleet<DataType,CoeffType>::add(
+  std::size_t design
+)
+{
+  if(design >= designs_.size()) {
+    throw std::runtime_error(
+      "FilterFleet::add: design " + std::to_string(design) + " does not "
+      "exist, the fleet has " + std::to_string(designs_.size()) + " designs"
+    );
+  }
+  // channels are described by 32-bit indices, to keep them small
+  const std::size_t order = designs_[design].order;
+  if(state_.size() + order > std::numeric_limits<std::uint32_t>::max())
+    throw std::runtime_error("FilterFleet::add: the state of the channels exceeds the maximum size of the arena");
+  channels_.push_back(Channel{static_cast<std::uint32_t>(design), static_cast<std::uint32_t>(state_.size())});
+  state_.resize(state_.size() + order, Accumulator());
+  return channels_.size()-1;
+}
+
+
+template<class DataType, class CoeffType>
+void FilterFleet<DataType,CoeffType>::reserve(
+  std::size_t channels,
+  std::size_t states
+)
+{
+  channels_.reserve(channels);
+  state_.reserve(states);
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t FilterFleet<DataType,CoeffType>::memoryUsage() const
+{
+  return channels_.capacity() * sizeof(Channel) + state_.capacity() * sizeof(Accumulator);
+}
+
+
+template<class DataType, class CoeffType>
+void FilterFleet<DataType,CoeffType>::reset()
+{
+  for(auto& z : state_)
+    z = Accumulator();
+}
+
+
+template<class DataType, class CoeffType>
+void FilterFleet<DataType,CoeffType>::initSteadyState(
+  const DataType* input
+)
+{
+  for(const auto& channel : channels_) {
+    const Design& design = designs_[channel.design];
+    if(design.steady_state.size() != design.order) {
+      throw std::runtime_error(
+        "FilterFleet::initSteadyState: a design has a pole in z=1, hence the "
+        "steady-state output is not defined"
+      );
+    }
+  }
+  for(std::size_t c=0; c<channels_.size(); c++) {
+    const auto& zi = designs_[channels_[c].design].steady_state;
+    Accumulator* z = state_.data() + channels_[c].state;
+    for(std::size_t i=0; i<zi.size(); i++)
+      z[i] = zi[i] * input[c];
+  }
+}
+
+
+template<class DataType, class CoeffType>
+DataType FilterFleet<DataType,CoeffType>::step(
+  const Channel& channel,
+  const DataType& x
+)
+{
+  const Design& design = designs_[channel.design];
+  const std::size_t ns = design.order;
+  const CoeffType* b = coefficients_.data() + design.offset;
+  const CoeffType* a = b + ns + 1;
+  Accumulator* z = state_.data() + channel.state;
+  Accumulator y = b[0] * x;
+  if(ns > 0) {
+    y = y + z[0];
+    for(std::size_t i=1; i<ns; i++)
+      z[i-1] = z[i] + b[i] * x - a[i] * y;
+    z[ns-1] = b[ns] * x - a[ns] * y;
+  }
+  return static_cast<DataType>(y);
+}
+
+
+template<class DataType, class CoeffType>
+DataType FilterFleet<DataType,CoeffType>::filter(
+  std::size_t channel,
+  const DataType& x
+)
+{
+  return step(channels_[channel], x);
+}
+
+
+template<class DataType, class CoeffType>
+void FilterFleet<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out
+)
+{
+  // states are allocated in the same order as the channels, hence the sweep
+  // reads the arena sequentially
+  const std::size_t n = channels_.size();
+  for(std::size_t c=0; c<n; c++)
+    y_out[c] = step(channels_[c], x_in[c]);
+}
+
+
+template<class DataType, class CoeffType>
+void FilterFleet<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t frames
+)
+{
+  const std::size_t n = channels_.size();
+  for(std::size_t k=0; k<frames; k++)
+    filter(x_in + k*n, y_out + k*n);
+}
+
+} // namespace digital_filters
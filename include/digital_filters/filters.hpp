@@ -2,6 +2,7 @@
 #include <digital_filters/filters_implementations/butterworth.hpp>
 #include <digital_filters/filters_implementations/average.hpp>
 #include <digital_filters/filters_implementations/exponential.hpp>
+#include <digital_filters/filters_implementations/derivatives.hpp>
 
 /** @defgroup CommonFilters Common Filters
   * @brief Set of functions that create commonly used filters.
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <digital_filters/filter.hpp>
+#include <digital_filters/fixed_filter.hpp>
+#include <digital_filters/moving_average.hpp>
 
 
 namespace digital_filters {
@@ -42,6 +44,58 @@ Filter<DataType,CoeffType> average(
   int window_size
 );
 
+
+/// Computes the numerator and denominator of an average filter.
+/** This overload can be evaluated at compile time. The size of the window is
+  * deduced from the size of the numerator.
+  */
+template <class CoeffType, std::size_t N>
+constexpr void average(
+  const CoeffType& gain,
+  std::array<CoeffType,N>& numerator,
+  std::array<CoeffType,1>& denominator
+);
+
+
+/// Computes the numerator and denominator of an average filter.
+/** This overload can be evaluated at compile time. The size of the window is
+  * deduced from the size of the numerator.
+  */
+template <class CoeffType, std::size_t N>
+constexpr void average(
+  std::array<CoeffType,N>& numerator,
+  std::array<CoeffType,1>& denominator
+);
+
+
+/// Returns an average filter with a fixed window size.
+/** @ingroup CommonFilters
+  */
+template <unsigned int WindowSize, class DataType, class CoeffType>
+constexpr FixedFilter<DataType,CoeffType,WindowSize,1> average(
+  const CoeffType& gain
+);
+
+
+/// Returns an average filter with a fixed window size.
+/** @ingroup CommonFilters
+  */
+template <unsigned int WindowSize, class DataType, class CoeffType>
+constexpr FixedFilter<DataType,CoeffType,WindowSize,1> average();
+
+
+/// Returns an average filter evaluated via a running sum.
+/** The returned filter has the same response of average(int,const CoeffType&),
+  * but its cost does not depend on the size of the window.
+  * @ingroup CommonFilters
+  */
+template <class DataType, class CoeffType>
+MovingAverage<DataType,CoeffType> movingAverage(
+  int window_size,
+  const CoeffType& gain = CoeffType(1),
+  Summation summation = Summation::Periodic
+);
+
 } // namespace digital_filters
 
 #include <digital_filters/filters_implementations/average.hxx>
@@ -48,4 +48,60 @@ Filter<DataType,CoeffType> average(
   return Filter<DataType,CoeffType>(num, den);
 }
 
+
+template <class CoeffType, std::size_t N>
+constexpr void average(
+  const CoeffType& gain,
+  std::array<CoeffType,N>& numerator,
+  std::array<CoeffType,1>& denominator
+)
+{
+  for(auto& n : numerator)
+    n = gain;
+  denominator[0] = static_cast<CoeffType>(N);
+}
+
+
+template <class CoeffType, std::size_t N>
+constexpr void average(
+  std::array<CoeffType,N>& numerator,
+  std::array<CoeffType,1>& denominator
+)
+{
+  average<CoeffType,N>(static_cast<CoeffType>(1), numerator, denominator);
+}
+
+
+template <unsigned int WindowSize, class DataType, class CoeffType>
+constexpr FixedFilter<DataType,CoeffType,WindowSize,1> average(
+  const CoeffType& gain
+)
+{
+  std::array<CoeffType,WindowSize> num{};
+  std::array<CoeffType,1> den{};
+  average<CoeffType,WindowSize>(gain, num, den);
+  return FixedFilter<DataType,CoeffType,WindowSize,1>(num, den);
+}
+
+
+template <unsigned int WindowSize, class DataType, class CoeffType>
+constexpr FixedFilter<DataType,CoeffType,WindowSize,1> average()
+{
+  std::array<CoeffType,WindowSize> num{};
+  std::array<CoeffType,1> den{};
+  average<CoeffType,WindowSize>(num, den);
+  return FixedFilter<DataType,CoeffType,WindowSize,1>(num, den);
+}
+
+
+template <class DataType, class CoeffType>
+MovingAverage<DataType,CoeffType> movingAverage(
+  int window_size,
+  const CoeffType& gain,
+  Summation summation
+)
+{
+  return MovingAverage<DataType,CoeffType>(window_size, gain, summation);
+}
+
 } // namespace digital_filters
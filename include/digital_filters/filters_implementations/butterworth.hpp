@@ -1,6 +1,9 @@
 #pragma once
 
 #include <digital_filters/filter.hpp>
+#include <digital_filters/fixed_filter.hpp>
+#include <digital_filters/sos_filter.hpp>
+#include <digital_filters/zero_pole_gain.hpp>
 
 
 namespace digital_filters {
@@ -26,6 +29,82 @@ Filter<DataType,CoeffType> butterworth(
   const CoeffType& sampling
 );
 
+
+/// Computes the zeros, poles and gain of a butterworth filter.
+/** All zeros are in \f$ z=-1 \f$, and the poles are the images of the ones
+  * of the analog prototype via the bilinear transform. The gain is such
+  * that the static gain of the filter is one.
+  * @param order order of the filter.
+  * @param cutoff cutoff frequency.
+  * @param sampling sampling frequency.
+  * @param[out] zpk zeros, poles and gain of the filter.
+  */
+template <class CoeffType>
+void butterworth(
+  unsigned int order,
+  const CoeffType& cutoff,
+  const CoeffType& sampling,
+  ZeroPoleGain<CoeffType>& zpk
+);
+
+
+/// Computes the second-order sections of a butterworth filter.
+/** Each section contains a pair of complex conjugate poles, except the last
+  * one which contains a single real pole if the order is odd. The static gain
+  * of every section is one.
+  * @param order order of the filter.
+  * @param cutoff cutoff frequency.
+  * @param sampling sampling frequency.
+  * @param[out] sections coefficients of the sections, in the format used by
+  *   SosFilter.
+  */
+template <class CoeffType>
+void butterworth(
+  unsigned int order,
+  const CoeffType& cutoff,
+  const CoeffType& sampling,
+  std::vector<std::array<CoeffType,6>>& sections
+);
+
+
+/// Returns a butterworth filter realized as a cascade of biquads.
+/** This is the recommended realization for high orders.
+  * @ingroup CommonFilters
+  */
+template <class DataType, class CoeffType>
+SosFilter<DataType,CoeffType> butterworthSos(
+  unsigned int order,
+  const CoeffType& cutoff,
+  const CoeffType& sampling
+);
+
+
+/// Computes the numerator and denominator of a butterworth filter.
+/** This overload can be evaluated at compile time. The order of the filter is
+  * deduced from the size of the arrays, *i.e.*, it equals `N-1`.
+  */
+template <class CoeffType, std::size_t N>
+constexpr void butterworth(
+  const CoeffType& cutoff,
+  const CoeffType& sampling,
+  std::array<CoeffType,N>& numerator,
+  std::array<CoeffType,N>& denominator
+);
+
+
+/// Returns a butterworth filter of fixed order.
+/** The design can be evaluated at compile time, *e.g.*:
+  * @code
+  * constexpr auto filter = butterworth<3,double,double>(10.0, 100.0);
+  * @endcode
+  * @ingroup CommonFilters
+  */
+template <unsigned int Order, class DataType, class CoeffType>
+constexpr FixedFilter<DataType,CoeffType,Order+1,Order+1> butterworth(
+  const CoeffType& cutoff,
+  const CoeffType& sampling
+);
+
 } // namespace digital_filters
 
 #include <digital_filters/filters_implementations/butterworth.hxx>
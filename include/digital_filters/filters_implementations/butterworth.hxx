@@ -15,63 +15,204 @@ void butterworth(
   std::vector<CoeffType>& numerator,
   std::vector<CoeffType>& denominator
 )
+{
+  // the numerator (1+z^-1)^N is expanded in closed form, while the poles
+  // are multiplied in-place
+  ZeroPoleGain<CoeffType> zpk;
+  butterworth(order, cutoff, sampling, zpk);
+  zpk2tf(zpk, numerator, denominator);
+
+  // normalize using the expanded coefficients, so that the static gain of
+  // the realized filter is one up to rounding errors
+  CoeffType Sn=numerator[0], Sd=denominator[0];
+  for(unsigned int i=1; i<numerator.size(); i++)
+    Sn = Sn + numerator[i];
+  for(unsigned int i=1; i<denominator.size(); i++)
+    Sd = Sd + denominator[i];
+  for(auto& n : numerator)
+    n = n * Sd / Sn;
+}
+
+
+template <class CoeffType>
+void butterworth(
+  unsigned int order,
+  const CoeffType& cutoff,
+  const CoeffType& sampling,
+  ZeroPoleGain<CoeffType>& zpk
+)
 {
   // check that the cutoff frequency is less than Nyquist's one
   if(cutoff*2 > sampling)
     throw std::runtime_error("In fuction butterworth: cutoff frequency should be less than half of sampling frequency");
 
-  // initialize num/den
-  numerator = std::vector<CoeffType>(1,1);
-  denominator = std::vector<CoeffType>(1,1);
+  zpk.zeros.assign(order, std::complex<CoeffType>(-1, 0));
+  zpk.poles.clear();
+  zpk.poles.reserve(order);
 
-  // If the order is one, this is not really a filter...
-  if(order == 0)
-    return;
+  // Evaluate recurring constants
+  const CoeffType gc = std::tan(M_PI*cutoff/sampling);
+  const CoeffType gc2 = gc*gc;
+
+  // complex conjugate poles: the analog pole s = gc*exp(j*theta) is mapped
+  // to z = (1+s)/(1-s), whose real part and magnitude are evaluated directly
+  for(unsigned int i=0; i<(order/2); i++) {
+    const CoeffType theta = (order+1+2*i)*M_PI/(2*order);
+    const CoeffType ci = 2*gc * std::cos(theta);
+    const CoeffType den = 1+gc2-ci;
+    const std::complex<CoeffType> p((1-gc2) / den, 2*gc*std::sin(theta) / den);
+    zpk.poles.push_back(p);
+    zpk.poles.push_back(std::conj(p));
+  }
+
+  // if 'order' is odd, add a single real pole
+  if(order % 2 > 0)
+    zpk.poles.push_back((1-gc)/(1+gc));
+
+  // unit static gain: H(1) = k 2^N / prod(1-p_i)
+  std::complex<CoeffType> prod(1, 0);
+  for(const auto& p : zpk.poles)
+    prod *= CoeffType(1) - p;
+  zpk.gain = prod.real() / std::pow(CoeffType(2), CoeffType(order));
+}
+
+
+template <class DataType, class CoeffType>
+Filter<DataType,CoeffType> butterworth(
+  unsigned int order,
+  const CoeffType& cutoff,
+  const CoeffType& sampling
+)
+{
+  std::vector<CoeffType> num, den;
+  butterworth<CoeffType>(order, cutoff, sampling, num, den);
+  return Filter<DataType,CoeffType>(num, den);
+}
+
+
+template <class CoeffType>
+void butterworth(
+  unsigned int order,
+  const CoeffType& cutoff,
+  const CoeffType& sampling,
+  std::vector<std::array<CoeffType,6>>& sections
+)
+{
+  // check that the cutoff frequency is less than Nyquist's one
+  if(cutoff*2 > sampling)
+    throw std::runtime_error("In fuction butterworth: cutoff frequency should be less than half of sampling frequency");
+
+  sections.clear();
+  sections.reserve((order+1)/2);
 
   // Evaluate recurring constants
   const CoeffType gc = std::tan(M_PI*cutoff/sampling);
   const CoeffType gc2 = gc*gc;
 
-  std::vector<CoeffType> di(3, 1);
-  std::vector<CoeffType> ni(2, 1);
+  // each pair of complex conjugate poles is paired with the zeros (1+z^-1)^2
+  for(unsigned int i=0; i<(order/2); i++) {
+    CoeffType ci = 2*gc * std::cos( (order+1+2*i)*M_PI/(2*order) );
+    CoeffType d1 = 2 * (gc2-1) / (1+gc2-ci);
+    CoeffType d2 = (1+gc2+ci) / (1+gc2-ci);
+    CoeffType g = (1+d1+d2) / 4;
+    sections.push_back({g, 2*g, g, 1, d1, d2});
+  }
+
+  // if 'order' is odd, add a single real pole, paired with (1+z^-1)
+  if(order % 2 > 0) {
+    CoeffType p = (gc-1)/(gc+1);
+    CoeffType g = (1+p) / 2;
+    sections.push_back({g, g, 0, 1, p, 0});
+  }
+}
+
 
-  // evaluate the numerator, which is simply (1+z^-1)^N
-  for(unsigned int i=0; i<order; i++)
-    numerator = polyProd(numerator, ni);
+template <class DataType, class CoeffType>
+SosFilter<DataType,CoeffType> butterworthSos(
+  unsigned int order,
+  const CoeffType& cutoff,
+  const CoeffType& sampling
+)
+{
+  std::vector<std::array<CoeffType,6>> sections;
+  butterworth<CoeffType>(order, cutoff, sampling, sections);
+  return SosFilter<DataType,CoeffType>(sections);
+}
+
+
+template <class CoeffType, std::size_t N>
+constexpr void butterworth(
+  const CoeffType& cutoff,
+  const CoeffType& sampling,
+  std::array<CoeffType,N>& numerator,
+  std::array<CoeffType,N>& denominator
+)
+{
+  static_assert(N > 0, "In function butterworth: arrays must not be empty");
+  const unsigned int order = N-1;
+
+  // check that the cutoff frequency is less than Nyquist's one
+  if(cutoff*2 > sampling)
+    throw std::runtime_error("In fuction butterworth: cutoff frequency should be less than half of sampling frequency");
+
+  // The numerator is (1+z^-1)^N, whose coefficients are binomial ones; the
+  // denominator is initialized to 1 and multiplied in-place by each factor
+  numerator[0] = 1;
+  denominator[0] = 1;
+  for(unsigned int i=1; i<N; i++) {
+    numerator[i] = numerator[i-1] * (order-i+1) / i;
+    denominator[i] = 0;
+  }
+
+  // If the order is one, this is not really a filter...
+  if(order == 0)
+    return;
+
+  // Evaluate recurring constants
+  const CoeffType pi = static_cast<CoeffType>(M_PI);
+  const CoeffType gc = constexprTan(pi*cutoff/sampling);
+  const CoeffType gc2 = gc*gc;
+  unsigned int degree = 0;
 
   // evaluate complex conjugate poles
   for(unsigned int i=0; i<(order/2); i++) {
-    CoeffType ci = 2*gc * std::cos( (order+1+2*i)*M_PI/(2*order) );
-    di[1] = 2 * (gc2-1) / (1+gc2-ci);
-    di[2] = (1+gc2+ci) / (1+gc2-ci);
-    denominator = polyProd(denominator, di);
+    CoeffType ci = 2*gc * constexprCos( (order+1+2*i)*pi/(2*order) );
+    CoeffType d1 = 2 * (gc2-1) / (1+gc2-ci);
+    CoeffType d2 = (1+gc2+ci) / (1+gc2-ci);
+    degree += 2;
+    for(unsigned int j=degree; j>=2; j--)
+      denominator[j] = denominator[j] + d1 * denominator[j-1] + d2 * denominator[j-2];
+    denominator[1] = denominator[1] + d1 * denominator[0];
   }
 
   // if 'order' is odd, add a single real pole
-  if(order % 2 > 0)
-    denominator = polyProd(denominator, std::vector<CoeffType>{1, (gc-1)/(gc+1)});
+  if(order % 2 > 0) {
+    CoeffType p = (gc-1)/(gc+1);
+    degree += 1;
+    for(unsigned int j=degree; j>=1; j--)
+      denominator[j] = denominator[j] + p * denominator[j-1];
+  }
 
   // normalize
   CoeffType Sn=numerator[0], Sd=denominator[0];
-  for(unsigned int i=1; i<numerator.size(); i++)
+  for(unsigned int i=1; i<N; i++) {
     Sn = Sn + numerator[i];
-  for(unsigned int i=1; i<denominator.size(); i++)
     Sd = Sd + denominator[i];
+  }
   for(auto& n : numerator)
     n = n * Sd / Sn;
 }
 
 
-template <class DataType, class CoeffType>
-Filter<DataType,CoeffType> butterworth(
-  unsigned int order,
+template <unsigned int Order, class DataType, class CoeffType>
+constexpr FixedFilter<DataType,CoeffType,Order+1,Order+1> butterworth(
   const CoeffType& cutoff,
   const CoeffType& sampling
 )
 {
-  std::vector<CoeffType> num, den;
-  butterworth<CoeffType>(order, cutoff, sampling, num, den);
-  return Filter<DataType,CoeffType>(num, den);
+  std::array<CoeffType,Order+1> num{}, den{};
+  butterworth(cutoff, sampling, num, den);
+  return FixedFilter<DataType,CoeffType,Order+1,Order+1>(num, den);
 }
 
 } // namespace digital_filters
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <digital_filters/filter.hpp>
+#include <vector>
+#include <cstddef>
+
+
+namespace digital_filters {
+
+/// Coefficients of a Savitzky-Golay filter, for unit sampling time.
+/** The coefficients are evaluated once per combination of parameters, and
+  * then stored in a global table. The table is protected by a mutex, so that
+  * designs can be requested from multiple threads.
+  * @param window_size number of samples in the window. It must be odd.
+  * @param polyorder degree of the fitted polynomial. It must be smaller than
+  *   `window_size`.
+  * @param derivative order of the derivative, zero for smoothing. It cannot
+  *   be larger than `polyorder`.
+  * @return the coefficient of each sample in the window, from the oldest to
+  *   the newest one, *i.e.*, the coefficient of the center of the window is
+  *   the element `(window_size-1)/2`. The reference remains valid until the
+  *   end of the program.
+  * @note An exception is thrown if the parameters are not valid.
+  */
+template <class CoeffType>
+const std::vector<CoeffType>& savitzkyGolayCoefficients(
+  unsigned int window_size,
+  unsigned int polyorder,
+  unsigned int derivative
+);
+
+
+/// Computes the numerator and denominator of a Savitzky-Golay filter.
+/** A Savitzky-Golay filter fits, in the least-squares sense, a polynomial of
+  * degree `polyorder` to the last `window_size` samples, and returns the
+  * value (or a derivative) of the polynomial at the center of the window.
+  * Hence, the output is delayed by `(window_size-1)/2` samples, and it is
+  * exact for polynomial signals up to degree `polyorder`.
+  * @param[in] window_size number of samples in the window. It must be odd.
+  * @param[in] polyorder degree of the fitted polynomial. It must be smaller
+  *   than `window_size`.
+  * @param[in] derivative order of the derivative, zero for smoothing. It
+  *   cannot be larger than `polyorder`.
+  * @param[in] sampling_time sampling time, used to scale derivatives.
+  * @param[out] numerator numerator of the transfer function.
+  * @param[out] denominator denominator of the transfer function.
+  * @note An exception is thrown if the parameters are not valid.
+  * @see savitzkyGolayCoefficients()
+  */
+template <class CoeffType>
+void savitzkyGolay(
+  unsigned int window_size,
+  unsigned int polyorder,
+  unsigned int derivative,
+  const CoeffType& sampling_time,
+  std::vector<CoeffType>& numerator,
+  std::vector<CoeffType>& denominator
+);
+
+
+/// Returns a Savitzky-Golay smoothing or differentiating filter.
+/** @ingroup CommonFilters
+  * @see savitzkyGolay(unsigned int, unsigned int, unsigned int, const CoeffType&, std::vector<CoeffType>&, std::vector<CoeffType>&)
+  */
+template <class DataType, class CoeffType>
+Filter<DataType,CoeffType> savitzkyGolay(
+  unsigned int window_size,
+  unsigned int polyorder,
+  unsigned int derivative = 0,
+  const CoeffType& sampling_time = CoeffType(1)
+);
+
+
+/// Savitzky-Golay filter that returns a smoothed signal and its derivatives.
+/** Each call to filter(const DataType&) fits a polynomial to the last
+  * `windowSize()` samples and returns its value and its first `derivatives()`
+  * derivatives at the center of the window, *i.e.*, with a delay of
+  * `delay()` samples.
+  *
+  * The coefficients of even derivatives are symmetric with respect to the
+  * center of the window, and those of odd derivatives are antisymmetric.
+  * Hence, the sums and the differences of the samples that are symmetric
+  * with respect to the center are evaluated once, and shared by all the
+  * outputs: each output costs about half of the multiplications of the
+  * equivalent FIR filter. No memory is allocated while filtering.
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the coefficients of the filter.
+  */
+template <class DataType, class CoeffType>
+class SavitzkyGolay {
+public:
+  /// Creates a filter.
+  /** @param window_size number of samples in the window. It must be odd.
+    * @param polyorder degree of the fitted polynomial.
+    * @param derivatives number of derivatives to be evaluated, in addition
+    *   to the smoothed signal. It cannot be larger than `polyorder`.
+    * @param sampling_time sampling time, used to scale derivatives.
+    * @note An exception is thrown if the parameters are not valid.
+    */
+  SavitzkyGolay(
+    unsigned int window_size,
+    unsigned int polyorder,
+    unsigned int derivatives = 1,
+    const CoeffType& sampling_time = CoeffType(1)
+  );
+
+  /// Number of samples in the window.
+  inline unsigned int windowSize() const { return 2*half_ + 1; }
+
+  /// Degree of the fitted polynomial.
+  inline unsigned int polyorder() const { return polyorder_; }
+
+  /// Number of evaluated derivatives.
+  inline unsigned int derivatives() const { return derivatives_; }
+
+  /// Delay, in samples, between the inputs and the outputs.
+  inline unsigned int delay() const { return half_; }
+
+  /// Impulse response of the filter that evaluates the given derivative.
+  /** @param derivative order of the derivative, up to derivatives().
+    * @return the numerator of the equivalent FIR filter, for which
+    *   `savitzkyGolay(windowSize(), polyorder(), derivative, sampling_time)`
+    *   can be used as well.
+    */
+  std::vector<CoeffType> coefficients(
+    unsigned int derivative
+  ) const;
+
+  /// Fill the window with a constant value.
+  /** The smoothed signal is then equal to `x`, and all derivatives are
+    * zero.
+    */
+  void initInput(
+    const DataType& x
+  );
+
+  /// Filter the current input.
+  /** @param x new input sample.
+    * @return the smoothed signal followed by its derivatives, delayed by
+    *   delay() samples. The vector has `derivatives()+1` elements.
+    */
+  const std::vector<DataType>& filter(
+    const DataType& x
+  );
+
+  /// Filter a block of samples.
+  /** @param x_in pointer to `n` input samples.
+    * @param y_out pointer to `n*(derivatives()+1)` output samples: the
+    *   outputs of each input are stored contiguously, as returned by
+    *   filter(const DataType&).
+    * @param n number of samples in the block.
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  );
+
+private:
+  unsigned int half_; ///< Half of the window, rounded down.
+  unsigned int polyorder_; ///< Degree of the fitted polynomial.
+  unsigned int derivatives_; ///< Number of derivatives.
+  /// Half of the coefficients of each output.
+  /** The coefficient that multiplies the samples at distance \f$ j \f$ from
+    * the center for the derivative \f$ d \f$ is stored in
+    * `weights_[d*(half_+1)+j]`, for \f$ j = 0, \cdots, \f$ `half_`.
+    */
+  std::vector<CoeffType> weights_;
+  std::vector<DataType> history_; ///< Mirrored ring buffer of past inputs.
+  std::size_t head_; ///< Position of the most recent input in `history_`.
+  std::vector<DataType> sums_; ///< Symmetric sums of the window.
+  std::vector<DataType> differences_; ///< Antisymmetric differences.
+  std::vector<DataType> y_; ///< Latest outputs.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/filters_implementations/derivatives.hxx>
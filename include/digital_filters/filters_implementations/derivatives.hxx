@@ -0,0 +1,240 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <algorithm>
+
+namespace digital_filters {
+
+template <class CoeffType>
+const std::vector<CoeffType>& savitzkyGolayCoefficients(
+  unsigned int window_size,
+  unsigned int polyorder,
+  unsigned int derivative
+)
+{
+  if(window_size % 2 == 0 || polyorder >= window_size || derivative > polyorder) {
+    throw std::runtime_error(
+      "savitzkyGolayCoefficients: invalid parameters (window " +
+      std::to_string(window_size) + ", polyorder " + std::to_string(polyorder) +
+      ", derivative " + std::to_string(derivative) + "); the window must be " +
+      "odd and larger than the polyorder, which cannot be smaller than the derivative"
+    );
+  }
+
+  static std::mutex mutex;
+  static std::map<std::tuple<unsigned int,unsigned int,unsigned int>,std::vector<CoeffType>> table;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& c = table[std::make_tuple(window_size, polyorder, derivative)];
+  if(!c.empty())
+    return c;
+
+  // Least-squares fit of a polynomial in s = t/m, for the positions
+  // t = -m, ..., m. With J the Vandermonde matrix, the coefficients of the
+  // polynomial are (J^T J)^-1 J^T x, and the derivative at the center is the
+  // row `derivative` of this matrix, times derivative!/m^derivative.
+  const int m = (window_size - 1) / 2;
+  const unsigned int P = polyorder + 1;
+  const CoeffType scale = m > 0 ? CoeffType(m) : CoeffType(1);
+  std::vector<CoeffType> A(P*P, CoeffType(0)), u(P, CoeffType(0));
+  for(int t=-m; t<=m; t++) {
+    const CoeffType s = t / scale;
+    for(unsigned int j=0; j<P; j++)
+      for(unsigned int l=0; l<P; l++)
+        A[j*P+l] += std::pow(s, CoeffType(j+l));
+  }
+  u[derivative] = 1;
+
+  // solve A u = e_d via Gaussian elimination with partial pivoting
+  for(unsigned int col=0; col<P; col++) {
+    unsigned int pivot = col;
+    for(unsigned int r=col+1; r<P; r++)
+      if(std::abs(A[r*P+col]) > std::abs(A[pivot*P+col]))
+        pivot = r;
+    if(pivot != col) {
+      for(unsigned int l=0; l<P; l++)
+        std::swap(A[col*P+l], A[pivot*P+l]);
+      std::swap(u[col], u[pivot]);
+    }
+    for(unsigned int r=col+1; r<P; r++) {
+      const CoeffType f = A[r*P+col] / A[col*P+col];
+      for(unsigned int l=col; l<P; l++)
+        A[r*P+l] -= f * A[col*P+l];
+      u[r] -= f * u[col];
+    }
+  }
+  for(unsigned int col=P; col-->0; ) {
+    for(unsigned int l=col+1; l<P; l++)
+      u[col] -= A[col*P+l] * u[l];
+    u[col] /= A[col*P+col];
+  }
+
+  CoeffType factor = 1;
+  for(unsigned int d=2; d<=derivative; d++)
+    factor *= d;
+  factor /= std::pow(scale, CoeffType(derivative));
+
+  c.resize(window_size);
+  for(int t=-m; t<=m; t++) {
+    const CoeffType s = t / scale;
+    CoeffType value = 0;
+    for(unsigned int j=P; j-->0; )
+      value = value * s + u[j];
+    c[t+m] = factor * value;
+  }
+  return c;
+}
+
+
+template <class CoeffType>
+void savitzkyGolay(
+  unsigned int window_size,
+  unsigned int polyorder,
+  unsigned int derivative,
+  const CoeffType& sampling_time,
+  std::vector<CoeffType>& numerator,
+  std::vector<CoeffType>& denominator
+)
+{
+  const auto& c = savitzkyGolayCoefficients<CoeffType>(window_size, polyorder, derivative);
+  const CoeffType scale = std::pow(sampling_time, CoeffType(derivative));
+  // the newest sample, which multiplies the first coefficient of the
+  // numerator, is the last of the window
+  numerator.resize(c.size());
+  for(std::size_t i=0; i<c.size(); i++)
+    numerator[i] = c[c.size()-1-i] / scale;
+  denominator = {CoeffType(1)};
+}
+
+
+template <class DataType, class CoeffType>
+Filter<DataType,CoeffType> savitzkyGolay(
+  unsigned int window_size,
+  unsigned int polyorder,
+  unsigned int derivative,
+  const CoeffType& sampling_time
+)
+{
+  std::vector<CoeffType> num, den;
+  savitzkyGolay<CoeffType>(window_size, polyorder, derivative, sampling_time, num, den);
+  return Filter<DataType,CoeffType>(num, den);
+}
+
+
+template <class DataType, class CoeffType>
+SavitzkyGolay<DataType,CoeffType>::SavitzkyGolay(
+  unsigned int window_size,
+  unsigned int polyorder,
+  unsigned int derivatives,
+  const CoeffType& sampling_time
+)
+: half_(0)
+, polyorder_(polyorder)
+, derivatives_(derivatives)
+, head_(0)
+{
+  // validate the parameters before allocating memory
+  savitzkyGolayCoefficients<CoeffType>(window_size, polyorder, derivatives);
+  half_ = (window_size - 1) / 2;
+  weights_.resize((derivatives_ + 1) * (half_ + 1));
+  history_.resize(2*window_size, DataType(0));
+  sums_.resize(half_ + 1);
+  differences_.resize(half_ + 1);
+  y_.resize(derivatives_ + 1);
+
+  for(unsigned int d=0; d<=derivatives_; d++) {
+    const auto& c = savitzkyGolayCoefficients<CoeffType>(window_size, polyorder, d);
+    const CoeffType scale = std::pow(sampling_time, CoeffType(d));
+    // coefficients of the positions 0, ..., half_ from the center; the
+    // other half follows by (anti)symmetry
+    for(unsigned int j=0; j<=half_; j++)
+      weights_[d*(half_+1)+j] = c[half_+j] / scale;
+  }
+}
+
+
+template <class DataType, class CoeffType>
+std::vector<CoeffType> SavitzkyGolay<DataType,CoeffType>::coefficients(
+  unsigned int derivative
+) const
+{
+  if(derivative > derivatives_)
+    throw std::runtime_error("SavitzkyGolay::coefficients: the derivative " + std::to_string(derivative) + " is not evaluated by this filter");
+  const CoeffType* w = &weights_[derivative*(half_+1)];
+  const CoeffType sign = derivative % 2 == 0 ? CoeffType(1) : CoeffType(-1);
+  // the first coefficient multiplies the newest sample, at distance +half_
+  std::vector<CoeffType> h(windowSize());
+  for(unsigned int j=0; j<=half_; j++) {
+    h[half_-j] = w[j];
+    h[half_+j] = j == 0 ? w[0] : sign * w[j];
+  }
+  return h;
+}
+
+
+template <class DataType, class CoeffType>
+void SavitzkyGolay<DataType,CoeffType>::initInput(
+  const DataType& x
+)
+{
+  std::fill(history_.begin(), history_.end(), x);
+}
+
+
+template <class DataType, class CoeffType>
+const std::vector<DataType>& SavitzkyGolay<DataType,CoeffType>::filter(
+  const DataType& x
+)
+{
+  // store the new input (twice, since the buffer is mirrored)
+  const std::size_t W = windowSize();
+  head_ = (head_ == 0 ? W : head_) - 1;
+  history_[head_] = x;
+  history_[head_+W] = x;
+
+  // xk[half_-j] is at distance +j from the center, xk[half_+j] at -j
+  const DataType* xk = &history_[head_];
+  const DataType center = xk[half_];
+  for(unsigned int j=1; j<=half_; j++) {
+    sums_[j] = xk[half_-j] + xk[half_+j];
+    differences_[j] = xk[half_-j] - xk[half_+j];
+  }
+
+  for(unsigned int d=0; d<=derivatives_; d++) {
+    const CoeffType* w = &weights_[d*(half_+1)];
+    if(d % 2 == 0) {
+      DataType acc = w[0] * center;
+      for(unsigned int j=1; j<=half_; j++)
+        acc = acc + w[j] * sums_[j];
+      y_[d] = acc;
+    }
+    else {
+      DataType acc = DataType(0);
+      for(unsigned int j=1; j<=half_; j++)
+        acc = acc + w[j] * differences_[j];
+      y_[d] = acc;
+    }
+  }
+  return y_;
+}
+
+
+template <class DataType, class CoeffType>
+void SavitzkyGolay<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+)
+{
+  const std::size_t outputs = derivatives_ + 1;
+  for(std::size_t k=0; k<n; k++) {
+    const auto& y = filter(x_in[k]);
+    std::copy(y.begin(), y.end(), y_out + k*outputs);
+  }
+}
+
+} // namespace digital_filters
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <digital_filters/filter.hpp>
+#include <digital_filters/fixed_filter.hpp>
 
 
 namespace digital_filters {
@@ -61,6 +62,54 @@ Filter<DataType,CoeffType> exponential(
   const CoeffType& time_constant
 );
 
+
+/// Computes the numerator and denominator of an exponential filter.
+/** This overload can be evaluated at compile time.
+  * @see exponential(const CoeffType&, std::vector<CoeffType>&, std::vector<CoeffType>&)
+  */
+template <class CoeffType>
+constexpr void exponential(
+  const CoeffType& alpha,
+  std::array<CoeffType,1>& numerator,
+  std::array<CoeffType,2>& denominator
+);
+
+
+/// Computes the numerator and denominator of an exponential filter.
+/** This overload can be evaluated at compile time.
+  * @see exponential(const CoeffType&, const CoeffType&, std::vector<CoeffType>&, std::vector<CoeffType>&)
+  */
+template <class CoeffType>
+constexpr void exponential(
+  const CoeffType& sampling,
+  const CoeffType& time_constant,
+  std::array<CoeffType,1>& numerator,
+  std::array<CoeffType,2>& denominator
+);
+
+
+/// Returns an exponential filter whose order is known at compile time.
+/** Differently from butterworth() and average(), the size of an exponential
+  * filter is always the same, and it cannot be used to distinguish this
+  * function from exponential(): hence the different name.
+  * @ingroup CommonFilters
+  */
+template <class DataType, class CoeffType>
+constexpr FixedFilter<DataType,CoeffType,1,2> fixedExponential(
+  const CoeffType& alpha
+);
+
+
+/// Returns an exponential filter whose order is known at compile time.
+/** @ingroup CommonFilters
+  * @see fixedExponential(const CoeffType&)
+  */
+template <class DataType, class CoeffType>
+constexpr FixedFilter<DataType,CoeffType,1,2> fixedExponential(
+  const CoeffType& sampling,
+  const CoeffType& time_constant
+);
+
 } // namespace digital_filters
 
 #include <digital_filters/filters_implementations/exponential.hxx>
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <digital_filters/utilities.hpp>
 #include <cmath>
 
 
@@ -53,4 +54,54 @@ Filter<DataType,CoeffType> exponential(
   return Filter<DataType,CoeffType>(num, den);
 }
 
+
+template <class CoeffType>
+constexpr void exponential(
+  const CoeffType& alpha,
+  std::array<CoeffType,1>& numerator,
+  std::array<CoeffType,2>& denominator
+)
+{
+  numerator[0] = alpha;
+  denominator[0] = 1;
+  denominator[1] = alpha-1;
+}
+
+
+template <class CoeffType>
+constexpr void exponential(
+  const CoeffType& sampling,
+  const CoeffType& time_constant,
+  std::array<CoeffType,1>& numerator,
+  std::array<CoeffType,2>& denominator
+)
+{
+  exponential<CoeffType>(1-constexprExp(-sampling/time_constant), numerator, denominator);
+}
+
+
+template <class DataType, class CoeffType>
+constexpr FixedFilter<DataType,CoeffType,1,2> fixedExponential(
+  const CoeffType& alpha
+)
+{
+  std::array<CoeffType,1> num{};
+  std::array<CoeffType,2> den{};
+  exponential<CoeffType>(alpha, num, den);
+  return FixedFilter<DataType,CoeffType,1,2>(num, den);
+}
+
+
+template <class DataType, class CoeffType>
+constexpr FixedFilter<DataType,CoeffType,1,2> fixedExponential(
+  const CoeffType& sampling,
+  const CoeffType& time_constant
+)
+{
+  std::array<CoeffType,1> num{};
+  std::array<CoeffType,2> den{};
+  exponential<CoeffType>(sampling, time_constant, num, den);
+  return FixedFilter<DataType,CoeffType,1,2>(num, den);
+}
+
 } // namespace digital_filters
@@ -0,0 +1,111 @@
+/** @file fixed_filter.hpp
+  * @brief Header file containing the FixedFilter class.
+  */
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace digital_filters {
+
+/// Digital filter whose order is known at compile time.
+/** This class behaves like Filter, but coefficients and internal buffers are
+  * stored in `std::array` instances whose sizes are template parameters. This
+  * means that no heap memory is used and that all loops have a fixed number of
+  * iterations, which allows the compiler to fully unroll them. In addition,
+  * all methods are `constexpr`, so that filters with known parameters can be
+  * designed at compile time.
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the coefficients of the transfer function.
+  * @tparam NB Size of the numerator.
+  * @tparam NA Size of the denominator.
+  */
+template <class DataType, class CoeffType, std::size_t NB, std::size_t NA>
+class FixedFilter {
+  static_assert(NB > 0, "FixedFilter: numerator (b) is empty");
+  static_assert(NA > 0, "FixedFilter: denominator (a) is empty");
+public:
+  /// Generates a filter from given coefficients.
+  /** The denominator will be normalized internally, see Filter::Filter() for
+    * details.
+    * @param b_num Numerator of the discrete transfer function. Entries should
+    *   be ordered such that `b_num[i]` contains \f$ b_i \f$.
+    * @param a_den Denominator of the discrete transfer function. Entries should
+    *   be ordered such that `a_den[i]` contains \f$ a_i \f$. Note that the
+    *   first element must not be zero.
+    */
+  constexpr FixedFilter(
+    const std::array<CoeffType,NB>& b_num,
+    const std::array<CoeffType,NA>& a_den
+  );
+
+  /// Change filter template types.
+  /** @tparam OtherDataType new type of the input/output signals.
+    * @tparam OtherCoeffType new type of the coefficients.
+    * @return A new filter which is a copy of the current one, including its
+    *   internal state, but with different template types.
+    * @note To perform the conversion, `static_cast` is used. Make sure that
+    *   this is not an issue for your datatypes.
+    */
+  template <class OtherDataType, class OtherCoeffType>
+  constexpr FixedFilter<OtherDataType,OtherCoeffType,NB,NA> as() const;
+
+  /// Access the numerator.
+  constexpr const std::array<CoeffType,NB>& numerator() const { return b_; }
+
+  /// Access the denominator.
+  constexpr const std::array<CoeffType,NA>& denominator() const { return a_; }
+
+  /// Set initial conditions on the input.
+  /** @param input value to be used to initialize all past input samples.
+    * @see Filter::initInput(const DataType&)
+    */
+  constexpr void initInput(
+    const DataType& input
+  );
+
+  /// Set initial conditions on the input.
+  /** @param input values \f$ \cdots, x_{k-2}, x_{k-1} \f$, sorted in
+    *   time-ascending order.
+    * @see Filter::initInput(const std::vector<DataType>&)
+    */
+  constexpr void initInput(
+    const std::array<DataType,NB-1>& input
+  );
+
+  /// Set initial conditions on the output.
+  /** @param output value to be used to initialize all past output samples.
+    * @see Filter::initOutput(const DataType&)
+    */
+  constexpr void initOutput(
+    const DataType& output
+  );
+
+  /// Set initial conditions on the output.
+  /** @param output values \f$ \cdots, y_{k-2}, y_{k-1} \f$, sorted in
+    *   time-ascending order.
+    * @see Filter::initOutput(const std::vector<DataType>&)
+    */
+  constexpr void initOutput(
+    const std::array<DataType,NA-1>& output
+  );
+
+  /// Filter the current input.
+  constexpr const DataType& filter(
+    const DataType& x
+  );
+
+private:
+  // Allow conversions between filters with different template types.
+  template <class OtherDataType, class OtherCoeffType, std::size_t OtherNB, std::size_t OtherNA>
+  friend class FixedFilter;
+
+  std::array<CoeffType,NB> b_; ///< Numerator of the transfer function.
+  std::array<CoeffType,NA> a_; ///< Denominator of the transfer function.
+  std::array<DataType,NB> in_; ///< Input samples, most recent first.
+  std::array<DataType,NA> out_; ///< Output samples, most recent first.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/fixed_filter.hxx>
@@ -0,0 +1,109 @@
+#pragma once
+
+
+namespace digital_filters {
+
+template<class DataType, class CoeffType, std::size_t NB, std::size_t NA>
+constexpr FixedFilter<DataType,CoeffType,NB,NA>::FixedFilter(
+  const std::array<CoeffType,NB>& b_num,
+  const std::array<CoeffType,NA>& a_den
+)
+: b_(b_num)
+, a_(a_den)
+, in_()
+, out_()
+{
+  // normalize numerator and denominator
+  for(std::size_t i=0; i<NB; i++)
+    b_[i] = b_[i] / a_den[0];
+  for(std::size_t i=0; i<NA; i++)
+    a_[i] = a_[i] / a_den[0];
+}
+
+
+template<class DataType, class CoeffType, std::size_t NB, std::size_t NA>
+template<class OtherDataType, class OtherCoeffType>
+constexpr FixedFilter<OtherDataType,OtherCoeffType,NB,NA> FixedFilter<DataType,CoeffType,NB,NA>::as() const
+{
+  // copy-convert numerator and denominator
+  std::array<OtherCoeffType,NB> b{};
+  std::array<OtherCoeffType,NA> a{};
+  for(std::size_t i=0; i<NB; i++)
+    b[i] = static_cast<OtherCoeffType>(b_[i]);
+  for(std::size_t i=0; i<NA; i++)
+    a[i] = static_cast<OtherCoeffType>(a_[i]);
+  // create new filter and copy-convert its state
+  FixedFilter<OtherDataType,OtherCoeffType,NB,NA> filter(b, a);
+  for(std::size_t i=0; i<NB; i++)
+    filter.in_[i] = static_cast<OtherDataType>(in_[i]);
+  for(std::size_t i=0; i<NA; i++)
+    filter.out_[i] = static_cast<OtherDataType>(out_[i]);
+  return filter;
+}
+
+
+template<class DataType, class CoeffType, std::size_t NB, std::size_t NA>
+constexpr void FixedFilter<DataType,CoeffType,NB,NA>::initInput(
+  const DataType& input
+)
+{
+  for(auto& val : in_)
+    val = input;
+}
+
+
+template<class DataType, class CoeffType, std::size_t NB, std::size_t NA>
+constexpr void FixedFilter<DataType,CoeffType,NB,NA>::initInput(
+  const std::array<DataType,NB-1>& input
+)
+{
+  for(std::size_t i=0; i<NB-1; i++)
+    in_[i] = input[NB-i-2];
+}
+
+
+template<class DataType, class CoeffType, std::size_t NB, std::size_t NA>
+constexpr void FixedFilter<DataType,CoeffType,NB,NA>::initOutput(
+  const DataType& output
+)
+{
+  for(auto& val : out_)
+    val = output;
+}
+
+
+template<class DataType, class CoeffType, std::size_t NB, std::size_t NA>
+constexpr void FixedFilter<DataType,CoeffType,NB,NA>::initOutput(
+  const std::array<DataType,NA-1>& output
+)
+{
+  for(std::size_t i=0; i<NA-1; i++)
+    out_[i] = output[NA-i-2];
+}
+
+
+template<class DataType, class CoeffType, std::size_t NB, std::size_t NA>
+constexpr const DataType& FixedFilter<DataType,CoeffType,NB,NA>::filter(
+  const DataType& x
+)
+{
+  // shift past inputs/outputs; sizes are known, so these loops are unrolled
+  for(std::size_t i=NB-1; i>0; i--)
+    in_[i] = in_[i-1];
+  for(std::size_t i=NA-1; i>0; i--)
+    out_[i] = out_[i-1];
+
+  // add new input/output
+  in_[0] = x;
+  DataType y = x * b_[0];
+
+  // complete the filtering
+  for(std::size_t i=1; i<NB; i++)
+    y = y + b_[i] * in_[i];
+  for(std::size_t i=1; i<NA; i++)
+    y = y - a_[i] * out_[i];
+  out_[0] = y;
+  return out_[0];
+}
+
+} // namespace digital_filters
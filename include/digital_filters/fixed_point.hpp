@@ -0,0 +1,100 @@
+/** @file fixed_point.hpp
+  * @brief Header file containing the FixedPoint class.
+  */
+#pragma once
+
+#include <cstdint>
+
+namespace digital_filters {
+
+/// Signed fixed-point number with saturating arithmetic.
+/** A value \f$ v \f$ is stored as the integer \f$ r = v \cdot 2^F \f$, with
+  * \f$ F \f$ being the number of fractional bits. All operations saturate,
+  * *i.e.*, results that cannot be represented are clamped to the closest
+  * representable value instead of wrapping around. Products are rounded to
+  * the nearest representable value.
+  *
+  * The class has the same size and layout as its raw integer, so that arrays
+  * of fixed-point numbers can be processed as arrays of integers. The most
+  * common formats are available as Q15 and Q31.
+  * @tparam Raw signed integer type used to store the value.
+  * @tparam Wide signed integer type with (at least) twice as many bits as
+  *   `Raw`, used to evaluate intermediate results.
+  * @tparam FractionalBits number of fractional bits.
+  */
+template <class Raw, class Wide, unsigned int FractionalBits>
+class FixedPoint {
+public:
+  typedef Raw RawType; ///< Integer type used to store the value.
+  typedef Wide WideType; ///< Integer type used for intermediate results.
+  /// Number of fractional bits.
+  static constexpr unsigned int fractional_bits = FractionalBits;
+
+  /// Creates a number equal to zero.
+  constexpr FixedPoint() : raw_(0) {}
+
+  /// Converts a floating point value, rounding and saturating it.
+  explicit constexpr FixedPoint(
+    double value
+  );
+
+  /// Creates a number from its raw representation.
+  static constexpr FixedPoint fromRaw(
+    Raw raw
+  );
+
+  /// Saturates an intermediate result to the range of the raw type.
+  static constexpr Raw saturate(
+    Wide value
+  );
+
+  /// Largest representable value.
+  static constexpr FixedPoint max();
+
+  /// Smallest (most negative) representable value.
+  static constexpr FixedPoint min();
+
+  /// Raw representation of the number.
+  inline constexpr Raw raw() const { return raw_; }
+
+  /// Converts the number into a floating point value.
+  constexpr double toDouble() const;
+
+  /// Saturating sum.
+  constexpr FixedPoint operator+(
+    const FixedPoint& other
+  ) const;
+
+  /// Saturating difference.
+  constexpr FixedPoint operator-(
+    const FixedPoint& other
+  ) const;
+
+  /// Saturating negation.
+  constexpr FixedPoint operator-() const;
+
+  /// Saturating product, rounded to the nearest representable value.
+  constexpr FixedPoint operator*(
+    const FixedPoint& other
+  ) const;
+
+  /// Equality comparison.
+  inline constexpr bool operator==(const FixedPoint& other) const { return raw_ == other.raw_; }
+
+  /// Inequality comparison.
+  inline constexpr bool operator!=(const FixedPoint& other) const { return raw_ != other.raw_; }
+
+private:
+  Raw raw_; ///< Raw representation, *i.e.*, the value times \f$ 2^F \f$.
+};
+
+
+/// 16 bits fixed-point numbers in the range \f$ [-1,1) \f$.
+typedef FixedPoint<std::int16_t,std::int32_t,15> Q15;
+
+/// 32 bits fixed-point numbers in the range \f$ [-1,1) \f$.
+typedef FixedPoint<std::int32_t,std::int64_t,31> Q31;
+
+} // namespace digital_filters
+
+#include <digital_filters/fixed_point.hxx>
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <limits>
+
+
+namespace digital_filters {
+
+template<class Raw, class Wide, unsigned int FractionalBits>
+constexpr FixedPoint<Raw,Wide,FractionalBits>::FixedPoint(
+  double value
+)
+: raw_(0)
+{
+  static_assert(sizeof(Wide) >= 2*sizeof(Raw), "FixedPoint: the wide type must have at least twice the bits of the raw type");
+  static_assert(FractionalBits < 8*sizeof(Raw), "FixedPoint: too many fractional bits");
+  // scale and clamp in floating point, then round to the nearest integer
+  const double scaled = value * static_cast<double>(Wide(1) << FractionalBits);
+  if(!(scaled > std::numeric_limits<Raw>::min()))
+    raw_ = std::numeric_limits<Raw>::min();
+  else if(scaled >= std::numeric_limits<Raw>::max())
+    raw_ = std::numeric_limits<Raw>::max();
+  else
+    raw_ = static_cast<Raw>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+}
+
+
+template<class Raw, class Wide, unsigned int FractionalBits>
+constexpr FixedPoint<Raw,Wide,FractionalBits> FixedPoint<Raw,Wide,FractionalBits>::fromRaw(
+  Raw raw
+)
+{
+  FixedPoint number;
+  number.raw_ = raw;
+  return number;
+}
+
+
+template<class Raw, class Wide, unsigned int FractionalBits>
+constexpr Raw FixedPoint<Raw,Wide,FractionalBits>::saturate(
+  Wide value
+)
+{
+  if(value > std::numeric_limits<Raw>::max())
+    return std::numeric_limits<Raw>::max();
+  if(value < std::numeric_limits<Raw>::min())
+    return std::numeric_limits<Raw>::min();
+  return static_cast<Raw>(value);
+}
+
+
+template<class Raw, class Wide, unsigned int FractionalBits>
+constexpr FixedPoint<Raw,Wide,FractionalBits> FixedPoint<Raw,Wide,FractionalBits>::max()
+{
+  return fromRaw(std::numeric_limits<Raw>::max());
+}
+
+
+template<class Raw, class Wide, unsigned int FractionalBits>
+constexpr FixedPoint<Raw,Wide,FractionalBits> FixedPoint<Raw,Wide,FractionalBits>::min()
+{
+  return fromRaw(std::numeric_limits<Raw>::min());
+}
+
+
+template<class Raw, class Wide, unsigned int FractionalBits>
+constexpr double FixedPoint<Raw,Wide,FractionalBits>::toDouble() const
+{
+  return raw_ / static_cast<double>(Wide(1) << FractionalBits);
+}
+
+
+template<class Raw, class Wide, unsigned int FractionalBits>
+constexpr FixedPoint<Raw,Wide,FractionalBits> FixedPoint<Raw,Wide,FractionalBits>::operator+(
+  const FixedPoint& other
+) const
+{
+  return fromRaw(saturate(Wide(raw_) + Wide(other.raw_)));
+}
+
+
+template<class Raw, class Wide, unsigned int FractionalBits>
+constexpr FixedPoint<Raw,Wide,FractionalBits> FixedPoint<Raw,Wide,FractionalBits>::operator-(
+  const FixedPoint& other
+) const
+{
+  return fromRaw(saturate(Wide(raw_) - Wide(other.raw_)));
+}
+
+
+template<class Raw, class Wide, unsigned int FractionalBits>
+constexpr FixedPoint<Raw,Wide,FractionalBits> FixedPoint<Raw,Wide,FractionalBits>::operator-() const
+{
+  return fromRaw(saturate(-Wide(raw_)));
+}
+
+
+template<class Raw, class Wide, unsigned int FractionalBits>
+constexpr FixedPoint<Raw,Wide,FractionalBits> FixedPoint<Raw,Wide,FractionalBits>::operator*(
+  const FixedPoint& other
+) const
+{
+  // the product has 2F fractional bits: round half up while shifting back
+  const Wide product = Wide(raw_) * Wide(other.raw_);
+  if constexpr(FractionalBits == 0)
+    return fromRaw(saturate(product));
+  else
+    return fromRaw(saturate((product + (Wide(1) << (FractionalBits-1))) >> FractionalBits));
+}
+
+} // namespace digital_filters
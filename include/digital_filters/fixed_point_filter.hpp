@@ -0,0 +1,239 @@
+/** @file fixed_point_filter.hpp
+  * @brief Header file containing the FixedPointFilter class and the functions
+  *   that quantize floating point designs.
+  */
+#pragma once
+
+#include <digital_filters/fixed_point.hpp>
+#include <digital_filters/filter.hpp>
+#include <digital_filters/sos_filter.hpp>
+#include <digital_filters/simd.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace digital_filters {
+
+/// Cascade of fixed-point filters applied to many channels at once.
+/** Each stage of the cascade evaluates a Direct Form I difference equation
+  * using integer arithmetic only:
+  * \f[
+  *   y_k = \left( \sum_i \hat{b}_i x_{k-i} - \sum_{i>0} \hat{a}_i y_{k-i}
+  *         \right) 2^{s-F}
+  * \f]
+  * where \f$ F \f$ is the number of fractional bits of the format and
+  * \f$ \hat{b}_i = b_i 2^{F-s} \f$, \f$ \hat{a}_i = a_i 2^{F-s} \f$ are the
+  * quantized coefficients. The shift \f$ s \f$ is chosen, stage by stage, so
+  * that all coefficients are representable and the sum of their absolute
+  * values guarantees that the accumulator (of type `Format::WideType`) never
+  * overflows. The result is rounded to the nearest integer and saturated to
+  * the range of the format.
+  *
+  * Channels are interleaved, as in FilterBank, and the history of all
+  * channels is stored in structure-of-arrays layout. Q15 filters process
+  * channels using SIMD packs of 32 bits integers when they are available (see
+  * SimdPack), while Q31 filters, which need 64 bits accumulators, use scalar
+  * arithmetic.
+  *
+  * Filters are usually obtained from a floating point design via quantize().
+  * @tparam Format fixed-point format of the samples, *e.g.*, Q15 or Q31.
+  */
+template <class Format>
+class FixedPointFilter {
+public:
+  typedef typename Format::RawType Raw; ///< Integer type of the samples.
+  typedef typename Format::WideType Wide; ///< Integer type of the accumulators.
+
+  /// Quantized coefficients of a stage of the cascade.
+  struct Stage {
+    std::vector<Raw> b; ///< Numerator, scaled by \f$ 2^{F-s} \f$.
+    std::vector<Raw> a; ///< Denominator without \f$ a_0 \f$, scaled by \f$ 2^{F-s} \f$.
+    unsigned int shift; ///< Shift \f$ s \f$ applied to the coefficients.
+  };
+
+  /// Generates a filter from quantized stages.
+  /** @param stages quantized coefficients, in order of application. An empty
+    *   list corresponds to the identity filter.
+    * @param channels number of channels processed by the filter.
+    * @note An exception is thrown if the shift of a stage is larger than the
+    *   number of fractional bits of the format.
+    * @see quantizeStage()
+    */
+  FixedPointFilter(
+    const std::vector<Stage>& stages,
+    std::size_t channels = 1
+  );
+
+  /// Quantizes the coefficients of a single stage.
+  /** @param b numerator of the stage.
+    * @param a denominator of the stage. Its first element must not be zero;
+    *   coefficients are normalized so that \f$ a_0 = 1 \f$.
+    * @param[out] error if not null, set to the largest absolute error on the
+    *   normalized coefficients.
+    * @return quantized stage, using the smallest shift for which the stage
+    *   cannot overflow.
+    * @note An exception is thrown if the coefficients are too large to be
+    *   represented with any valid shift.
+    */
+  static Stage quantizeStage(
+    const std::vector<double>& b,
+    const std::vector<double>& a,
+    double* error = nullptr
+  );
+
+  /// Number of channels processed by the filter.
+  inline std::size_t channels() const { return channels_; }
+
+  /// Access the quantized stages.
+  inline const std::vector<Stage>& stages() const { return stages_; }
+
+  /// Name of the instruction set used to process the channels.
+  static const char* instructionSet();
+
+  /// Set the history of all channels to zero.
+  void reset();
+
+  /// Filter one sample per channel.
+  /** @param x_in pointer to one input sample per channel.
+    * @param y_out pointer to one output sample per channel. It can be equal
+    *   to `x_in`, in which case samples are filtered in-place.
+    */
+  void filter(
+    const Format* x_in,
+    Format* y_out
+  );
+
+  /// Filter multiple samples per channel.
+  /** @param x_in pointer to `frames*channels()` interleaved input samples.
+    * @param y_out pointer to `frames*channels()` output samples, using the
+    *   same layout as the input. It can be equal to `x_in`.
+    * @param frames number of samples per channel.
+    * @see FilterBank::filter(const DataType*, DataType*, std::size_t)
+    */
+  void filter(
+    const Format* x_in,
+    Format* y_out,
+    std::size_t frames
+  );
+
+private:
+  static_assert(sizeof(Format) == sizeof(Raw), "FixedPointFilter: the format must have the same size as its raw type");
+
+  /// Whether channels can be processed using SIMD packs.
+  static constexpr bool packable() {
+    return SimdPack<std::int32_t>::width > 1
+      && std::is_same<Raw,std::int16_t>::value
+      && std::is_same<Wide,std::int32_t>::value;
+  }
+
+  /// Largest sum of the absolute values of the quantized coefficients.
+  /** It guarantees that the accumulator does not overflow, even if all
+    * samples have the largest magnitude allowed by the format.
+    */
+  static Wide maxCoefficientsNorm();
+
+  /// Process a stage of the cascade, in groups of SimdPack::width channels.
+  /** @param s index of the stage.
+    * @return index of the first channel that was not processed.
+    */
+  std::size_t filterPacked(
+    const Raw* x_in,
+    Raw* y_out,
+    std::size_t s
+  );
+
+  /// Process a stage of the cascade, one channel at a time.
+  /** @param s index of the stage.
+    * @param first index of the first channel to be processed.
+    */
+  void filterScalar(
+    const Raw* x_in,
+    Raw* y_out,
+    std::size_t s,
+    std::size_t first
+  );
+
+  std::vector<Stage> stages_; ///< Quantized stages.
+  std::size_t channels_; ///< Number of channels.
+  /// Past inputs of each stage.
+  /** The \f$ i \f$-th past input (most recent first) of the channel \f$ c \f$
+    * in the stage \f$ s \f$ is stored in `inputs_[s][i*channels_+c]`.
+    */
+  std::vector<std::vector<Wide>> inputs_;
+  /// Past outputs of each stage, using the same layout as `inputs_`.
+  std::vector<std::vector<Wide>> outputs_;
+};
+
+
+/// Summary of the errors introduced by quantize().
+struct QuantizationReport {
+  /// Largest absolute error on the normalized coefficients of all stages.
+  double coefficient_error = 0;
+  /// Relative error on the static gain of the whole filter.
+  /** If the static gain of the original filter is zero, this is the absolute
+    * error instead. It is infinite (or not-a-number) if the original filter
+    * or the quantized one has a pole in \f$ z=1 \f$.
+    */
+  double gain_error = 0;
+  /// Shift applied to the coefficients of each stage.
+  std::vector<unsigned int> shifts;
+};
+
+
+/// Converts a cascade of transfer functions into a fixed-point filter.
+/** @tparam Format fixed-point format, *e.g.*, Q15 or Q31.
+  * @param numerators numerator of each stage, in order of application.
+  * @param denominators denominator of each stage. It must have the same
+  *   size as `numerators`.
+  * @param channels number of channels processed by the new filter.
+  * @param[out] report if not null, filled with the quantization errors.
+  * @return fixed-point filter with one stage per transfer function.
+  * @see FixedPointFilter::quantizeStage()
+  */
+template <class Format>
+FixedPointFilter<Format> quantize(
+  const std::vector<std::vector<double>>& numerators,
+  const std::vector<std::vector<double>>& denominators,
+  std::size_t channels = 1,
+  QuantizationReport* report = nullptr
+);
+
+
+/// Converts a filter into a fixed-point filter.
+/** This is the fixed-point counterpart of Filter::as(): the whole transfer
+  * function becomes a single stage. Since high order polynomials are very
+  * sensitive to quantization, prefer converting a SosFilter when the order is
+  * larger than two. The internal state of the filter is not copied.
+  * @tparam Format fixed-point format, *e.g.*, Q15 or Q31.
+  * @param filter filter to be converted.
+  * @param channels number of channels processed by the new filter.
+  * @param[out] report if not null, filled with the quantization errors.
+  * @return fixed-point version of the filter.
+  */
+template <class Format, class DataType, class CoeffType>
+FixedPointFilter<Format> quantize(
+  const Filter<DataType,CoeffType>& filter,
+  std::size_t channels = 1,
+  QuantizationReport* report = nullptr
+);
+
+
+/// Converts a cascade of second-order sections into a fixed-point filter.
+/** Each section becomes a stage of the cascade, with its own shift.
+  * @tparam Format fixed-point format, *e.g.*, Q15 or Q31.
+  * @param filter filter to be converted.
+  * @param channels number of channels processed by the new filter.
+  * @param[out] report if not null, filled with the quantization errors.
+  * @return fixed-point version of the filter.
+  */
+template <class Format, class DataType, class CoeffType>
+FixedPointFilter<Format> quantize(
+  const SosFilter<DataType,CoeffType>& filter,
+  std::size_t channels = 1,
+  QuantizationReport* report = nullptr
+);
+
+} // namespace digital_filters
+
+#include <digital_filters/fixed_point_filter.hxx>
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+
+namespace digital_filters {
+
+template<class Format>
+FixedPointFilter<Format>::FixedPointFilter(
+  const std::vector<Stage>& stages,
+  std::size_t channels
+)
+: stages_(stages)
+, channels_(channels)
+{
+  for(const auto& stage : stages_) {
+    if(stage.b.empty())
+      throw std::runtime_error("FixedPointFilter: numerator (b) is empty");
+    if(stage.shift > Format::fractional_bits) {
+      throw std::runtime_error(
+        "FixedPointFilter: the shift of a stage (" + std::to_string(stage.shift) +
+        ") cannot exceed the number of fractional bits (" +
+        std::to_string(Format::fractional_bits) + ")"
+      );
+    }
+    inputs_.emplace_back((stage.b.size()-1)*channels_, Wide(0));
+    outputs_.emplace_back(stage.a.size()*channels_, Wide(0));
+  }
+}
+
+
+template<class Format>
+typename FixedPointFilter<Format>::Wide FixedPointFilter<Format>::maxCoefficientsNorm()
+{
+  // |sum_i c_i x_i + rounding| <= norm * |min(Raw)| + 2^(F-1) <= max(Wide)
+  const Wide largest_sample = -Wide(std::numeric_limits<Raw>::min());
+  const Wide rounding = Wide(1) << (Format::fractional_bits - 1);
+  return (std::numeric_limits<Wide>::max() - rounding) / largest_sample;
+}
+
+
+template<class Format>
+typename FixedPointFilter<Format>::Stage FixedPointFilter<Format>::quantizeStage(
+  const std::vector<double>& b,
+  const std::vector<double>& a,
+  double* error
+)
+{
+  if(b.empty())
+    throw std::runtime_error("FixedPointFilter::quantizeStage: numerator (b) is empty");
+  if(a.empty() || a[0] == 0)
+    throw std::runtime_error("FixedPointFilter::quantizeStage: the first denominator coefficient (a0) is zero");
+
+  // normalized coefficients, without a0
+  std::vector<double> c;
+  for(const auto& bi : b)
+    c.push_back(bi / a[0]);
+  for(std::size_t i=1; i<a.size(); i++)
+    c.push_back(a[i] / a[0]);
+
+  // try the shifts in increasing order, i.e., from the finest resolution
+  const Wide norm = maxCoefficientsNorm();
+  for(unsigned int shift=0; shift<=Format::fractional_bits; shift++) {
+    const double scale = std::ldexp(1.0, Format::fractional_bits - shift);
+    bool valid = true;
+    Wide sum = 0;
+    std::vector<Raw> q(c.size());
+    for(std::size_t i=0; i<c.size() && valid; i++) {
+      const double scaled = std::round(c[i] * scale);
+      valid = scaled >= std::numeric_limits<Raw>::min() && scaled <= std::numeric_limits<Raw>::max();
+      if(valid) {
+        q[i] = static_cast<Raw>(scaled);
+        sum += q[i] < 0 ? -Wide(q[i]) : Wide(q[i]);
+        valid = sum <= norm;
+      }
+    }
+    if(!valid)
+      continue;
+
+    // found: split numerator and denominator
+    Stage stage;
+    stage.b.assign(q.begin(), q.begin() + b.size());
+    stage.a.assign(q.begin() + b.size(), q.end());
+    stage.shift = shift;
+    if(error) {
+      *error = 0;
+      for(std::size_t i=0; i<c.size(); i++)
+        *error = std::max(*error, std::abs(c[i] - q[i] / scale));
+    }
+    return stage;
+  }
+
+  throw std::runtime_error(
+    "FixedPointFilter::quantizeStage: the coefficients are too large to be "
+    "represented without overflowing the accumulator"
+  );
+}
+
+
+template<class Format>
+const char* FixedPointFilter<Format>::instructionSet()
+{
+  if constexpr(packable())
+    return SimdPack<std::int32_t>::name;
+  else
+    return "scalar";
+}
+
+
+template<class Format>
+void FixedPointFilter<Format>::reset()
+{
+  for(auto& history : inputs_)
+    std::fill(history.begin(), history.end(), Wide(0));
+  for(auto& history : outputs_)
+    std::fill(history.begin(), history.end(), Wide(0));
+}
+
+
+template<class Format>
+void FixedPointFilter<Format>::filter(
+  const Format* x_in,
+  Format* y_out
+)
+{
+  // formats have the same layout as their raw integers
+  const Raw* x = reinterpret_cast<const Raw*>(x_in);
+  Raw* y = reinterpret_cast<Raw*>(y_out);
+  if(stages_.empty() && x != y)
+    std::copy(x, x + channels_, y);
+  // outputs of each stage are saturated, hence they can be stored in y_out
+  // without losing information
+  for(std::size_t s=0; s<stages_.size(); s++) {
+    const Raw* in = s == 0 ? x : y;
+    filterScalar(in, y, s, filterPacked(in, y, s));
+  }
+}
+
+
+template<class Format>
+void FixedPointFilter<Format>::filter(
+  const Format* x_in,
+  Format* y_out,
+  std::size_t frames
+)
+{
+  for(std::size_t k=0; k<frames; k++)
+    filter(x_in + k*channels_, y_out + k*channels_);
+}
+
+
+template<class Format>
+std::size_t FixedPointFilter<Format>::filterPacked(
+  const Raw* x_in,
+  Raw* y_out,
+  std::size_t s
+)
+{
+  if constexpr(packable()) {
+    // Q15 samples are widened to 32 bits lanes, which hold the accumulators
+    typedef SimdPack<std::int32_t> Pack;
+    const Stage& stage = stages_[s];
+    const std::size_t nx = stage.b.size() - 1;
+    const std::size_t ny = stage.a.size();
+    const int bits = Format::fractional_bits - stage.shift;
+    const auto rounding = Pack::broadcast(bits > 0 ? Wide(1) << (bits-1) : Wide(0));
+    const auto lowest = Pack::broadcast(std::numeric_limits<Raw>::min());
+    const auto highest = Pack::broadcast(std::numeric_limits<Raw>::max());
+    const std::size_t packed = channels_ - channels_ % Pack::width;
+    for(std::size_t c=0; c<packed; c+=Pack::width) {
+      Wide* xs = inputs_[s].data() + c;
+      Wide* ys = outputs_[s].data() + c;
+      const auto x = Pack::load(x_in + c);
+
+      // evaluate the difference equation
+      auto acc = Pack::mul(Pack::broadcast(stage.b[0]), x);
+      for(std::size_t i=0; i<nx; i++)
+        acc = Pack::add(acc, Pack::mul(Pack::broadcast(stage.b[i+1]), Pack::load(xs + i*channels_)));
+      for(std::size_t i=0; i<ny; i++)
+        acc = Pack::sub(acc, Pack::mul(Pack::broadcast(stage.a[i]), Pack::load(ys + i*channels_)));
+      acc = Pack::shiftRight(Pack::add(acc, rounding), bits);
+      const auto y = Pack::min(Pack::max(acc, lowest), highest);
+
+      // shift the histories, most recent first
+      for(std::size_t i=nx; i>1; i--)
+        Pack::store(xs + (i-1)*channels_, Pack::load(xs + (i-2)*channels_));
+      if(nx > 0)
+        Pack::store(xs, x);
+      for(std::size_t i=ny; i>1; i--)
+        Pack::store(ys + (i-1)*channels_, Pack::load(ys + (i-2)*channels_));
+      if(ny > 0)
+        Pack::store(ys, y);
+      Pack::store(y_out + c, y);
+    }
+    return packed;
+  }
+  else {
+    return 0;
+  }
+}
+
+
+template<class Format>
+void FixedPointFilter<Format>::filterScalar(
+  const Raw* x_in,
+  Raw* y_out,
+  std::size_t s,
+  std::size_t first
+)
+{
+  const Stage& stage = stages_[s];
+  const std::size_t nx = stage.b.size() - 1;
+  const std::size_t ny = stage.a.size();
+  const unsigned int bits = Format::fractional_bits - stage.shift;
+  const Wide rounding = bits > 0 ? Wide(1) << (bits-1) : Wide(0);
+  for(std::size_t c=first; c<channels_; c++) {
+    Wide* xs = inputs_[s].data() + c;
+    Wide* ys = outputs_[s].data() + c;
+    const Wide x = x_in[c];
+
+    // evaluate the difference equation
+    Wide acc = stage.b[0] * x;
+    for(std::size_t i=0; i<nx; i++)
+      acc += stage.b[i+1] * xs[i*channels_];
+    for(std::size_t i=0; i<ny; i++)
+      acc -= stage.a[i] * ys[i*channels_];
+    const Raw y = Format::saturate((acc + rounding) >> bits);
+
+    // shift the histories, most recent first
+    for(std::size_t i=nx; i>1; i--)
+      xs[(i-1)*channels_] = xs[(i-2)*channels_];
+    if(nx > 0)
+      xs[0] = x;
+    for(std::size_t i=ny; i>1; i--)
+      ys[(i-1)*channels_] = ys[(i-2)*channels_];
+    if(ny > 0)
+      ys[0] = y;
+    y_out[c] = y;
+  }
+}
+
+
+template <class Format>
+FixedPointFilter<Format> quantize(
+  const std::vector<std::vector<double>>& numerators,
+  const std::vector<std::vector<double>>& denominators,
+  std::size_t channels,
+  QuantizationReport* report
+)
+{
+  if(numerators.size() != denominators.size()) {
+    throw std::runtime_error(
+      "quantize: " + std::to_string(numerators.size()) + " numerators and " +
+      std::to_string(denominators.size()) + " denominators were given"
+    );
+  }
+
+  std::vector<typename FixedPointFilter<Format>::Stage> stages;
+  double coefficient_error = 0;
+  double gain = 1;
+  double quantized_gain = 1;
+  for(std::size_t s=0; s<numerators.size(); s++) {
+    const auto& b = numerators[s];
+    const auto& a = denominators[s];
+    double error;
+    stages.push_back(FixedPointFilter<Format>::quantizeStage(b, a, &error));
+    coefficient_error = std::max(coefficient_error, error);
+
+    // static gains of the original and of the quantized stage
+    double sum_b = 0;
+    double sum_a = 0;
+    for(const auto& bi : b)
+      sum_b += bi;
+    for(const auto& ai : a)
+      sum_a += ai;
+    gain *= sum_b / sum_a;
+    const auto& stage = stages.back();
+    const double scale = std::ldexp(1.0, Format::fractional_bits - stage.shift);
+    double sum_bq = 0;
+    double sum_aq = scale;
+    for(const auto& bi : stage.b)
+      sum_bq += bi;
+    for(const auto& ai : stage.a)
+      sum_aq += ai;
+    quantized_gain *= sum_bq / sum_aq;
+  }
+
+  if(report) {
+    report->coefficient_error = coefficient_error;
+    report->gain_error = gain == 0
+      ? std::abs(quantized_gain)
+      : std::abs(quantized_gain - gain) / std::abs(gain);
+    report->shifts.clear();
+    for(const auto& stage : stages)
+      report->shifts.push_back(stage.shift);
+  }
+  return FixedPointFilter<Format>(stages, channels);
+}
+
+
+template <class Format, class DataType, class CoeffType>
+FixedPointFilter<Format> quantize(
+  const Filter<DataType,CoeffType>& filter,
+  std::size_t channels,
+  QuantizationReport* report
+)
+{
+  const auto& b = filter.numerator();
+  const auto& a = filter.denominator();
+  return quantize<Format>(
+    std::vector<std::vector<double>>{std::vector<double>(b.begin(), b.end())},
+    std::vector<std::vector<double>>{std::vector<double>(a.begin(), a.end())},
+    channels,
+    report
+  );
+}
+
+
+template <class Format, class DataType, class CoeffType>
+FixedPointFilter<Format> quantize(
+  const SosFilter<DataType,CoeffType>& filter,
+  std::size_t channels,
+  QuantizationReport* report
+)
+{
+  std::vector<std::vector<double>> numerators;
+  std::vector<std::vector<double>> denominators;
+  for(const auto& section : filter.sections()) {
+    numerators.push_back({double(section[0]), double(section[1]), double(section[2])});
+    denominators.push_back({double(section[3]), double(section[4]), double(section[5])});
+  }
+  return quantize<Format>(numerators, denominators, channels, report);
+}
+
+} // namespace digital_filters
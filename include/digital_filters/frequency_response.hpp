@@ -0,0 +1,187 @@
+/** @file frequency_response.hpp
+  * @brief Header file containing the FrequencyAnalyzer class, to evaluate
+  *   frequency responses and group delays.
+  */
+#pragma once
+
+#include <digital_filters/filter.hpp>
+#include <digital_filters/sos_filter.hpp>
+#include <digital_filters/fft.hpp>
+#include <digital_filters/thread_pool.hpp>
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+namespace digital_filters {
+
+/// Frequency response of a filter over a grid of frequencies.
+/** The frequencies themselves are stored in the FrequencyAnalyzer that
+  * evaluated the response, so that they are not replicated when many designs
+  * are analyzed.
+  */
+template <class CoeffType>
+struct FrequencyResponse {
+  /// Complex response \f$ H(e^{j\omega}) \f$ at each frequency.
+  std::vector<std::complex<CoeffType>> response;
+  /// Group delay \f$ -d\angle H / d\omega \f$ at each frequency, in samples.
+  std::vector<CoeffType> group_delay;
+
+  /// Magnitude of the response at each frequency.
+  std::vector<CoeffType> magnitude() const;
+
+  /// Phase of the response at each frequency, in radians.
+  /** The phase is unwrapped, *i.e.*, jumps of \f$ 2\pi \f$ between
+    * consecutive frequencies are removed.
+    */
+  std::vector<CoeffType> phase() const;
+};
+
+
+/// Evaluates frequency responses and group delays over a fixed grid.
+/** The analyzer precomputes everything that depends on the grid only, so
+  * that each evaluation costs a pass over the coefficients:
+  * - on arbitrary grids, polynomials are evaluated via Horner's method. The
+  *   loops run over all frequencies for each coefficient, on separate arrays
+  *   for real and imaginary parts, which allows the compiler to vectorize
+  *   them;
+  * - on uniform grids whose number of points is a power of two, long
+  *   polynomials are evaluated at all frequencies at once via an FFT. The
+  *   polynomial and the one used for the group delay are packed into a single
+  *   complex transform. Since the cost of a transform does not depend on the
+  *   number of coefficients, it is used only for polynomials with more than
+  *   \f$ 2 \log_2 N \f$ coefficients, \f$ N \f$ being the size of the
+  *   transform.
+  *
+  * The group delay is obtained analytically: for a polynomial
+  * \f$ P(z) = \sum_k p_k z^{-k} \f$, the delay is
+  * \f$ \mathrm{Re}\left( \sum_k k p_k z^{-k} / P(z) \right) \f$, and the
+  * delay of a transfer function is the delay of the numerator minus the one
+  * of the denominator. At the frequencies where a polynomial vanishes (up to
+  * rounding errors), its contribution to the group delay is set to zero.
+  *
+  * Evaluations do not modify the analyzer, hence many designs can be
+  * analyzed in parallel, see evaluate(const std::vector<Design>&, ThreadPool&) const.
+  * @tparam CoeffType floating point type of the coefficients.
+  */
+template <class CoeffType>
+class FrequencyAnalyzer {
+public:
+  /// Prepares the evaluation over a given set of frequencies.
+  /** @param frequencies frequencies at which responses are evaluated.
+    * @param sampling sampling frequency of the analyzed filters.
+    * @note An exception is thrown if the sampling frequency is not positive.
+    */
+  FrequencyAnalyzer(
+    const std::vector<CoeffType>& frequencies,
+    const CoeffType& sampling
+  );
+
+  /// Prepares the evaluation over a uniform grid.
+  /** The grid contains the frequencies `k*sampling/(2*points)` for
+    * `k=0, ..., points-1`, *i.e.*, it spans the interval from zero (included)
+    * to the Nyquist frequency (excluded), as the default grid of SciPy's
+    * `freqz`. If `points` is a power of two, FFTs are used for long
+    * polynomials.
+    * @param points number of frequencies.
+    * @param sampling sampling frequency of the analyzed filters.
+    * @note An exception is thrown if `points` is zero or if the sampling
+    *   frequency is not positive.
+    */
+  FrequencyAnalyzer(
+    std::size_t points,
+    const CoeffType& sampling
+  );
+
+  /// Frequencies at which responses are evaluated.
+  inline const std::vector<CoeffType>& frequencies() const { return frequencies_; }
+
+  /// Sampling frequency of the analyzed filters.
+  inline const CoeffType& sampling() const { return sampling_; }
+
+  /// Minimum number of coefficients of the polynomials evaluated via FFT.
+  /** @return the number of coefficients above which polynomials are
+    *   evaluated via FFT, or zero if the grid does not allow to use FFTs.
+    */
+  inline std::size_t fftThreshold() const { return fft_threshold_; }
+
+  /// Response of a transfer function.
+  /** @param b numerator of the transfer function, in powers of \f$ z^{-1} \f$.
+    * @param a denominator of the transfer function, in powers of
+    *   \f$ z^{-1} \f$. It does not need to be normalized.
+    * @return response and group delay at each frequency.
+    */
+  FrequencyResponse<CoeffType> evaluate(
+    const std::vector<CoeffType>& b,
+    const std::vector<CoeffType>& a
+  ) const;
+
+  /// Response of a filter.
+  template <class DataType>
+  FrequencyResponse<CoeffType> evaluate(
+    const Filter<DataType,CoeffType>& filter
+  ) const;
+
+  /// Response of a cascade of second-order sections.
+  /** Sections are evaluated one at a time: responses are multiplied and
+    * group delays are summed, which is more accurate than evaluating the
+    * expanded polynomials of high-order filters.
+    */
+  template <class DataType>
+  FrequencyResponse<CoeffType> evaluate(
+    const SosFilter<DataType,CoeffType>& filter
+  ) const;
+
+  /// Responses of many designs, evaluated in parallel.
+  /** @param designs filters to be evaluated; any type accepted by the other
+    *   overloads of evaluate() can be used.
+    * @param pool threads used for the evaluation. Each design is a task.
+    * @return the responses, in the same order as the designs.
+    */
+  template <class Design>
+  std::vector<FrequencyResponse<CoeffType>> evaluate(
+    const std::vector<Design>& designs,
+    ThreadPool& pool
+  ) const;
+
+private:
+  /// Evaluates a polynomial and its ramped version at all frequencies.
+  /** @param p coefficients of \f$ P(z) = \sum_k p_k z^{-k} \f$.
+    * @param[out] value values of \f$ P \f$, one per frequency.
+    * @param[out] delay group delay of \f$ P \f$, one per frequency.
+    */
+  void polynomial(
+    const std::vector<CoeffType>& p,
+    std::vector<std::complex<CoeffType>>& value,
+    std::vector<CoeffType>& delay
+  ) const;
+
+  /// Squared magnitude below which a polynomial is considered to vanish.
+  static CoeffType zeroThreshold(
+    const std::vector<CoeffType>& p
+  );
+
+  /// Implementation of polynomial() based on Horner's method.
+  void horner(
+    const std::vector<CoeffType>& p,
+    std::vector<std::complex<CoeffType>>& value,
+    std::vector<CoeffType>& delay
+  ) const;
+
+  /// Implementation of polynomial() based on the FFT.
+  void fft(
+    const std::vector<CoeffType>& p,
+    std::vector<std::complex<CoeffType>>& value,
+    std::vector<CoeffType>& delay
+  ) const;
+
+  std::vector<CoeffType> frequencies_; ///< Evaluated frequencies.
+  CoeffType sampling_; ///< Sampling frequency.
+  std::vector<CoeffType> cos_; ///< Real part of \f$ z^{-1} \f$.
+  std::vector<CoeffType> sin_; ///< Imaginary part of \f$ z^{-1} \f$.
+  std::size_t fft_threshold_; ///< Size above which FFTs are used, if any.
+  FftPlan<CoeffType> plan_; ///< Transforms of twice the number of points.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/frequency_response.hxx>
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+
+
+namespace digital_filters {
+
+template<class CoeffType>
+std::vector<CoeffType> FrequencyResponse<CoeffType>::magnitude() const
+{
+  std::vector<CoeffType> m(response.size());
+  for(std::size_t i=0; i<response.size(); i++)
+    m[i] = std::abs(response[i]);
+  return m;
+}
+
+
+template<class CoeffType>
+std::vector<CoeffType> FrequencyResponse<CoeffType>::phase() const
+{
+  std::vector<CoeffType> p(response.size());
+  for(std::size_t i=0; i<response.size(); i++) {
+    p[i] = std::arg(response[i]);
+    // the step with respect to the previous frequency is kept in [-pi,pi]
+    if(i > 0)
+      p[i] = p[i-1] + std::remainder(p[i] - std::arg(response[i-1]), CoeffType(2*M_PI));
+  }
+  return p;
+}
+
+
+template<class CoeffType>
+FrequencyAnalyzer<CoeffType>::FrequencyAnalyzer(
+  const std::vector<CoeffType>& frequencies,
+  const CoeffType& sampling
+)
+: frequencies_(frequencies)
+, sampling_(sampling)
+, fft_threshold_(0)
+, plan_(1)
+{
+  if(!(sampling_ > 0))
+    throw std::runtime_error("FrequencyAnalyzer: the sampling frequency must be positive");
+  // z^-1 at each frequency
+  cos_.resize(frequencies_.size());
+  sin_.resize(frequencies_.size());
+  for(std::size_t i=0; i<frequencies_.size(); i++) {
+    const CoeffType omega = 2*M_PI * frequencies_[i] / sampling_;
+    cos_[i] = std::cos(omega);
+    sin_[i] = -std::sin(omega);
+  }
+}
+
+
+template<class CoeffType>
+FrequencyAnalyzer<CoeffType>::FrequencyAnalyzer(
+  std::size_t points,
+  const CoeffType& sampling
+)
+: FrequencyAnalyzer(std::vector<CoeffType>(), sampling)
+{
+  if(points == 0)
+    throw std::runtime_error("FrequencyAnalyzer: the number of points must be positive");
+  frequencies_.resize(points);
+  for(std::size_t k=0; k<points; k++)
+    frequencies_[k] = sampling_ * k / (2*points);
+
+  cos_.resize(points);
+  sin_.resize(points);
+  for(std::size_t k=0; k<points; k++) {
+    const CoeffType omega = M_PI * k / points;
+    cos_[k] = std::cos(omega);
+    sin_[k] = -std::sin(omega);
+  }
+
+  if((points & (points-1)) == 0) {
+    plan_ = FftPlan<CoeffType>(2*points);
+    // a transform costs about as much as Horner's method with 2*log2(N)
+    // coefficients
+    fft_threshold_ = 0;
+    while((std::size_t(1) << fft_threshold_) < plan_.size())
+      fft_threshold_++;
+    fft_threshold_ *= 2;
+  }
+}
+
+
+template<class CoeffType>
+FrequencyResponse<CoeffType> FrequencyAnalyzer<CoeffType>::evaluate(
+  const std::vector<CoeffType>& b,
+  const std::vector<CoeffType>& a
+) const
+{
+  if(b.empty() || a.empty())
+    throw std::runtime_error("FrequencyAnalyzer::evaluate: the numerator and the denominator must not be empty");
+
+  FrequencyResponse<CoeffType> result;
+  std::vector<std::complex<CoeffType>> den;
+  std::vector<CoeffType> den_delay;
+  polynomial(b, result.response, result.group_delay);
+  polynomial(a, den, den_delay);
+  for(std::size_t i=0; i<frequencies_.size(); i++) {
+    result.response[i] /= den[i];
+    result.group_delay[i] -= den_delay[i];
+  }
+  return result;
+}
+
+
+template<class CoeffType>
+template<class DataType>
+FrequencyResponse<CoeffType> FrequencyAnalyzer<CoeffType>::evaluate(
+  const Filter<DataType,CoeffType>& filter
+) const
+{
+  return evaluate(filter.numerator(), filter.denominator());
+}
+
+
+template<class CoeffType>
+template<class DataType>
+FrequencyResponse<CoeffType> FrequencyAnalyzer<CoeffType>::evaluate(
+  const SosFilter<DataType,CoeffType>& filter
+) const
+{
+  FrequencyResponse<CoeffType> result;
+  result.response.assign(frequencies_.size(), std::complex<CoeffType>(1));
+  result.group_delay.assign(frequencies_.size(), CoeffType(0));
+  std::vector<CoeffType> b(3), a(3);
+  for(const auto& s : filter.sections()) {
+    b.assign(s.begin(), s.begin()+3);
+    a.assign(s.begin()+3, s.end());
+    const auto section = evaluate(b, a);
+    for(std::size_t i=0; i<frequencies_.size(); i++) {
+      result.response[i] *= section.response[i];
+      result.group_delay[i] += section.group_delay[i];
+    }
+  }
+  return result;
+}
+
+
+template<class CoeffType>
+template<class Design>
+std::vector<FrequencyResponse<CoeffType>> FrequencyAnalyzer<CoeffType>::evaluate(
+  const std::vector<Design>& designs,
+  ThreadPool& pool
+) const
+{
+  std::vector<FrequencyResponse<CoeffType>> results(designs.size());
+  pool.run(designs.size(), [&](std::size_t task, std::size_t) {
+    results[task] = evaluate(designs[task]);
+  });
+  return results;
+}
+
+
+template<class CoeffType>
+void FrequencyAnalyzer<CoeffType>::polynomial(
+  const std::vector<CoeffType>& p,
+  std::vector<std::complex<CoeffType>>& value,
+  std::vector<CoeffType>& delay
+) const
+{
+  if(fft_threshold_ > 0 && p.size() > fft_threshold_)
+    fft(p, value, delay);
+  else
+    horner(p, value, delay);
+}
+
+
+template<class CoeffType>
+CoeffType FrequencyAnalyzer<CoeffType>::zeroThreshold(
+  const std::vector<CoeffType>& p
+)
+{
+  // rounding errors are proportional to the sum of the absolute values of
+  // the coefficients
+  CoeffType scale = 0;
+  for(const auto& pk : p)
+    scale += std::abs(pk);
+  scale *= 64 * std::numeric_limits<CoeffType>::epsilon();
+  return scale * scale;
+}
+
+
+template<class CoeffType>
+void FrequencyAnalyzer<CoeffType>::horner(
+  const std::vector<CoeffType>& p,
+  std::vector<std::complex<CoeffType>>& value,
+  std::vector<CoeffType>& delay
+) const
+{
+  // Evaluate P(z) = sum p_k z^-k and R(z) = sum k p_k z^-k. Real and
+  // imaginary parts are kept in separate arrays, and the inner loops run
+  // over the frequencies, so that they can be vectorized.
+  const std::size_t m = frequencies_.size();
+  std::vector<CoeffType> pr(m, CoeffType(0)), pi(m, CoeffType(0));
+  std::vector<CoeffType> rr(m, CoeffType(0)), ri(m, CoeffType(0));
+  const CoeffType* wr = cos_.data();
+  const CoeffType* wi = sin_.data();
+  for(std::size_t k=p.size(); k-->0; ) {
+    const CoeffType pk = p[k];
+    const CoeffType rk = p[k] * CoeffType(k);
+    for(std::size_t f=0; f<m; f++) {
+      const CoeffType tr = pr[f]*wr[f] - pi[f]*wi[f] + pk;
+      pi[f] = pr[f]*wi[f] + pi[f]*wr[f];
+      pr[f] = tr;
+      const CoeffType sr = rr[f]*wr[f] - ri[f]*wi[f] + rk;
+      ri[f] = rr[f]*wi[f] + ri[f]*wr[f];
+      rr[f] = sr;
+    }
+  }
+
+  // the group delay is Re(R/P)
+  const CoeffType zero = zeroThreshold(p);
+  value.resize(m);
+  delay.resize(m);
+  for(std::size_t f=0; f<m; f++) {
+    value[f] = std::complex<CoeffType>(pr[f], pi[f]);
+    const CoeffType norm = pr[f]*pr[f] + pi[f]*pi[f];
+    delay[f] = norm > zero ? (rr[f]*pr[f] + ri[f]*pi[f]) / norm : CoeffType(0);
+  }
+}
+
+
+template<class CoeffType>
+void FrequencyAnalyzer<CoeffType>::fft(
+  const std::vector<CoeffType>& p,
+  std::vector<std::complex<CoeffType>>& value,
+  std::vector<CoeffType>& delay
+) const
+{
+  // P goes in the real part and R in the imaginary one. Since z^N = 1 on the
+  // grid, coefficients beyond the size of the transform are folded.
+  const std::size_t N = plan_.size();
+  std::vector<std::complex<CoeffType>> data(N);
+  for(std::size_t k=0; k<p.size(); k++)
+    data[k % N] += std::complex<CoeffType>(p[k], p[k] * CoeffType(k));
+  plan_.forward(data.data());
+
+  // separate the transforms of the two real sequences
+  const CoeffType zero = zeroThreshold(p);
+  const std::size_t m = frequencies_.size();
+  value.resize(m);
+  delay.resize(m);
+  for(std::size_t f=0; f<m; f++) {
+    const std::complex<CoeffType> x = data[f];
+    const std::complex<CoeffType> y = std::conj(data[(N - f) % N]);
+    const std::complex<CoeffType> P = CoeffType(0.5) * (x + y);
+    const std::complex<CoeffType> R = CoeffType(0.5) * std::complex<CoeffType>(x.imag() - y.imag(), y.real() - x.real());
+    value[f] = P;
+    const CoeffType norm = std::norm(P);
+    delay[f] = norm > zero ? (R.real()*P.real() + R.imag()*P.imag()) / norm : CoeffType(0);
+  }
+}
+
+} // namespace digital_filters
@@ -0,0 +1,215 @@
+/** @file instrumentation.hpp
+  * @brief Header file containing the Probe class, used to collect runtime
+  *   statistics of filters.
+  *
+  * Instrumentation is selected at compile time: the hooks placed in the
+  * filtering methods are compiled only if the macro
+  * `DIGITAL_FILTERS_INSTRUMENTATION` is defined before including any header
+  * of the library (the CMake option `ENABLE_INSTRUMENTATION` defines it for
+  * all targets that link the library). Otherwise, the hooks expand to
+  * nothing and attached probes are simply ignored. All translation units of
+  * a program should agree on the definition of the macro.
+  */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace digital_filters {
+
+/// Whether the instrumentation hooks are compiled.
+inline constexpr bool instrumentationEnabled() {
+#ifdef DIGITAL_FILTERS_INSTRUMENTATION
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+/// Reads a low-overhead, monotonic tick counter.
+/** On x86 and ARM64 this is the timestamp counter of the CPU, otherwise
+  * nanoseconds from `std::chrono::steady_clock`. Ticks are only meant to be
+  * compared with each other.
+  */
+inline std::uint64_t readTicks();
+
+
+/// Statistics collected by a Probe at a given instant.
+struct ProbeSnapshot {
+  std::string name; ///< Name of the probe.
+  std::uint64_t samples; ///< Number of filtered samples.
+  std::uint64_t blocks; ///< Number of timed blocks.
+  std::uint64_t ticks; ///< Total ticks spent in the timed blocks.
+  std::uint64_t nans; ///< Number of NaN outputs.
+  std::uint64_t infinities; ///< Number of infinite outputs.
+  std::uint64_t denormals; ///< Number of denormal (subnormal) outputs.
+  /// Latency histogram of the timed blocks.
+  /** Entry \f$ i>0 \f$ counts the blocks that took between \f$ 2^i \f$ and
+    * \f$ 2^{i+1}-1 \f$ ticks, while entry zero counts the ones that took
+    * less than two ticks. The last entry also counts all longer blocks.
+    */
+  std::vector<std::uint64_t> latency;
+
+  /// Whether NaN or infinite outputs were produced, *e.g.*, by an unstable
+  /// filter.
+  inline bool diverged() const { return nans > 0 || infinities > 0; }
+};
+
+
+/// Collects runtime statistics of one or more filters.
+/** Probes are attached to filters via `setProbe()`. Copies of a filter share
+  * its probe, and so do the copies used by the workers of a BatchFilter.
+  * Counters are atomic, hence filters running in different threads can
+  * report to the same probe.
+  *
+  * Blocks of samples are timed with readTicks(), while single samples are
+  * only counted: reading the counter would cost as much as the step of a
+  * low order filter. All outputs are checked for NaN, infinite and denormal
+  * values (the latter slow down arithmetic by orders of magnitude on many
+  * CPUs).
+  */
+class Probe {
+public:
+  /// Number of entries in the latency histogram.
+  static constexpr std::size_t bins = 40;
+
+  /// Creates a probe with all counters set to zero.
+  explicit Probe(
+    const std::string& name
+  );
+
+  /// Name used to identify the probe in snapshots.
+  inline const std::string& name() const { return name_; }
+
+  /// Count a single output and check its value.
+  template <class DataType>
+  void recordSample(
+    const DataType& y
+  );
+
+  /// Count a block of outputs, check their values and record its duration.
+  /** @param y pointer to `n` output samples.
+    * @param n number of samples in the block.
+    * @param ticks duration of the block, see readTicks().
+    */
+  template <class DataType>
+  void recordBlock(
+    const DataType* y,
+    std::size_t n,
+    std::uint64_t ticks
+  );
+
+  /// Copy the current value of all counters.
+  /** Counters are read one at a time: while filters are running, the
+    * snapshot might include only part of the latest samples.
+    */
+  ProbeSnapshot snapshot() const;
+
+  /// Set all counters to zero.
+  void reset();
+
+private:
+  /// Count NaN, infinite and denormal values in a block.
+  template <class DataType>
+  void classify(
+    const DataType* y,
+    std::size_t n
+  );
+
+  std::string name_; ///< Name of the probe.
+  std::atomic<std::uint64_t> samples_; ///< Number of samples.
+  std::atomic<std::uint64_t> blocks_; ///< Number of timed blocks.
+  std::atomic<std::uint64_t> ticks_; ///< Total duration of the blocks.
+  std::atomic<std::uint64_t> nans_; ///< Number of NaN outputs.
+  std::atomic<std::uint64_t> infinities_; ///< Number of infinite outputs.
+  std::atomic<std::uint64_t> denormals_; ///< Number of denormal outputs.
+  std::array<std::atomic<std::uint64_t>,bins> latency_; ///< Histogram.
+};
+
+
+/// Collection of named probes, which can be scraped all at once.
+class ProbeRegistry {
+public:
+  /// Registry shared by the whole program.
+  static ProbeRegistry& global();
+
+  /// Returns the probe with the given name, creating it if needed.
+  std::shared_ptr<Probe> probe(
+    const std::string& name
+  );
+
+  /// Snapshots of all probes, sorted by name.
+  std::vector<ProbeSnapshot> snapshot() const;
+
+  /// Set the counters of all probes to zero.
+  void reset();
+
+private:
+  mutable std::mutex mutex_; ///< Protects `probes_`.
+  std::map<std::string,std::shared_ptr<Probe>> probes_; ///< Probes by name.
+};
+
+
+/// Times a block of outputs from its creation to its destruction.
+/** This is the hook placed in block filtering methods, see
+  * DIGITAL_FILTERS_PROBE_BLOCK. If the probe is null, nothing is recorded.
+  */
+template <class DataType>
+class ProbeScope {
+public:
+  /// Starts timing a block.
+  /** @param probe probe that receives the statistics. It can be null.
+    * @param y pointer to `n` outputs, checked when the scope ends.
+    * @param n number of outputs.
+    */
+  ProbeScope(
+    Probe* probe,
+    const DataType* y,
+    std::size_t n
+  )
+  : probe_(probe)
+  , y_(y)
+  , n_(n)
+  , start_(probe ? readTicks() : 0)
+  {}
+
+  /// Records the block in the probe.
+  ~ProbeScope() {
+    if(probe_)
+      probe_->recordBlock(y_, n_, readTicks() - start_);
+  }
+
+  ProbeScope(const ProbeScope&) = delete;
+  ProbeScope& operator=(const ProbeScope&) = delete;
+
+private:
+  Probe* probe_; ///< Destination of the statistics.
+  const DataType* y_; ///< Outputs of the block.
+  std::size_t n_; ///< Number of outputs.
+  std::uint64_t start_; ///< Ticks at the beginning of the block.
+};
+
+} // namespace digital_filters
+
+
+#ifdef DIGITAL_FILTERS_INSTRUMENTATION
+/// Times the rest of the enclosing scope as a block of `n` outputs `y`.
+#define DIGITAL_FILTERS_PROBE_BLOCK(probe, y, n) \
+  digital_filters::ProbeScope digital_filters_probe_scope_((probe).get(), (y), (n))
+/// Counts the output `y` of a single step.
+#define DIGITAL_FILTERS_PROBE_SAMPLE(probe, y) \
+  do { if(probe) (probe)->recordSample(y); } while(false)
+#else
+#define DIGITAL_FILTERS_PROBE_BLOCK(probe, y, n) ((void)0)
+#define DIGITAL_FILTERS_PROBE_SAMPLE(probe, y) ((void)0)
+#endif
+
+#include <digital_filters/instrumentation.hxx>
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#else
+#include <chrono>
+#endif
+
+
+namespace digital_filters {
+
+inline std::uint64_t readTicks()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  std::uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()
+  ).count();
+#endif
+}
+
+
+inline Probe::Probe(
+  const std::string& name
+)
+: name_(name)
+{
+  reset();
+}
+
+
+template <class DataType>
+void Probe::recordSample(
+  const DataType& y
+)
+{
+  samples_.fetch_add(1, std::memory_order_relaxed);
+  classify(&y, 1);
+}
+
+
+template <class DataType>
+void Probe::recordBlock(
+  const DataType* y,
+  std::size_t n,
+  std::uint64_t ticks
+)
+{
+  samples_.fetch_add(n, std::memory_order_relaxed);
+  blocks_.fetch_add(1, std::memory_order_relaxed);
+  ticks_.fetch_add(ticks, std::memory_order_relaxed);
+  // index of the most significant bit
+  std::size_t bin = 0;
+  while(ticks > 1 && bin < bins-1) {
+    ticks >>= 1;
+    bin++;
+  }
+  latency_[bin].fetch_add(1, std::memory_order_relaxed);
+  classify(y, n);
+}
+
+
+template <class DataType>
+void Probe::classify(
+  const DataType* y,
+  std::size_t n
+)
+{
+  // only floating point values can be NaN, infinite or denormal
+  if constexpr(std::is_floating_point<DataType>::value) {
+    std::uint64_t nans = 0, infinities = 0, denormals = 0;
+    for(std::size_t k=0; k<n; k++) {
+      switch(std::fpclassify(y[k])) {
+        case FP_NAN: nans++; break;
+        case FP_INFINITE: infinities++; break;
+        case FP_SUBNORMAL: denormals++; break;
+        default: break;
+      }
+    }
+    // avoid touching shared counters in the common case
+    if(nans > 0)
+      nans_.fetch_add(nans, std::memory_order_relaxed);
+    if(infinities > 0)
+      infinities_.fetch_add(infinities, std::memory_order_relaxed);
+    if(denormals > 0)
+      denormals_.fetch_add(denormals, std::memory_order_relaxed);
+  }
+}
+
+
+inline ProbeSnapshot Probe::snapshot() const
+{
+  ProbeSnapshot s;
+  s.name = name_;
+  s.samples = samples_.load(std::memory_order_relaxed);
+  s.blocks = blocks_.load(std::memory_order_relaxed);
+  s.ticks = ticks_.load(std::memory_order_relaxed);
+  s.nans = nans_.load(std::memory_order_relaxed);
+  s.infinities = infinities_.load(std::memory_order_relaxed);
+  s.denormals = denormals_.load(std::memory_order_relaxed);
+  s.latency.resize(bins);
+  for(std::size_t i=0; i<bins; i++)
+    s.latency[i] = latency_[i].load(std::memory_order_relaxed);
+  return s;
+}
+
+
+inline void Probe::reset()
+{
+  samples_ = 0;
+  blocks_ = 0;
+  ticks_ = 0;
+  nans_ = 0;
+  infinities_ = 0;
+  denormals_ = 0;
+  for(auto& count : latency_)
+    count = 0;
+}
+
+
+inline ProbeRegistry& ProbeRegistry::global()
+{
+  static ProbeRegistry registry;
+  return registry;
+}
+
+
+inline std::shared_ptr<Probe> ProbeRegistry::probe(
+  const std::string& name
+)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& probe = probes_[name];
+  if(!probe)
+    probe = std::make_shared<Probe>(name);
+  return probe;
+}
+
+
+inline std::vector<ProbeSnapshot> ProbeRegistry::snapshot() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<ProbeSnapshot> snapshots;
+  snapshots.reserve(probes_.size());
+  for(const auto& entry : probes_)
+    snapshots.push_back(entry.second->snapshot());
+  return snapshots;
+}
+
+
+inline void ProbeRegistry::reset()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for(auto& entry : probes_)
+    entry.second->reset();
+}
+
+} // namespace digital_filters
@@ -0,0 +1,241 @@
+/** @file moving_average.hpp
+  * @brief Header file containing the MovingAverage and MovingAverageBank
+  *   classes.
+  */
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace digital_filters {
+
+/// Strategies used to keep running sums accurate.
+/** A running sum is updated by adding the newest sample and subtracting the
+  * oldest one. With floating point types, each update introduces a small
+  * rounding error, and these errors accumulate over time.
+  */
+enum class Summation {
+  /// Plain running sum: fastest, but rounding errors are never corrected.
+  Running,
+  /// Running sum with Neumaier's compensation of rounding errors.
+  Compensated,
+  /// Running sum recomputed from scratch once per window.
+  /** The cost is still constant per sample on average, and the error cannot
+    * accumulate for more than one window.
+    */
+  Periodic
+};
+
+
+/// Moving average evaluated via a running sum.
+/** This class produces the same output as the filter returned by
+  * average(int,const CoeffType&), but each sample costs a constant number of
+  * operations, independently of the size of the window. It exposes the same
+  * methods of Filter, so that it can be used in place of it.
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the gain of the filter.
+  */
+template <class DataType, class CoeffType>
+class MovingAverage {
+public:
+  /// Creates a moving average filter.
+  /** @param window_size number of averaged samples.
+    * @param gain static gain of the filter.
+    * @param summation strategy used to bound rounding errors.
+    */
+  MovingAverage(
+    int window_size,
+    const CoeffType& gain = CoeffType(1),
+    Summation summation = Summation::Periodic
+  );
+
+  /// Change filter template types.
+  /** @tparam OtherDataType new type of the input/output signals.
+    * @tparam OtherCoeffType new type of the gain.
+    * @return A copy of the current filter, including its internal state, but
+    *   with different template types.
+    */
+  template <class OtherDataType, class OtherCoeffType>
+  MovingAverage<OtherDataType,OtherCoeffType> as() const;
+
+  /// Number of averaged samples.
+  inline std::size_t windowSize() const { return buffer_.size(); }
+
+  /// Static gain of the filter.
+  inline const CoeffType& gain() const { return gain_; }
+
+  /// Numerator of the equivalent transfer function.
+  /** @note The numerator has as many elements as the window size, and it is
+    *   created on each call.
+    */
+  std::vector<CoeffType> numerator() const;
+
+  /// Denominator of the equivalent transfer function.
+  std::vector<CoeffType> denominator() const;
+
+  /// Set initial conditions on the input.
+  /** @see Filter::initInput(const DataType&)
+    */
+  void initInput(
+    const DataType& input
+  );
+
+  /// Set initial conditions on the input.
+  /** @param input the `windowSize()-1` past inputs, in time-ascending order.
+    * @see Filter::initInput(const std::vector<DataType>&)
+    */
+  void initInput(
+    const std::vector<DataType>& input
+  );
+
+  /// Set initial conditions on the output.
+  /** Provided for compatibility with Filter: since the filter has no
+    * recursive part, this method has no effect.
+    */
+  void initOutput(
+    const DataType& output
+  );
+
+  /// Set initial conditions on the output.
+  /** Provided for compatibility with Filter: since the filter has no
+    * recursive part, `output` must be empty.
+    */
+  void initOutput(
+    const std::vector<DataType>& output
+  );
+
+  /// Filter the current input.
+  const DataType& filter(
+    const DataType& x
+  );
+
+  /// Filter a block of samples.
+  /** @param x_in pointer to `n` input samples.
+    * @param y_out pointer to `n` output samples. It can be equal to `x_in`.
+    * @param n number of samples in the block.
+    * @see Filter::filter(const DataType*, DataType*, std::size_t)
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  );
+
+  /// Filter a whole sequence.
+  /** @see Filter::filter(const std::vector<DataType>&, const std::vector<DataType>&, const std::vector<DataType>&)
+    */
+  std::vector<DataType> filter(
+    const std::vector<DataType>& x,
+    const std::vector<DataType>& x0,
+    const std::vector<DataType>& y0
+  ) const;
+
+  /// Bi-directional filtering of a whole sequence.
+  /** The signal is held constant on both sides.
+    * @see Filter::filter2()
+    */
+  std::vector<DataType> filter2(
+    const std::vector<DataType>& x
+  ) const;
+
+private:
+  // Allow conversions between filters with different template types.
+  template <class OtherDataType, class OtherCoeffType>
+  friend class MovingAverage;
+
+  /// Sets the sum and the compensation term from the content of the buffer.
+  void resum();
+
+  CoeffType gain_; ///< Static gain of the filter.
+  CoeffType scale_; ///< Gain divided by the size of the window.
+  Summation summation_; ///< Strategy used to bound rounding errors.
+  std::vector<DataType> buffer_; ///< Last inputs, in a ring buffer.
+  std::size_t head_; ///< Position of the oldest input in the buffer.
+  std::size_t count_; ///< Samples since the last resummation.
+  DataType sum_; ///< Running sum.
+  DataType compensation_; ///< Accumulated rounding error of the sum.
+  DataType y_; ///< Last output.
+};
+
+
+/// Moving average applied to many channels at once.
+/** All channels share the same window size and gain. The buffers are stored
+  * so that the samples of all channels at a given time are contiguous, which
+  * allows the compiler to vectorize the updates of the running sums.
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the gain of the filter.
+  */
+template <class DataType, class CoeffType>
+class MovingAverageBank {
+public:
+  /// Creates a bank of moving average filters.
+  /** @param window_size number of averaged samples.
+    * @param channels number of channels in the bank.
+    * @param gain static gain of the filters.
+    * @param summation strategy used to bound rounding errors.
+    */
+  MovingAverageBank(
+    int window_size,
+    std::size_t channels,
+    const CoeffType& gain = CoeffType(1),
+    Summation summation = Summation::Periodic
+  );
+
+  /// Number of channels in the bank.
+  inline std::size_t channels() const { return channels_; }
+
+  /// Number of averaged samples.
+  inline std::size_t windowSize() const { return window_; }
+
+  /// Set all past inputs of each channel to the given values.
+  /** @param input pointer to one value per channel.
+    */
+  void initInput(
+    const DataType* input
+  );
+
+  /// Filter one sample per channel.
+  /** @param x_in pointer to one input sample per channel.
+    * @param y_out pointer to one output sample per channel. It can be equal
+    *   to `x_in`.
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out
+  );
+
+  /// Filter multiple samples per channel.
+  /** @param x_in pointer to `frames*channels()` interleaved input samples.
+    * @param y_out pointer to `frames*channels()` interleaved output samples.
+    *   It can be equal to `x_in`.
+    * @param frames number of samples per channel.
+    * @see FilterBank::filter(const DataType*, DataType*, std::size_t)
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t frames
+  );
+
+private:
+  /// Sets the sums and the compensation terms from the buffers.
+  void resum();
+
+  std::size_t window_; ///< Number of averaged samples.
+  std::size_t channels_; ///< Number of channels in the bank.
+  CoeffType scale_; ///< Gain divided by the size of the window.
+  Summation summation_; ///< Strategy used to bound rounding errors.
+  /// Last inputs of each channel.
+  /** The sample stored in the slot \f$ s \f$ for the channel \f$ c \f$ is
+    * `buffer_[s*channels_+c]`.
+    */
+  std::vector<DataType> buffer_;
+  std::size_t head_; ///< Slot of the oldest inputs in the buffer.
+  std::size_t count_; ///< Samples since the last resummation.
+  std::vector<DataType> sum_; ///< Running sums.
+  std::vector<DataType> compensation_; ///< Rounding errors of the sums.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/moving_average.hxx>
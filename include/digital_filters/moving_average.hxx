@@ -0,0 +1,344 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <digital_filters/utilities.hpp>
+
+
+namespace digital_filters {
+
+template<class DataType, class CoeffType>
+MovingAverage<DataType,CoeffType>::MovingAverage(
+  int window_size,
+  const CoeffType& gain,
+  Summation summation
+)
+: gain_(gain)
+, summation_(summation)
+, head_(0)
+, count_(0)
+, sum_()
+, compensation_()
+, y_()
+{
+  if(window_size < 1) {
+    throw std::runtime_error(
+      "MovingAverage: the window size must be positive, but " +
+      std::to_string(window_size) + " was given"
+    );
+  }
+  scale_ = gain_ / static_cast<CoeffType>(window_size);
+  buffer_.assign(window_size, DataType());
+}
+
+
+template<class DataType, class CoeffType>
+template<class OtherDataType, class OtherCoeffType>
+MovingAverage<OtherDataType,OtherCoeffType> MovingAverage<DataType,CoeffType>::as() const
+{
+  MovingAverage<OtherDataType,OtherCoeffType> filter(
+    buffer_.size(),
+    static_cast<OtherCoeffType>(gain_),
+    summation_
+  );
+  filter.buffer_.assign(buffer_.begin(), buffer_.end());
+  filter.head_ = head_;
+  filter.count_ = count_;
+  filter.sum_ = static_cast<OtherDataType>(sum_);
+  filter.compensation_ = static_cast<OtherDataType>(compensation_);
+  filter.y_ = static_cast<OtherDataType>(y_);
+  return filter;
+}
+
+
+template<class DataType, class CoeffType>
+std::vector<CoeffType> MovingAverage<DataType,CoeffType>::numerator() const
+{
+  return std::vector<CoeffType>(buffer_.size(), gain_);
+}
+
+
+template<class DataType, class CoeffType>
+std::vector<CoeffType> MovingAverage<DataType,CoeffType>::denominator() const
+{
+  return {static_cast<CoeffType>(buffer_.size())};
+}
+
+
+template<class DataType, class CoeffType>
+void MovingAverage<DataType,CoeffType>::initInput(
+  const DataType& input
+)
+{
+  std::fill(buffer_.begin(), buffer_.end(), input);
+  resum();
+}
+
+
+template<class DataType, class CoeffType>
+void MovingAverage<DataType,CoeffType>::initInput(
+  const std::vector<DataType>& input
+)
+{
+  // check sizes
+  if(input.size() != buffer_.size()-1) {
+    throw std::runtime_error(
+      "MovingAverage::initInput: 'input' has " + std::to_string(input.size()) +
+      " elements, but only " + std::to_string(buffer_.size()-1) +
+      " elements are allowed"
+    );
+  }
+  // The oldest slot is overwritten by the next input: leave it empty so that
+  // it does not contribute to the sum.
+  head_ = 0;
+  buffer_[0] = DataType();
+  std::copy(input.begin(), input.end(), buffer_.begin()+1);
+  resum();
+}
+
+
+template<class DataType, class CoeffType>
+void MovingAverage<DataType,CoeffType>::initOutput(
+  const DataType&
+)
+{
+}
+
+
+template<class DataType, class CoeffType>
+void MovingAverage<DataType,CoeffType>::initOutput(
+  const std::vector<DataType>& output
+)
+{
+  // check sizes
+  if(output.size() != 0) {
+    throw std::runtime_error(
+      "MovingAverage::initOutput: 'output' has " +
+      std::to_string(output.size()) + " elements, but only 0 elements are " +
+      "allowed"
+    );
+  }
+}
+
+
+template<class DataType, class CoeffType>
+const DataType& MovingAverage<DataType,CoeffType>::filter(
+  const DataType& x
+)
+{
+  filter(&x, &y_, 1);
+  return y_;
+}
+
+
+template<class DataType, class CoeffType>
+void MovingAverage<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+)
+{
+  const std::size_t window = buffer_.size();
+  std::size_t k = 0;
+  while(k < n) {
+    // process samples until the ring buffer wraps around (or until the next
+    // resummation), so that the inner loops have no branches
+    std::size_t len = std::min(n-k, window-head_);
+    if(summation_ == Summation::Periodic)
+      len = std::min(len, window-count_);
+    DataType* buf = buffer_.data() + head_;
+    if(summation_ == Summation::Compensated) {
+      for(std::size_t i=0; i<len; i++) {
+        const DataType x = x_in[k+i];
+        compensatedAdd(sum_, compensation_, x);
+        compensatedAdd(sum_, compensation_, -buf[i]);
+        buf[i] = x;
+        y_out[k+i] = scale_ * (sum_ + compensation_);
+      }
+    }
+    else {
+      for(std::size_t i=0; i<len; i++) {
+        const DataType x = x_in[k+i];
+        sum_ = sum_ + (x - buf[i]);
+        buf[i] = x;
+        y_out[k+i] = scale_ * sum_;
+      }
+    }
+    k += len;
+    head_ += len;
+    if(head_ == window)
+      head_ = 0;
+    if(summation_ == Summation::Periodic) {
+      count_ += len;
+      if(count_ == window)
+        resum();
+    }
+  }
+  if(n > 0)
+    y_ = y_out[n-1];
+}
+
+
+template<class DataType, class CoeffType>
+std::vector<DataType> MovingAverage<DataType,CoeffType>::filter(
+  const std::vector<DataType>& x,
+  const std::vector<DataType>& x0,
+  const std::vector<DataType>& y0
+) const
+{
+  // work on a copy, so that the internal state is not affected
+  MovingAverage<DataType,CoeffType> copy(*this);
+  copy.initInput(x0);
+  copy.initOutput(y0);
+  std::vector<DataType> y(x.size());
+  copy.filter(x.data(), y.data(), x.size());
+  return y;
+}
+
+
+template<class DataType, class CoeffType>
+std::vector<DataType> MovingAverage<DataType,CoeffType>::filter2(
+  const std::vector<DataType>& x
+) const
+{
+  // filter on one side
+  std::vector<DataType> y = filter(
+    x,
+    std::vector<DataType>(buffer_.size()-1, x.at(0)),
+    {}
+  );
+  // reverse the signal
+  std::reverse(y.begin(), y.end());
+  // filter again
+  std::vector<DataType> z = filter(
+    y,
+    std::vector<DataType>(buffer_.size()-1, y.at(0)),
+    {}
+  );
+  // reverse the final result and return it
+  std::reverse(z.begin(), z.end());
+  return z;
+}
+
+
+template<class DataType, class CoeffType>
+void MovingAverage<DataType,CoeffType>::resum()
+{
+  sum_ = DataType();
+  compensation_ = DataType();
+  if(summation_ == Summation::Compensated) {
+    for(const auto& val : buffer_)
+      compensatedAdd(sum_, compensation_, val);
+  }
+  else {
+    for(const auto& val : buffer_)
+      sum_ = sum_ + val;
+  }
+  count_ = 0;
+}
+
+
+template<class DataType, class CoeffType>
+MovingAverageBank<DataType,CoeffType>::MovingAverageBank(
+  int window_size,
+  std::size_t channels,
+  const CoeffType& gain,
+  Summation summation
+)
+: channels_(channels)
+, summation_(summation)
+, head_(0)
+, count_(0)
+, sum_(channels, DataType())
+, compensation_(channels, DataType())
+{
+  if(window_size < 1) {
+    throw std::runtime_error(
+      "MovingAverageBank: the window size must be positive, but " +
+      std::to_string(window_size) + " was given"
+    );
+  }
+  window_ = window_size;
+  scale_ = gain / static_cast<CoeffType>(window_size);
+  buffer_.assign(window_*channels_, DataType());
+}
+
+
+template<class DataType, class CoeffType>
+void MovingAverageBank<DataType,CoeffType>::initInput(
+  const DataType* input
+)
+{
+  for(std::size_t s=0; s<window_; s++)
+    std::copy(input, input+channels_, buffer_.begin()+s*channels_);
+  resum();
+}
+
+
+template<class DataType, class CoeffType>
+void MovingAverageBank<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out
+)
+{
+  DataType* buf = buffer_.data() + head_*channels_;
+  DataType* sum = sum_.data();
+  if(summation_ == Summation::Compensated) {
+    DataType* comp = compensation_.data();
+    for(std::size_t c=0; c<channels_; c++) {
+      const DataType x = x_in[c];
+      compensatedAdd(sum[c], comp[c], x);
+      compensatedAdd(sum[c], comp[c], -buf[c]);
+      buf[c] = x;
+      y_out[c] = scale_ * (sum[c] + comp[c]);
+    }
+  }
+  else {
+    // contiguous and independent updates: this loop is vectorized
+    for(std::size_t c=0; c<channels_; c++) {
+      const DataType x = x_in[c];
+      sum[c] = sum[c] + (x - buf[c]);
+      buf[c] = x;
+      y_out[c] = scale_ * sum[c];
+    }
+  }
+  if(++head_ == window_)
+    head_ = 0;
+  if(summation_ == Summation::Periodic && ++count_ == window_)
+    resum();
+}
+
+
+template<class DataType, class CoeffType>
+void MovingAverageBank<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t frames
+)
+{
+  for(std::size_t f=0; f<frames; f++)
+    filter(x_in + f*channels_, y_out + f*channels_);
+}
+
+
+template<class DataType, class CoeffType>
+void MovingAverageBank<DataType,CoeffType>::resum()
+{
+  std::fill(sum_.begin(), sum_.end(), DataType());
+  std::fill(compensation_.begin(), compensation_.end(), DataType());
+  for(std::size_t s=0; s<window_; s++) {
+    const DataType* buf = buffer_.data() + s*channels_;
+    if(summation_ == Summation::Compensated) {
+      for(std::size_t c=0; c<channels_; c++)
+        compensatedAdd(sum_[c], compensation_[c], buf[c]);
+    }
+    else {
+      for(std::size_t c=0; c<channels_; c++)
+        sum_[c] = sum_[c] + buf[c];
+    }
+  }
+  count_ = 0;
+}
+
+} // namespace digital_filters
@@ -0,0 +1,404 @@
+/** @file multirate.hpp
+  * @brief Header file containing filters that change the sampling rate.
+  */
+#pragma once
+
+#include <digital_filters/filter.hpp>
+#include <digital_filters/sos_filter.hpp>
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+namespace digital_filters {
+
+/// Number of outputs produced by `n` inputs, when decimating by `factor`.
+/** An output is produced whenever an input arrives while `phase` is zero,
+  * `phase` being the number of inputs received since the last output.
+  */
+inline std::size_t decimatedOutputs(
+  std::size_t n,
+  unsigned int factor,
+  unsigned int phase
+);
+
+
+/// FIR filter followed by a decimation.
+/** The filter keeps one output every `factor()` samples, *i.e.*, the outputs
+  * \f$ y_m = \sum_i h_i x_{mM-i} \f$, with \f$ M \f$ being the decimation
+  * factor. Only these outputs are evaluated, which is equivalent to the
+  * polyphase realization: the cost per input sample is the number of taps
+  * divided by the factor. The first input sample produces the first output.
+  *
+  * Inputs are stored in a mirrored ring buffer (as in the Direct Form I of
+  * Filter), hence no memory is allocated while filtering.
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the coefficients of the filter.
+  * @see firDecimator() to design an anti-aliasing filter.
+  */
+template <class DataType, class CoeffType>
+class FirDecimator {
+public:
+  /// Type used to accumulate the products between coefficients and samples.
+  typedef typename Filter<DataType,CoeffType>::Accumulator Accumulator;
+
+  /// Generates a decimator from given coefficients.
+  /** @param taps impulse response of the filter, at the input rate.
+    * @param factor decimation factor. It must be positive.
+    */
+  FirDecimator(
+    const std::vector<CoeffType>& taps,
+    unsigned int factor
+  );
+
+  /// Decimation factor.
+  inline unsigned int factor() const { return factor_; }
+
+  /// Impulse response of the filter, at the input rate.
+  inline const std::vector<CoeffType>& taps() const { return taps_; }
+
+  /// Set the past inputs to zero and restart from the first phase.
+  void reset();
+
+  /// Number of outputs produced by the next `n` input samples.
+  std::size_t outputs(
+    std::size_t n
+  ) const;
+
+  /// Filter one input sample.
+  /** @param x input sample.
+    * @param[out] y set to the new output, if any.
+    * @return whether an output was produced.
+    */
+  bool filter(
+    const DataType& x,
+    DataType& y
+  );
+
+  /// Filter a block of samples.
+  /** @param x_in pointer to `n` input samples.
+    * @param y_out pointer to (at least) `outputs(n)` output samples. It can
+    *   be equal to `x_in`.
+    * @param n number of input samples.
+    * @return number of outputs written into `y_out`.
+    */
+  std::size_t filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  );
+
+private:
+  std::vector<CoeffType> taps_; ///< Impulse response.
+  unsigned int factor_; ///< Decimation factor.
+  std::vector<DataType> history_; ///< Mirrored ring buffer of past inputs.
+  std::size_t head_; ///< Position of the most recent input in `history_`.
+  unsigned int phase_; ///< Inputs received since the last output.
+};
+
+
+/// Upsampling followed by an FIR filter, using a polyphase realization.
+/** Each input sample produces `factor()` outputs. Conceptually, \f$ L-1 \f$
+  * zeros are inserted after each sample and the result is filtered at the
+  * output rate. The polyphase realization skips the products by zero: the
+  * \f$ p \f$-th output of each input uses the branch
+  * \f$ h_p, h_{p+L}, h_{p+2L}, \cdots \f$ only.
+  *
+  * Note that the inserted zeros reduce the static gain by \f$ L \f$: filters
+  * meant to preserve the amplitude of the signal must have a static gain of
+  * \f$ L \f$, as the ones returned by firInterpolator().
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the coefficients of the filter.
+  */
+template <class DataType, class CoeffType>
+class FirInterpolator {
+public:
+  /// Type used to accumulate the products between coefficients and samples.
+  typedef typename Filter<DataType,CoeffType>::Accumulator Accumulator;
+
+  /// Generates an interpolator from given coefficients.
+  /** @param taps impulse response of the filter, at the output rate.
+    * @param factor interpolation factor. It must be positive.
+    */
+  FirInterpolator(
+    const std::vector<CoeffType>& taps,
+    unsigned int factor
+  );
+
+  /// Interpolation factor.
+  inline unsigned int factor() const { return factor_; }
+
+  /// Impulse response of the filter, at the output rate.
+  inline const std::vector<CoeffType>& taps() const { return taps_; }
+
+  /// Set the past inputs to zero.
+  void reset();
+
+  /// Filter one input sample.
+  /** @param x input sample.
+    * @param y_out pointer to `factor()` output samples.
+    */
+  void filter(
+    const DataType& x,
+    DataType* y_out
+  );
+
+  /// Filter a block of samples.
+  /** @param x_in pointer to `n` input samples.
+    * @param y_out pointer to `n*factor()` output samples. It must not
+    *   overlap with the input.
+    * @param n number of input samples.
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  );
+
+private:
+  std::vector<CoeffType> taps_; ///< Impulse response.
+  unsigned int factor_; ///< Interpolation factor.
+  std::size_t length_; ///< Number of taps of each branch.
+  /// Coefficients of the branches.
+  /** The \f$ j \f$-th coefficient of the branch \f$ p \f$ is stored in
+    * `branches_[p*length_+j]`, and it is zero past the end of the filter.
+    */
+  std::vector<CoeffType> branches_;
+  std::vector<DataType> history_; ///< Mirrored ring buffer of past inputs.
+  std::size_t head_; ///< Position of the most recent input in `history_`.
+};
+
+
+/// Cascaded integrator-comb decimator.
+/** A CIC filter of order \f$ N \f$, decimation factor \f$ R \f$ and
+  * differential delay \f$ M \f$ has the transfer function:
+  * \f[
+  *   H(z) = \left( \frac{1 - z^{-RM}}{1 - z^{-1}} \right)^N
+  *        = \left( \sum_{k=0}^{RM-1} z^{-k} \right)^N
+  * \f]
+  * *i.e.*, it is a cascade of \f$ N \f$ moving sums. It is evaluated with
+  * \f$ N \f$ integrators at the input rate and \f$ N \f$ combs at the output
+  * rate, so that the cost does not depend on the factor and no
+  * multiplication is needed. This makes it suitable for large factors,
+  * usually followed by a short FIR filter that compensates its droop.
+  *
+  * The integrators overflow by design: arithmetic is modular, and the result
+  * is correct as long as the output fits in `Integer`. This requires
+  * \f$ N \log_2(RM) \f$ bits on top of the ones used by the input (see
+  * bitGrowth()). For this reason, only integer types are supported.
+  * @tparam Integer integer type of the input/output signals.
+  */
+template <class Integer>
+class CicDecimator {
+  static_assert(std::is_integral<Integer>::value, "CicDecimator: the data type must be an integer");
+public:
+  /// Generates a CIC decimator.
+  /** @param stages number of integrator/comb pairs \f$ N \f$.
+    * @param factor decimation factor \f$ R \f$.
+    * @param differential_delay delay \f$ M \f$ of the combs, at the output
+    *   rate.
+    * @note An exception is thrown if any of the parameters is zero.
+    */
+  CicDecimator(
+    unsigned int stages,
+    unsigned int factor,
+    unsigned int differential_delay = 1
+  );
+
+  /// Number of integrator/comb pairs.
+  inline unsigned int stages() const { return stages_; }
+
+  /// Decimation factor.
+  inline unsigned int factor() const { return factor_; }
+
+  /// Delay of the combs, at the output rate.
+  inline unsigned int differentialDelay() const { return delay_; }
+
+  /// Static gain \f$ (RM)^N \f$ of the filter.
+  double gain() const;
+
+  /// Number of bits \f$ \lceil N \log_2(RM) \rceil \f$ added by the filter.
+  unsigned int bitGrowth() const;
+
+  /// Set the state of integrators and combs to zero.
+  void reset();
+
+  /// Number of outputs produced by the next `n` input samples.
+  std::size_t outputs(
+    std::size_t n
+  ) const;
+
+  /// Filter one input sample.
+  /** @param x input sample.
+    * @param[out] y set to the new output, if any.
+    * @return whether an output was produced.
+    */
+  bool filter(
+    const Integer& x,
+    Integer& y
+  );
+
+  /// Filter a block of samples.
+  /** @param x_in pointer to `n` input samples.
+    * @param y_out pointer to (at least) `outputs(n)` output samples. It can
+    *   be equal to `x_in`.
+    * @param n number of input samples.
+    * @return number of outputs written into `y_out`.
+    */
+  std::size_t filter(
+    const Integer* x_in,
+    Integer* y_out,
+    std::size_t n
+  );
+
+private:
+  /// Unsigned arithmetic wraps around without undefined behavior.
+  typedef typename std::make_unsigned<Integer>::type Unsigned;
+
+  unsigned int stages_; ///< Number of integrator/comb pairs.
+  unsigned int factor_; ///< Decimation factor.
+  unsigned int delay_; ///< Delay of the combs.
+  std::vector<Unsigned> integrators_; ///< State of the integrators.
+  /// Past inputs of the combs.
+  /** The delay line of the stage \f$ s \f$ is stored in
+    * `combs_[s*delay_ ... (s+1)*delay_-1]`, and it is indexed by `comb_head_`.
+    */
+  std::vector<Unsigned> combs_;
+  unsigned int comb_head_; ///< Oldest element in the delay lines.
+  unsigned int phase_; ///< Inputs received since the last output.
+};
+
+
+/// IIR filter followed by a decimation.
+/** Since the filter is recursive, all its outputs must be evaluated: the
+  * block API of SosFilter is used to process the input in chunks, and one
+  * output every `factor()` is kept. Chunks are stored in a buffer allocated
+  * by the constructor, hence no memory is allocated while filtering.
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the coefficients of the filter.
+  * @see iirDecimator() to design an anti-aliasing filter.
+  */
+template <class DataType, class CoeffType>
+class IirDecimator {
+public:
+  /// Generates a decimator from a given filter.
+  /** @param filter anti-aliasing filter, at the input rate. Its state is
+    *   used as initial condition.
+    * @param factor decimation factor. It must be positive.
+    */
+  IirDecimator(
+    const SosFilter<DataType,CoeffType>& filter,
+    unsigned int factor
+  );
+
+  /// Decimation factor.
+  inline unsigned int factor() const { return factor_; }
+
+  /// Access the anti-aliasing filter.
+  inline const SosFilter<DataType,CoeffType>& design() const { return filter_; }
+
+  /// Set the state of the filter to zero and restart from the first phase.
+  void reset();
+
+  /// Number of outputs produced by the next `n` input samples.
+  std::size_t outputs(
+    std::size_t n
+  ) const;
+
+  /// Filter one input sample.
+  /** @param x input sample.
+    * @param[out] y set to the new output, if any.
+    * @return whether an output was produced.
+    */
+  bool filter(
+    const DataType& x,
+    DataType& y
+  );
+
+  /// Filter a block of samples.
+  /** @param x_in pointer to `n` input samples.
+    * @param y_out pointer to (at least) `outputs(n)` output samples. It can
+    *   be equal to `x_in`.
+    * @param n number of input samples.
+    * @return number of outputs written into `y_out`.
+    */
+  std::size_t filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  );
+
+private:
+  static constexpr std::size_t chunk_ = 256; ///< Samples filtered at once.
+  SosFilter<DataType,CoeffType> filter_; ///< Anti-aliasing filter.
+  unsigned int factor_; ///< Decimation factor.
+  unsigned int phase_; ///< Inputs received since the last output.
+  std::vector<DataType> chunk_buffer_; ///< Outputs of the filter.
+};
+
+
+/// Designs a low-pass FIR filter via the window method.
+/** The ideal impulse response \f$ 2 f_c \, \mathrm{sinc}(2 f_c n) \f$ is
+  * truncated to the given number of taps, centered, and multiplied by a
+  * Hamming window. The result is normalized so that the static gain is one.
+  * The delay introduced by the filter is `(taps-1)/2` samples.
+  * @param taps number of taps.
+  * @param cutoff cutoff frequency.
+  * @param sampling sampling frequency.
+  * @return impulse response of the filter.
+  * @note An exception is thrown if the cutoff frequency is not between zero
+  *   and half of the sampling frequency.
+  */
+template <class CoeffType>
+std::vector<CoeffType> windowedSinc(
+  unsigned int taps,
+  const CoeffType& cutoff,
+  const CoeffType& sampling
+);
+
+
+/// Returns an FIR decimator with an anti-aliasing filter.
+/** The cutoff frequency is the Nyquist frequency after the decimation,
+  * *i.e.*, `sampling/(2*factor)`, as in SciPy's `decimate`.
+  * @param factor decimation factor.
+  * @param taps number of taps; if zero, `20*factor+1` taps are used.
+  * @see windowedSinc()
+  */
+template <class DataType, class CoeffType>
+FirDecimator<DataType,CoeffType> firDecimator(
+  unsigned int factor,
+  unsigned int taps = 0
+);
+
+
+/// Returns an FIR interpolator with an anti-imaging filter.
+/** The cutoff frequency is the Nyquist frequency before the interpolation,
+  * and the static gain is `factor`, so that the amplitude of the signal is
+  * preserved.
+  * @param factor interpolation factor.
+  * @param taps number of taps; if zero, `20*factor+1` taps are used.
+  * @see windowedSinc()
+  */
+template <class DataType, class CoeffType>
+FirInterpolator<DataType,CoeffType> firInterpolator(
+  unsigned int factor,
+  unsigned int taps = 0
+);
+
+
+/// Returns an IIR decimator with a Butterworth anti-aliasing filter.
+/** The cutoff frequency is 80% of the Nyquist frequency after the
+  * decimation, as in SciPy's `decimate`. The filter is realized as a cascade
+  * of second-order sections, which is stable even for large factors.
+  * @param factor decimation factor.
+  * @param order order of the Butterworth filter.
+  * @see butterworthSos()
+  */
+template <class DataType, class CoeffType>
+IirDecimator<DataType,CoeffType> iirDecimator(
+  unsigned int factor,
+  unsigned int order = 8
+);
+
+} // namespace digital_filters
+
+#include <digital_filters/multirate.hxx>
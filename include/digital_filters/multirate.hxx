@@ -0,0 +1,417 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <digital_filters/filters_implementations/butterworth.hpp>
+
+
+namespace digital_filters {
+
+inline std::size_t decimatedOutputs(
+  std::size_t n,
+  unsigned int factor,
+  unsigned int phase
+)
+{
+  const std::size_t first = (factor - phase) % factor;
+  return n > first ? (n - first - 1) / factor + 1 : 0;
+}
+
+
+template<class DataType, class CoeffType>
+FirDecimator<DataType,CoeffType>::FirDecimator(
+  const std::vector<CoeffType>& taps,
+  unsigned int factor
+)
+: taps_(taps)
+, factor_(factor)
+, history_(2*taps.size())
+, head_(0)
+, phase_(0)
+{
+  if(taps_.empty())
+    throw std::runtime_error("FirDecimator: the impulse response is empty");
+  if(factor_ == 0)
+    throw std::runtime_error("FirDecimator: the decimation factor must be positive");
+}
+
+
+template<class DataType, class CoeffType>
+void FirDecimator<DataType,CoeffType>::reset()
+{
+  for(auto& x : history_)
+    x = DataType();
+  head_ = 0;
+  phase_ = 0;
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t FirDecimator<DataType,CoeffType>::outputs(
+  std::size_t n
+) const
+{
+  return decimatedOutputs(n, factor_, phase_);
+}
+
+
+template<class DataType, class CoeffType>
+bool FirDecimator<DataType,CoeffType>::filter(
+  const DataType& x,
+  DataType& y
+)
+{
+  // store the new input (twice, since the buffer is mirrored)
+  const std::size_t nt = taps_.size();
+  head_ = (head_ == 0 ? nt : head_) - 1;
+  history_[head_] = x;
+  history_[head_+nt] = x;
+
+  // evaluate the output only if it is kept
+  const bool output = phase_ == 0;
+  if(output) {
+    const DataType* xk = &history_[head_];
+    Accumulator acc = taps_[0] * xk[0];
+    for(std::size_t i=1; i<nt; i++)
+      acc = acc + taps_[i] * xk[i];
+    y = static_cast<DataType>(acc);
+  }
+  phase_ = phase_ + 1 == factor_ ? 0 : phase_ + 1;
+  return output;
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t FirDecimator<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+)
+{
+  // outputs are written after reading the corresponding input, hence the
+  // block can be filtered in-place
+  std::size_t count = 0;
+  for(std::size_t k=0; k<n; k++)
+    if(filter(x_in[k], y_out[count]))
+      count++;
+  return count;
+}
+
+
+template<class DataType, class CoeffType>
+FirInterpolator<DataType,CoeffType>::FirInterpolator(
+  const std::vector<CoeffType>& taps,
+  unsigned int factor
+)
+: taps_(taps)
+, factor_(factor)
+, head_(0)
+{
+  if(taps_.empty())
+    throw std::runtime_error("FirInterpolator: the impulse response is empty");
+  if(factor_ == 0)
+    throw std::runtime_error("FirInterpolator: the interpolation factor must be positive");
+
+  // split the impulse response into the branches
+  length_ = (taps_.size() + factor_ - 1) / factor_;
+  branches_.resize(factor_*length_, CoeffType(0));
+  for(std::size_t i=0; i<taps_.size(); i++)
+    branches_[(i % factor_)*length_ + i / factor_] = taps_[i];
+  history_.resize(2*length_);
+}
+
+
+template<class DataType, class CoeffType>
+void FirInterpolator<DataType,CoeffType>::reset()
+{
+  for(auto& x : history_)
+    x = DataType();
+  head_ = 0;
+}
+
+
+template<class DataType, class CoeffType>
+void FirInterpolator<DataType,CoeffType>::filter(
+  const DataType& x,
+  DataType* y_out
+)
+{
+  // store the new input (twice, since the buffer is mirrored)
+  head_ = (head_ == 0 ? length_ : head_) - 1;
+  history_[head_] = x;
+  history_[head_+length_] = x;
+
+  // each branch produces one output
+  const DataType* xk = &history_[head_];
+  for(unsigned int p=0; p<factor_; p++) {
+    const CoeffType* h = &branches_[p*length_];
+    Accumulator acc = h[0] * xk[0];
+    for(std::size_t j=1; j<length_; j++)
+      acc = acc + h[j] * xk[j];
+    y_out[p] = static_cast<DataType>(acc);
+  }
+}
+
+
+template<class DataType, class CoeffType>
+void FirInterpolator<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+)
+{
+  for(std::size_t k=0; k<n; k++)
+    filter(x_in[k], y_out + k*factor_);
+}
+
+
+template<class Integer>
+CicDecimator<Integer>::CicDecimator(
+  unsigned int stages,
+  unsigned int factor,
+  unsigned int differential_delay
+)
+: stages_(stages)
+, factor_(factor)
+, delay_(differential_delay)
+, integrators_(stages)
+, combs_(stages*differential_delay)
+, comb_head_(0)
+, phase_(0)
+{
+  if(stages_ == 0 || factor_ == 0 || delay_ == 0) {
+    throw std::runtime_error(
+      "CicDecimator: stages (" + std::to_string(stages) + "), factor (" +
+      std::to_string(factor) + ") and differential delay (" +
+      std::to_string(differential_delay) + ") must be positive"
+    );
+  }
+}
+
+
+template<class Integer>
+double CicDecimator<Integer>::gain() const
+{
+  return std::pow(static_cast<double>(factor_) * delay_, stages_);
+}
+
+
+template<class Integer>
+unsigned int CicDecimator<Integer>::bitGrowth() const
+{
+  return static_cast<unsigned int>(std::ceil(stages_ * std::log2(static_cast<double>(factor_) * delay_)));
+}
+
+
+template<class Integer>
+void CicDecimator<Integer>::reset()
+{
+  std::fill(integrators_.begin(), integrators_.end(), Unsigned(0));
+  std::fill(combs_.begin(), combs_.end(), Unsigned(0));
+  comb_head_ = 0;
+  phase_ = 0;
+}
+
+
+template<class Integer>
+std::size_t CicDecimator<Integer>::outputs(
+  std::size_t n
+) const
+{
+  return decimatedOutputs(n, factor_, phase_);
+}
+
+
+template<class Integer>
+bool CicDecimator<Integer>::filter(
+  const Integer& x,
+  Integer& y
+)
+{
+  // integrators, at the input rate
+  Unsigned v = static_cast<Unsigned>(x);
+  for(unsigned int s=0; s<stages_; s++) {
+    integrators_[s] += v;
+    v = integrators_[s];
+  }
+
+  // combs, at the output rate
+  const bool output = phase_ == 0;
+  if(output) {
+    for(unsigned int s=0; s<stages_; s++) {
+      Unsigned& delayed = combs_[s*delay_ + comb_head_];
+      const Unsigned u = v;
+      v = v - delayed;
+      delayed = u;
+    }
+    comb_head_ = comb_head_ + 1 == delay_ ? 0 : comb_head_ + 1;
+    y = static_cast<Integer>(v);
+  }
+  phase_ = phase_ + 1 == factor_ ? 0 : phase_ + 1;
+  return output;
+}
+
+
+template<class Integer>
+std::size_t CicDecimator<Integer>::filter(
+  const Integer* x_in,
+  Integer* y_out,
+  std::size_t n
+)
+{
+  std::size_t count = 0;
+  for(std::size_t k=0; k<n; k++)
+    if(filter(x_in[k], y_out[count]))
+      count++;
+  return count;
+}
+
+
+template<class DataType, class CoeffType>
+IirDecimator<DataType,CoeffType>::IirDecimator(
+  const SosFilter<DataType,CoeffType>& filter,
+  unsigned int factor
+)
+: filter_(filter)
+, factor_(factor)
+, phase_(0)
+, chunk_buffer_(chunk_)
+{
+  if(factor_ == 0)
+    throw std::runtime_error("IirDecimator: the decimation factor must be positive");
+}
+
+
+template<class DataType, class CoeffType>
+void IirDecimator<DataType,CoeffType>::reset()
+{
+  filter_.reset();
+  phase_ = 0;
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t IirDecimator<DataType,CoeffType>::outputs(
+  std::size_t n
+) const
+{
+  return decimatedOutputs(n, factor_, phase_);
+}
+
+
+template<class DataType, class CoeffType>
+bool IirDecimator<DataType,CoeffType>::filter(
+  const DataType& x,
+  DataType& y
+)
+{
+  const DataType& yk = filter_.filter(x);
+  const bool output = phase_ == 0;
+  if(output)
+    y = yk;
+  phase_ = phase_ + 1 == factor_ ? 0 : phase_ + 1;
+  return output;
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t IirDecimator<DataType,CoeffType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+)
+{
+  std::size_t count = 0;
+  for(std::size_t start=0; start<n; start+=chunk_) {
+    const std::size_t len = std::min(chunk_, n - start);
+    filter_.filter(x_in + start, chunk_buffer_.data(), len);
+    // skip to the first kept output, then jump by the factor
+    std::size_t k = (factor_ - phase_) % factor_;
+    for(; k<len; k+=factor_)
+      y_out[count++] = chunk_buffer_[k];
+    phase_ = (phase_ + len) % factor_;
+  }
+  return count;
+}
+
+
+template <class CoeffType>
+std::vector<CoeffType> windowedSinc(
+  unsigned int taps,
+  const CoeffType& cutoff,
+  const CoeffType& sampling
+)
+{
+  if(taps == 0)
+    throw std::runtime_error("windowedSinc: the number of taps must be positive");
+  if(!(cutoff > 0) || cutoff*2 > sampling)
+    throw std::runtime_error("windowedSinc: cutoff frequency should be between zero and half of sampling frequency");
+
+  const CoeffType fc = cutoff / sampling;
+  const CoeffType center = CoeffType(taps - 1) / 2;
+  std::vector<CoeffType> h(taps);
+  CoeffType sum = 0;
+  for(unsigned int n=0; n<taps; n++) {
+    const CoeffType t = n - center;
+    const CoeffType sinc = t == 0 ? 2*fc : std::sin(2*M_PI*fc*t) / (M_PI*t);
+    const CoeffType window = taps == 1 ? 1 : 0.54 - 0.46*std::cos(2*M_PI*n/(taps-1));
+    h[n] = sinc * window;
+    sum = sum + h[n];
+  }
+  for(auto& hn : h)
+    hn = hn / sum;
+  return h;
+}
+
+
+template <class DataType, class CoeffType>
+FirDecimator<DataType,CoeffType> firDecimator(
+  unsigned int factor,
+  unsigned int taps
+)
+{
+  if(factor == 0)
+    throw std::runtime_error("firDecimator: the decimation factor must be positive");
+  if(taps == 0)
+    taps = 20*factor + 1;
+  return FirDecimator<DataType,CoeffType>(
+    windowedSinc<CoeffType>(taps, CoeffType(1) / (2*factor), CoeffType(1)),
+    factor
+  );
+}
+
+
+template <class DataType, class CoeffType>
+FirInterpolator<DataType,CoeffType> firInterpolator(
+  unsigned int factor,
+  unsigned int taps
+)
+{
+  if(factor == 0)
+    throw std::runtime_error("firInterpolator: the interpolation factor must be positive");
+  if(taps == 0)
+    taps = 20*factor + 1;
+  auto h = windowedSinc<CoeffType>(taps, CoeffType(1) / (2*factor), CoeffType(1));
+  for(auto& hn : h)
+    hn = hn * CoeffType(factor);
+  return FirInterpolator<DataType,CoeffType>(h, factor);
+}
+
+
+template <class DataType, class CoeffType>
+IirDecimator<DataType,CoeffType> iirDecimator(
+  unsigned int factor,
+  unsigned int order
+)
+{
+  if(factor == 0)
+    throw std::runtime_error("iirDecimator: the decimation factor must be positive");
+  return IirDecimator<DataType,CoeffType>(
+    butterworthSos<DataType,CoeffType>(order, CoeffType(0.8) / (2*factor), CoeffType(1)),
+    factor
+  );
+}
+
+} // namespace digital_filters
@@ -0,0 +1,130 @@
+/** @file rank_filter.hpp
+  * @brief Header file containing the RankFilter class, used for running
+  *   medians and percentiles.
+  */
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace digital_filters {
+
+/// Running rank filter, *e.g.*, a median filter.
+/** The output is the element of rank `rank()` among the last `windowSize()`
+  * samples, *i.e.*, the `rank()+1`-th smallest one. A rank of
+  * `(windowSize()-1)/2` yields a median filter, which removes spikes shorter
+  * than half of the window while preserving steps.
+  *
+  * The samples of the window are split into two binary heaps: a max-heap
+  * with the `rank()+1` smallest samples, whose top is the output, and a
+  * min-heap with the remaining ones. Each sample knows its position in the
+  * heaps, so that the oldest sample can be replaced by the newest one and
+  * moved to its place in \f$ O(\log w) \f$ operations. No memory is
+  * allocated after construction.
+  *
+  * As for Filter, the past inputs are initially zero, see initInput() to
+  * change them. The class exposes the same filtering methods of Filter,
+  * hence it can be used, *e.g.*, as a stage of a FilterChain.
+  * @tparam DataType Type of the input/output signals. It must be totally
+  *   ordered by `operator<` (in particular, NaNs are not allowed).
+  */
+template <class DataType>
+class RankFilter {
+public:
+  /// Creates a rank filter.
+  /** @param window_size number of samples in the window.
+    * @param rank rank of the output, between zero (minimum) and
+    *   `window_size-1` (maximum).
+    * @note An exception is thrown if the window is empty or if the rank is
+    *   not smaller than the window size.
+    */
+  RankFilter(
+    std::size_t window_size,
+    std::size_t rank
+  );
+
+  /// Number of samples in the window.
+  inline std::size_t windowSize() const { return values_.size(); }
+
+  /// Rank of the output within the window.
+  inline std::size_t rank() const { return low_.size() - 1; }
+
+  /// Fill the window with a constant value.
+  void initInput(
+    const DataType& x
+  );
+
+  /// Filter the current input.
+  const DataType& filter(
+    const DataType& x
+  );
+
+  /// Filter a block of samples.
+  /** @param x_in pointer to `n` input samples.
+    * @param y_out pointer to `n` output samples. It can be equal to `x_in`.
+    * @param n number of samples in the block.
+    */
+  void filter(
+    const DataType* x_in,
+    DataType* y_out,
+    std::size_t n
+  );
+
+private:
+  /// Whether the sample in `a` should be above the one in `b` in the
+  /// max-heap.
+  bool lowBefore(std::size_t a, std::size_t b) const;
+
+  /// Whether the sample in `a` should be above the one in `b` in the
+  /// min-heap.
+  bool highBefore(std::size_t a, std::size_t b) const;
+
+  /// Move an element of the max-heap up or down until it is in place.
+  void fixLow(std::size_t i);
+
+  /// Move an element of the min-heap up or down until it is in place.
+  void fixHigh(std::size_t i);
+
+  /// Swap two elements of a heap, updating their positions.
+  void swap(std::vector<std::size_t>& heap, std::size_t i, std::size_t j, bool high);
+
+  std::vector<DataType> values_; ///< Ring buffer with the window.
+  std::size_t oldest_; ///< Position of the oldest sample in `values_`.
+  std::vector<std::size_t> low_; ///< Max-heap of the smallest samples.
+  std::vector<std::size_t> high_; ///< Min-heap of the largest samples.
+  /// Position of each sample in the heaps.
+  /** Samples in the max-heap are at `low_[position_[i]]`, while samples in
+    * the min-heap are at `high_[position_[i]-low_.size()]`.
+    */
+  std::vector<std::size_t> position_;
+  DataType y_; ///< Latest output.
+};
+
+
+/// Returns a running median filter.
+/** For even windows, the lower of the two central samples is returned.
+  * @param window_size number of samples in the window.
+  */
+template <class DataType>
+RankFilter<DataType> medianFilter(
+  std::size_t window_size
+);
+
+
+/// Returns a running percentile filter.
+/** @param window_size number of samples in the window.
+  * @param percentile fraction of the samples of the window that are not
+  *   larger than the output, between zero and one. It is rounded to the
+  *   closest rank.
+  * @note An exception is thrown if the percentile is not between zero and
+  *   one.
+  */
+template <class DataType>
+RankFilter<DataType> percentileFilter(
+  std::size_t window_size,
+  double percentile
+);
+
+} // namespace digital_filters
+
+#include <digital_filters/rank_filter.hxx>
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+
+namespace digital_filters {
+
+template<class DataType>
+RankFilter<DataType>::RankFilter(
+  std::size_t window_size,
+  std::size_t rank
+)
+: oldest_(0)
+, y_(0)
+{
+  if(window_size == 0 || rank >= window_size) {
+    throw std::runtime_error(
+      "RankFilter: the rank (" + std::to_string(rank) + ") must be smaller " +
+      "than the window size (" + std::to_string(window_size) + ")"
+    );
+  }
+  values_.resize(window_size, DataType(0));
+  low_.resize(rank + 1);
+  high_.resize(window_size - rank - 1);
+  position_.resize(window_size);
+  // all samples are equal, hence any assignment is a valid pair of heaps
+  for(std::size_t i=0; i<window_size; i++) {
+    position_[i] = i;
+    if(i < low_.size())
+      low_[i] = i;
+    else
+      high_[i - low_.size()] = i;
+  }
+}
+
+
+template<class DataType>
+void RankFilter<DataType>::initInput(
+  const DataType& x
+)
+{
+  std::fill(values_.begin(), values_.end(), x);
+  y_ = x;
+}
+
+
+template<class DataType>
+const DataType& RankFilter<DataType>::filter(
+  const DataType& x
+)
+{
+  // the newest sample replaces the oldest one, in the same heap
+  const std::size_t slot = oldest_;
+  oldest_ = oldest_ + 1 == values_.size() ? 0 : oldest_ + 1;
+  values_[slot] = x;
+  const std::size_t p = position_[slot];
+  if(p < low_.size())
+    fixLow(p);
+  else
+    fixHigh(p - low_.size());
+
+  // if the two heaps overlap, only their tops are out of place
+  if(!high_.empty() && values_[high_[0]] < values_[low_[0]]) {
+    std::swap(low_[0], high_[0]);
+    position_[low_[0]] = 0;
+    position_[high_[0]] = low_.size();
+    fixLow(0);
+    fixHigh(0);
+  }
+
+  y_ = values_[low_[0]];
+  return y_;
+}
+
+
+template<class DataType>
+void RankFilter<DataType>::filter(
+  const DataType* x_in,
+  DataType* y_out,
+  std::size_t n
+)
+{
+  for(std::size_t k=0; k<n; k++)
+    y_out[k] = filter(x_in[k]);
+}
+
+
+template<class DataType>
+bool RankFilter<DataType>::lowBefore(
+  std::size_t a,
+  std::size_t b
+) const
+{
+  return values_[low_[b]] < values_[low_[a]];
+}
+
+
+template<class DataType>
+bool RankFilter<DataType>::highBefore(
+  std::size_t a,
+  std::size_t b
+) const
+{
+  return values_[high_[a]] < values_[high_[b]];
+}
+
+
+template<class DataType>
+void RankFilter<DataType>::fixLow(
+  std::size_t i
+)
+{
+  // sift up
+  while(i > 0 && lowBefore(i, (i-1)/2)) {
+    swap(low_, i, (i-1)/2, false);
+    i = (i-1)/2;
+  }
+  // sift down
+  while(true) {
+    std::size_t best = i;
+    const std::size_t left = 2*i + 1, right = 2*i + 2;
+    if(left < low_.size() && lowBefore(left, best))
+      best = left;
+    if(right < low_.size() && lowBefore(right, best))
+      best = right;
+    if(best == i)
+      break;
+    swap(low_, i, best, false);
+    i = best;
+  }
+}
+
+
+template<class DataType>
+void RankFilter<DataType>::fixHigh(
+  std::size_t i
+)
+{
+  while(i > 0 && highBefore(i, (i-1)/2)) {
+    swap(high_, i, (i-1)/2, true);
+    i = (i-1)/2;
+  }
+  while(true) {
+    std::size_t best = i;
+    const std::size_t left = 2*i + 1, right = 2*i + 2;
+    if(left < high_.size() && highBefore(left, best))
+      best = left;
+    if(right < high_.size() && highBefore(right, best))
+      best = right;
+    if(best == i)
+      break;
+    swap(high_, i, best, true);
+    i = best;
+  }
+}
+
+
+template<class DataType>
+void RankFilter<DataType>::swap(
+  std::vector<std::size_t>& heap,
+  std::size_t i,
+  std::size_t j,
+  bool high
+)
+{
+  std::swap(heap[i], heap[j]);
+  const std::size_t offset = high ? low_.size() : 0;
+  position_[heap[i]] = i + offset;
+  position_[heap[j]] = j + offset;
+}
+
+
+template <class DataType>
+RankFilter<DataType> medianFilter(
+  std::size_t window_size
+)
+{
+  if(window_size == 0)
+    throw std::runtime_error("medianFilter: the window must not be empty");
+  return RankFilter<DataType>(window_size, (window_size - 1) / 2);
+}
+
+
+template <class DataType>
+RankFilter<DataType> percentileFilter(
+  std::size_t window_size,
+  double percentile
+)
+{
+  if(!(percentile >= 0 && percentile <= 1))
+    throw std::runtime_error("percentileFilter: the percentile (" + std::to_string(percentile) + ") must be between zero and one");
+  if(window_size == 0)
+    throw std::runtime_error("percentileFilter: the window must not be empty");
+  return RankFilter<DataType>(window_size, static_cast<std::size_t>(std::lround(percentile * (window_size - 1))));
+}
+
+} // namespace digital_filters
@@ -0,0 +1,164 @@
+/** @file simd.hpp
+  * @brief Thin wrappers around the SIMD intrinsics used by multi-channel
+  *   filters.
+  */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace digital_filters {
+
+/// Pack of values processed by a single SIMD instruction.
+/** The primary template is the scalar fallback, which processes one value at
+  * a time. Specializations for `float`, `double` and `std::int32_t` are
+  * enabled when the code is compiled with AVX-512 or AVX2 support (*e.g.*,
+  * via `-march=native`). The instruction set is therefore selected at compile
+  * time.
+  *
+  * Packs of `double` can also be loaded from and stored to `float` arrays,
+  * which allows to accumulate single precision data in double precision.
+  * Similarly, packs of `std::int32_t` can be loaded from and stored to
+  * `std::int16_t` arrays (with saturation), which is used by fixed-point
+  * filters.
+  * @tparam Scalar type of the packed values.
+  */
+template <class Scalar>
+struct SimdPack {
+  typedef Scalar Register; ///< Type holding a pack.
+  static constexpr std::size_t width = 1; ///< Number of values in a pack.
+  static constexpr const char* name = "scalar"; ///< Instruction set.
+  /// Load a pack from (possibly unaligned) memory.
+  static inline Register load(const Scalar* p) { return *p; }
+  /// Store a pack into (possibly unaligned) memory.
+  static inline void store(Scalar* p, const Register& r) { *p = r; }
+  /// Create a pack with all values equal to `s`.
+  static inline Register broadcast(const Scalar& s) { return s; }
+  /// Element-wise sum.
+  static inline Register add(const Register& a, const Register& b) { return a + b; }
+  /// Element-wise difference.
+  static inline Register sub(const Register& a, const Register& b) { return a - b; }
+  /// Element-wise product.
+  static inline Register mul(const Register& a, const Register& b) { return a * b; }
+  /// Element-wise minimum.
+  static inline Register min(const Register& a, const Register& b) { return std::min(a, b); }
+  /// Element-wise maximum.
+  static inline Register max(const Register& a, const Register& b) { return std::max(a, b); }
+  /// Element-wise arithmetic right shift (integer packs only).
+  static inline Register shiftRight(const Register& a, int bits) { return a >> bits; }
+};
+
+#if defined(__AVX512F__)
+
+/// AVX-512 pack of eight `double` values.
+template <>
+struct SimdPack<double> {
+  typedef __m512d Register;
+  static constexpr std::size_t width = 8;
+  static constexpr const char* name = "AVX-512";
+  static inline Register load(const double* p) { return _mm512_loadu_pd(p); }
+  static inline void store(double* p, const Register& r) { _mm512_storeu_pd(p, r); }
+  static inline Register broadcast(const double& s) { return _mm512_set1_pd(s); }
+  static inline Register add(const Register& a, const Register& b) { return _mm512_add_pd(a, b); }
+  static inline Register sub(const Register& a, const Register& b) { return _mm512_sub_pd(a, b); }
+  static inline Register mul(const Register& a, const Register& b) { return _mm512_mul_pd(a, b); }
+  static inline Register load(const float* p) { return _mm512_cvtps_pd(_mm256_loadu_ps(p)); }
+  static inline void store(float* p, const Register& r) { _mm256_storeu_ps(p, _mm512_cvtpd_ps(r)); }
+};
+
+/// AVX-512 pack of sixteen `float` values.
+template <>
+struct SimdPack<float> {
+  typedef __m512 Register;
+  static constexpr std::size_t width = 16;
+  static constexpr const char* name = "AVX-512";
+  static inline Register load(const float* p) { return _mm512_loadu_ps(p); }
+  static inline void store(float* p, const Register& r) { _mm512_storeu_ps(p, r); }
+  static inline Register broadcast(const float& s) { return _mm512_set1_ps(s); }
+  static inline Register add(const Register& a, const Register& b) { return _mm512_add_ps(a, b); }
+  static inline Register sub(const Register& a, const Register& b) { return _mm512_sub_ps(a, b); }
+  static inline Register mul(const Register& a, const Register& b) { return _mm512_mul_ps(a, b); }
+};
+
+/// AVX-512 pack of sixteen `std::int32_t` values.
+template <>
+struct SimdPack<std::int32_t> {
+  typedef __m512i Register;
+  static constexpr std::size_t width = 16;
+  static constexpr const char* name = "AVX-512";
+  static inline Register load(const std::int32_t* p) { return _mm512_loadu_si512(p); }
+  static inline void store(std::int32_t* p, const Register& r) { _mm512_storeu_si512(p, r); }
+  static inline Register broadcast(const std::int32_t& s) { return _mm512_set1_epi32(s); }
+  static inline Register add(const Register& a, const Register& b) { return _mm512_add_epi32(a, b); }
+  static inline Register sub(const Register& a, const Register& b) { return _mm512_sub_epi32(a, b); }
+  static inline Register mul(const Register& a, const Register& b) { return _mm512_mullo_epi32(a, b); }
+  static inline Register min(const Register& a, const Register& b) { return _mm512_min_epi32(a, b); }
+  static inline Register max(const Register& a, const Register& b) { return _mm512_max_epi32(a, b); }
+  static inline Register shiftRight(const Register& a, int bits) { return _mm512_sra_epi32(a, _mm_cvtsi32_si128(bits)); }
+  static inline Register load(const std::int16_t* p) { return _mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))); }
+  static inline void store(std::int16_t* p, const Register& r) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtsepi32_epi16(r)); }
+};
+
+#elif defined(__AVX2__)
+
+/// AVX2 pack of four `double` values.
+template <>
+struct SimdPack<double> {
+  typedef __m256d Register;
+  static constexpr std::size_t width = 4;
+  static constexpr const char* name = "AVX2";
+  static inline Register load(const double* p) { return _mm256_loadu_pd(p); }
+  static inline void store(double* p, const Register& r) { _mm256_storeu_pd(p, r); }
+  static inline Register broadcast(const double& s) { return _mm256_set1_pd(s); }
+  static inline Register add(const Register& a, const Register& b) { return _mm256_add_pd(a, b); }
+  static inline Register sub(const Register& a, const Register& b) { return _mm256_sub_pd(a, b); }
+  static inline Register mul(const Register& a, const Register& b) { return _mm256_mul_pd(a, b); }
+  static inline Register load(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+  static inline void store(float* p, const Register& r) { _mm_storeu_ps(p, _mm256_cvtpd_ps(r)); }
+};
+
+/// AVX2 pack of eight `float` values.
+template <>
+struct SimdPack<float> {
+  typedef __m256 Register;
+  static constexpr std::size_t width = 8;
+  static constexpr const char* name = "AVX2";
+  static inline Register load(const float* p) { return _mm256_loadu_ps(p); }
+  static inline void store(float* p, const Register& r) { _mm256_storeu_ps(p, r); }
+  static inline Register broadcast(const float& s) { return _mm256_set1_ps(s); }
+  static inline Register add(const Register& a, const Register& b) { return _mm256_add_ps(a, b); }
+  static inline Register sub(const Register& a, const Register& b) { return _mm256_sub_ps(a, b); }
+  static inline Register mul(const Register& a, const Register& b) { return _mm256_mul_ps(a, b); }
+};
+
+/// AVX2 pack of eight `std::int32_t` values.
+template <>
+struct SimdPack<std::int32_t> {
+  typedef __m256i Register;
+  static constexpr std::size_t width = 8;
+  static constexpr const char* name = "AVX2";
+  static inline Register load(const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+  static inline void store(std::int32_t* p, const Register& r) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r); }
+  static inline Register broadcast(const std::int32_t& s) { return _mm256_set1_epi32(s); }
+  static inline Register add(const Register& a, const Register& b) { return _mm256_add_epi32(a, b); }
+  static inline Register sub(const Register& a, const Register& b) { return _mm256_sub_epi32(a, b); }
+  static inline Register mul(const Register& a, const Register& b) { return _mm256_mullo_epi32(a, b); }
+  static inline Register min(const Register& a, const Register& b) { return _mm256_min_epi32(a, b); }
+  static inline Register max(const Register& a, const Register& b) { return _mm256_max_epi32(a, b); }
+  static inline Register shiftRight(const Register& a, int bits) { return _mm256_sra_epi32(a, _mm_cvtsi32_si128(bits)); }
+  static inline Register load(const std::int16_t* p) { return _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+  static inline void store(std::int16_t* p, const Register& r) {
+    // packs saturates, but it works on 128-bit lanes: gather the results
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(r, r), 0x08);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_castsi256_si128(packed));
+  }
+};
+
+#endif
+
+} // namespace digital_filters
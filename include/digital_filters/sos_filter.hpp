@@ -0,0 +1,217 @@
+/** @file sos_filter.hpp
+  * @brief Header file containing the SosFilter class.
+  */
+#pragma once
+
+#include <digital_filters/checkpoint.hpp>
+#include <digital_filters/filter.hpp>
+#include <array>
+#include <vector>
+#include <cstddef>
+
+namespace digital_filters {
+
+/// Digital filter realized as a cascade of second-order sections.
+/** High-order filters are numerically fragile when their transfer function is
+  * expanded into a single ratio of polynomials. This class stores instead a
+  * sequence of biquads, *i.e.*, filters whose transfer function is:
+  * \f[
+  *   H_s(z) = \frac{b_{s,0} + b_{s,1} z^{-1} + b_{s,2} z^{-2}}
+  *                 {a_{s,0} + a_{s,1} z^{-1} + a_{s,2} z^{-2}}
+  * \f]
+  * The overall transfer function is the product of all sections, which are
+  * applied one after the other. Each section is evaluated using a Direct Form
+  * II Transposed structure, so that the state consists of two samples only.
+  * The state is stored using Filter::Accumulator, *e.g.*, in double precision
+  * for a `SosFilter<float,double>`.
+  * @tparam DataType Type of the input/output signals
+  * @tparam CoeffType Type of the coefficients of the transfer function.
+  */
+template <class DataType, class CoeffType>
+class SosFilter {
+public:
+  /// Type used to store the state and to accumulate products.
+  typedef typename Filter<DataType,CoeffType>::Accumulator Accumulator;
+
+  /// Coefficients of a single section.
+  /** The layout is the same used by SciPy, *i.e.*,
+    * `{b0, b1, b2, a0, a1, a2}`.
+    */
+  typedef std::array<CoeffType,6> Section;
+
+  /// Generates a filter from given sections.
+  /** Each section is normalized internally, so that \f$ a_{s,0} = 1 \f$.
+    * @param sections coefficients of the biquads, in order of application.
+    *   An empty list corresponds to the identity filter.
+    */
+  SosFilter(
+    const std::vector<Section>& sections
+  );
+
+  /// Generates a filter from a transfer function of order two at most.
+  /** @param filter filter to be converted. Both its numerator and its
+    *   denominator must have at most three elements.
+    */
+  explicit SosFilter(
+    const Filter<DataType,CoeffType>& filter
+  );
+
+  /// Filters concatenation.
+  /** The sections of `other` are appended to the ones of `this`, so that
+    * no polynomial needs to be expanded.
+    * @param other filter that should be concatenated to `this`.
+    * @return a new filter which is the concatenation of `this` and `other`.
+    */
+  SosFilter<DataType,CoeffType> operator*(
+    const SosFilter<DataType,CoeffType>& other
+  ) const;
+
+  /// Filters concatenation.
+  /** @param other filter that should be concatenated to `this`. Its order
+    *   must be two at most, so that it can be appended as a new section.
+    * @return a new filter which is the concatenation of `this` and `other`.
+    */
+  SosFilter<DataType,CoeffType> operator*(
+    const Filter<DataType,CoeffType>& other
+  ) const;
+
+  /// Change filter template types.
+  /** @tparam OtherDataType new type of the input/output signals.
+    * @tparam OtherCoeffType new type of the coefficients.
+    * @return A new filter which is a copy of the current one, including its
+    *   internal state, but with different template types.
+    * @note To perform the conversion, `static_cast` is used. Make sure that
+    *   this is not an issue for your datatypes.
+    */
+  template <class OtherDataType, class OtherCoeffType>
+  SosFilter<OtherDataType,OtherCoeffType> as() const;
+
+  /// Append a new section at the end of the cascade.
+  /** The state of the new section is set to zero.
+    * @param section coefficients of the new biquad.
+    */
+  void append(
+    const Section& section
+  );
+
+  /// Access the (normalized) sections.
+  inline const std::vector<Section>& sections() const { return sections_; }
+
+  /// Numerator of the overall transfer function.
+  /** @warning The numerator is evaluated by expanding the product of all
+    *   sections. This is exactly what this class is meant to avoid: use it
+    *   for inspection purposes only.
+    */
+  std::vector<CoeffType> numerator() const;
+
+  /// Denominator of the overall transfer function.
+  /** @warning The denominator is evaluated by expanding the product of all
+    *   sections. This is exactly what this class is meant to avoid: use it
+    *   for inspection purposes only.
+    */
+  std::vector<CoeffType> denominator() const;
+
+  /// Set the state of all sections to zero.
+  void reset();
+
+  /// Set the state to the steady-state response to a constant input.
+  /** After calling this method, filtering the constant signal `input`
+    * produces no transient at all.
+    * @param input value of the constant input.
+    * @note If a section has a pole in \f$ z=1 \f$, the steady-state output
+    *   is not defined and an exception is thrown. In this case, the state is
+    *   not modified.
+    */
+  void initSteadyState(
+    const DataType& input
+  );
+
+  /// Save the sections and the exact state of the cascade.
+  /** @param[out] buffer destination of the checkpoint. The record is appended
+    *   to its previous content.
+    * @see checkpoint.hpp
+    */
+  void checkpoint(
+    std::vector<unsigned char>& buffer
+  ) const;
+
+  /// Restore the sections and the state saved by checkpoint().
+  /** No memory is allocated if the checkpoint has as many sections as
+    * `this`.
+    * @param data pointer to the record, aligned to checkpointAlignment().
+    * @param size number of bytes available from `data`.
+    * @return size of the record, *i.e.*, offset of the next record.
+    * @note An exception is thrown if the record is invalid, or if it was
+    *   written by a filter with different template types. In this case, the
+    *   filter is not modified.
+    */
+  std::size_t restore(
+    const void* data,
+    std::size_t size
+  );
+
+  /// Filter the current input.
+  const DataType& filter(
+    const DataType& x
+  );
+
+  /// Filter a block of samples.
+  /** The internal state is used as initial condition and it is updated at
+    * the end of the block, so that consecutive calls behave as if all samples
+    * were passed one at a time to filter(const DataType&). The whole block is
+    * processed by a section before moving to the next one.
+    * @param x pointer to `n` input samples.
+    * @param y pointer to `n` output samples. It can be equal to `x`, in which
+    *   case the block is filtered in-place.
+    * @param n number of samples in the block.
+    */
+  void filter(
+    const DataType* x,
+    DataType* y,
+    std::size_t n
+  );
+
+  /// Bi-directional filtering of a whole sequence.
+  /** Filter a given signal from both sides by applying the filter once and
+    * then a second time on the reversed result. Each section is initialized
+    * with its steady-state response to the first sample that it processes.
+    * The internal state is not modified.
+    * @param x input signal to be filtered. It should be sorted in
+    *   time-ascending order, *i.e.*, so that `x[k]` corresponds to the
+    *   discrete-time sample \f$ x_k \f$.
+    * @return sequence of filtered outputs \f$ y_0, y_1, y_2, \cdots \f$
+    * @note If a section has a pole in \f$ z=1 \f$, its steady state is not
+    *   defined and both passes start that section from a zero state.
+    */
+  std::vector<DataType> filter2(
+    const std::vector<DataType>& x
+  ) const;
+
+private:
+  // Allow conversions between filters with different template types.
+  template <class OtherDataType, class OtherCoeffType>
+  friend class SosFilter;
+
+  /// Steady-state of a section, for a unit input.
+  /** @param s index of the section.
+    * @param[out] G static gain of the section.
+    * @param[out] z0 first state variable.
+    * @param[out] z1 second state variable.
+    * @return false if the section has a pole in \f$ z=1 \f$, in which case
+    *   the steady-state is not defined and all outputs are set to zero.
+    */
+  bool sectionSteadyState(
+    std::size_t s,
+    CoeffType& G,
+    CoeffType& z0,
+    CoeffType& z1
+  ) const;
+
+  std::vector<Section> sections_; ///< Normalized sections.
+  std::vector<Accumulator> state_; ///< State of the sections, two per section.
+  DataType y_; ///< Last output of the cascade.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/sos_filter.hxx>
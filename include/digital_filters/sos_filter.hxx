@@ -0,0 +1,317 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <digital_filters/utilities.hpp>
+
+
+namespace digital_filters {
+
+template<class DataType, class CoeffType>
+SosFilter<DataType,CoeffType>::SosFilter(
+  const std::vector<Section>& sections
+)
+: y_()
+{
+  sections_.reserve(sections.size());
+  state_.reserve(2*sections.size());
+  for(const auto& section : sections)
+    append(section);
+}
+
+
+template<class DataType, class CoeffType>
+SosFilter<DataType,CoeffType>::SosFilter(
+  const Filter<DataType,CoeffType>& filter
+)
+: y_()
+{
+  const auto& b = filter.numerator();
+  const auto& a = filter.denominator();
+  // check sizes
+  if(b.size() > 3 || a.size() > 3) {
+    throw std::runtime_error(
+      "SosFilter: cannot convert a filter with " + std::to_string(b.size()) +
+      " numerator and " + std::to_string(a.size()) + " denominator " +
+      "coefficients into a single second-order section"
+    );
+  }
+  // copy the coefficients, padding with zeros
+  Section section{};
+  for(unsigned int i=0; i<b.size(); i++)
+    section[i] = b[i];
+  for(unsigned int i=0; i<a.size(); i++)
+    section[3+i] = a[i];
+  append(section);
+}
+
+
+template<class DataType, class CoeffType>
+SosFilter<DataType,CoeffType> SosFilter<DataType,CoeffType>::operator*(
+  const SosFilter<DataType,CoeffType>& other
+) const
+{
+  auto sections = sections_;
+  sections.insert(sections.end(), other.sections_.begin(), other.sections_.end());
+  return SosFilter<DataType,CoeffType>(sections);
+}
+
+
+template<class DataType, class CoeffType>
+SosFilter<DataType,CoeffType> SosFilter<DataType,CoeffType>::operator*(
+  const Filter<DataType,CoeffType>& other
+) const
+{
+  return (*this) * SosFilter<DataType,CoeffType>(other);
+}
+
+
+template<class DataType, class CoeffType>
+template<class OtherDataType, class OtherCoeffType>
+SosFilter<OtherDataType,OtherCoeffType> SosFilter<DataType,CoeffType>::as() const
+{
+  // copy-convert the sections
+  std::vector<typename SosFilter<OtherDataType,OtherCoeffType>::Section> sections(sections_.size());
+  for(unsigned int s=0; s<sections_.size(); s++)
+    for(unsigned int i=0; i<6; i++)
+      sections[s][i] = static_cast<OtherCoeffType>(sections_[s][i]);
+  // create new filter and copy-convert its state
+  SosFilter<OtherDataType,OtherCoeffType> filter(sections);
+  filter.state_.assign(state_.begin(), state_.end());
+  filter.y_ = static_cast<OtherDataType>(y_);
+  return filter;
+}
+
+
+template<class DataType, class CoeffType>
+void SosFilter<DataType,CoeffType>::append(
+  const Section& section
+)
+{
+  if(section[3] == CoeffType(0))
+    throw std::runtime_error("SosFilter::append: the first denominator coefficient (a0) is zero");
+  // normalize the section
+  Section normalized;
+  for(unsigned int i=0; i<6; i++)
+    normalized[i] = section[i] / section[3];
+  sections_.push_back(normalized);
+  state_.resize(2*sections_.size());
+}
+
+
+template<class DataType, class CoeffType>
+std::vector<CoeffType> SosFilter<DataType,CoeffType>::numerator() const
+{
+  std::vector<CoeffType> num(1, 1);
+  num.reserve(2*sections_.size()+1);
+  for(const auto& s : sections_)
+    polyMultiply(num, s.data(), 3);
+  return num;
+}
+
+
+template<class DataType, class CoeffType>
+std::vector<CoeffType> SosFilter<DataType,CoeffType>::denominator() const
+{
+  std::vector<CoeffType> den(1, 1);
+  den.reserve(2*sections_.size()+1);
+  for(const auto& s : sections_)
+    polyMultiply(den, s.data()+3, 3);
+  return den;
+}
+
+
+template<class DataType, class CoeffType>
+void SosFilter<DataType,CoeffType>::reset()
+{
+  for(auto& z : state_)
+    z = Accumulator();
+}
+
+
+template<class DataType, class CoeffType>
+bool SosFilter<DataType,CoeffType>::sectionSteadyState(
+  std::size_t s,
+  CoeffType& G,
+  CoeffType& z0,
+  CoeffType& z1
+) const
+{
+  // With a constant input u, the output of the section is G*u and the
+  // transposed state is constant as well
+  const auto& c = sections_[s];
+  const CoeffType Sa = c[3] + c[4] + c[5];
+  if(Sa == CoeffType(0)) {
+    G = z0 = z1 = CoeffType(0);
+    return false;
+  }
+  G = (c[0] + c[1] + c[2]) / Sa;
+  z1 = c[2] - c[5] * G;
+  z0 = c[1] - c[4] * G + z1;
+  return true;
+}
+
+
+template<class DataType, class CoeffType>
+void SosFilter<DataType,CoeffType>::initSteadyState(
+  const DataType& input
+)
+{
+  // check all sections before modifying the state
+  for(std::size_t s=0; s<sections_.size(); s++) {
+    const auto& c = sections_[s];
+    if(c[3] + c[4] + c[5] == CoeffType(0)) {
+      throw std::runtime_error(
+        "SosFilter::initSteadyState: section " + std::to_string(s) + " has a "
+        "pole in z=1, hence the steady-state output is not defined"
+      );
+    }
+  }
+  Accumulator u = input;
+  for(std::size_t s=0; s<sections_.size(); s++) {
+    CoeffType G, z0, z1;
+    sectionSteadyState(s, G, z0, z1);
+    state_[2*s] = z0 * u;
+    state_[2*s+1] = z1 * u;
+    u = G * u;
+  }
+}
+
+
+template<class DataType, class CoeffType>
+void SosFilter<DataType,CoeffType>::checkpoint(
+  std::vector<unsigned char>& buffer
+) const
+{
+  CheckpointWriter writer(buffer, checkpointHeader<DataType,CoeffType,Accumulator>(CheckpointKind::SosFilter));
+  writer.write(sections_.data(), sections_.size());
+  writer.write(state_.data(), state_.size());
+  writer.write(y_);
+  writer.close();
+}
+
+
+template<class DataType, class CoeffType>
+std::size_t SosFilter<DataType,CoeffType>::restore(
+  const void* data,
+  std::size_t size
+)
+{
+  CheckpointReader reader(data, size, checkpointHeader<DataType,CoeffType,Accumulator>(CheckpointKind::SosFilter));
+  std::size_t n;
+  const Section* sections = reader.read<Section>(n);
+  const Accumulator* state = reader.readExactly<Accumulator>(2*n);
+  const DataType y = reader.value<DataType>();
+  // sections are stored normalized, as append() leaves them
+  for(std::size_t i=0; i<n; i++)
+    if(sections[i][3] != CoeffType(1))
+      throw std::runtime_error("SosFilter::restore: the checkpoint is corrupted");
+  sections_.assign(sections, sections+n);
+  state_.assign(state, state+2*n);
+  y_ = y;
+  return reader.size();
+}
+
+
+template<class DataType, class CoeffType>
+const DataType& SosFilter<DataType,CoeffType>::filter(
+  const DataType& x
+)
+{
+  Accumulator y = x;
+  for(std::size_t s=0; s<sections_.size(); s++) {
+    const auto& c = sections_[s];
+    Accumulator& z0 = state_[2*s];
+    Accumulator& z1 = state_[2*s+1];
+    const Accumulator u = y;
+    y = c[0] * u + z0;
+    z0 = c[1] * u - c[4] * y + z1;
+    z1 = c[2] * u - c[5] * y;
+  }
+  y_ = static_cast<DataType>(y);
+  return y_;
+}
+
+
+template<class DataType, class CoeffType>
+void SosFilter<DataType,CoeffType>::filter(
+  const DataType* x,
+  DataType* y,
+  std::size_t n
+)
+{
+  if(n == 0)
+    return;
+  // the first section reads from x, all others work in-place on y
+  const DataType* in = x;
+  for(std::size_t s=0; s<sections_.size(); s++) {
+    const auto& c = sections_[s];
+    Accumulator z0 = state_[2*s];
+    Accumulator z1 = state_[2*s+1];
+    for(std::size_t k=0; k<n; k++) {
+      const Accumulator u = in[k];
+      const Accumulator yk = c[0] * u + z0;
+      z0 = c[1] * u - c[4] * yk + z1;
+      z1 = c[2] * u - c[5] * yk;
+      y[k] = static_cast<DataType>(yk);
+    }
+    state_[2*s] = z0;
+    state_[2*s+1] = z1;
+    in = y;
+  }
+  // without sections, this is the identity filter
+  if(sections_.size() == 0 && x != y)
+    for(std::size_t k=0; k<n; k++)
+      y[k] = x[k];
+  y_ = y[n-1];
+}
+
+
+template<class DataType, class CoeffType>
+std::vector<DataType> SosFilter<DataType,CoeffType>::filter2(
+  const std::vector<DataType>& x
+) const
+{
+  std::vector<DataType> y(x);
+  const std::size_t n = y.size();
+  if(n == 0)
+    return y;
+
+  // forward pass, one section at a time
+  for(std::size_t s=0; s<sections_.size(); s++) {
+    const auto& c = sections_[s];
+    // sections with a pole in z=1 start from a zero state
+    CoeffType G, z0u, z1u;
+    sectionSteadyState(s, G, z0u, z1u);
+    Accumulator z0 = z0u * y[0];
+    Accumulator z1 = z1u * y[0];
+    for(std::size_t k=0; k<n; k++) {
+      const Accumulator u = y[k];
+      const Accumulator yk = c[0] * u + z0;
+      z0 = c[1] * u - c[4] * yk + z1;
+      z1 = c[2] * u - c[5] * yk;
+      y[k] = static_cast<DataType>(yk);
+    }
+  }
+
+  // backward pass, iterating from the end of the signal
+  for(std::size_t s=0; s<sections_.size(); s++) {
+    const auto& c = sections_[s];
+    // sections with a pole in z=1 start from a zero state
+    CoeffType G, z0u, z1u;
+    sectionSteadyState(s, G, z0u, z1u);
+    Accumulator z0 = z0u * y[n-1];
+    Accumulator z1 = z1u * y[n-1];
+    for(std::size_t k=n; k-->0; ) {
+      const Accumulator u = y[k];
+      const Accumulator yk = c[0] * u + z0;
+      z0 = c[1] * u - c[4] * yk + z1;
+      z1 = c[2] * u - c[5] * yk;
+      y[k] = static_cast<DataType>(yk);
+    }
+  }
+
+  return y;
+}
+
+} // namespace digital_filters
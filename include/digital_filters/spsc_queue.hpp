@@ -0,0 +1,103 @@
+/** @file spsc_queue.hpp
+  * @brief Header file containing the SpscQueue class.
+  */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace digital_filters {
+
+/// Wait-free ring buffer between one producer and one consumer thread.
+/** One thread (the producer) calls push() and writeAvailable(), and one
+  * thread (the consumer) calls pop() and readAvailable(). Neither of them
+  * ever blocks or allocates memory: when the queue is full, push() stores
+  * only the samples that fit; when it is empty, pop() returns what is
+  * available.
+  *
+  * Each side owns one index and keeps a copy of the index of the other side,
+  * which is refreshed only when the copy says that the queue is full (or
+  * empty). Hence, moving a block costs one release store and, at most, one
+  * acquire load, regardless of its length. The two indices are stored on
+  * different cache lines to avoid false sharing.
+  * @tparam T type of the stored elements. It should be cheap to copy.
+  */
+template <class T>
+class SpscQueue {
+public:
+  /// Creates an empty queue.
+  /** @param capacity minimum number of elements that can be stored. It is
+    *   rounded up to a power of two.
+    * @note An exception is thrown if the capacity is zero.
+    */
+  explicit SpscQueue(
+    std::size_t capacity
+  );
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /// Maximum number of stored elements.
+  inline std::size_t capacity() const { return buffer_.size(); }
+
+  /// Number of elements that can be pushed. To be called by the producer.
+  std::size_t writeAvailable() const;
+
+  /// Number of elements that can be popped. To be called by the consumer.
+  std::size_t readAvailable() const;
+
+  /// Insert one element. To be called by the producer.
+  /** @param x element to be inserted.
+    * @return false if the queue is full, in which case nothing is inserted.
+    */
+  bool push(
+    const T& x
+  );
+
+  /// Insert a block of elements. To be called by the producer.
+  /** @param x pointer to `n` elements.
+    * @param n number of elements to be inserted.
+    * @return number of elements actually inserted, *i.e.*, the first ones
+    *   that fit in the queue.
+    */
+  std::size_t push(
+    const T* x,
+    std::size_t n
+  );
+
+  /// Extract one element. To be called by the consumer.
+  /** @param[out] y set to the oldest element, if any.
+    * @return false if the queue is empty.
+    */
+  bool pop(
+    T& y
+  );
+
+  /// Extract a block of elements. To be called by the consumer.
+  /** @param y pointer to (at least) `n` elements.
+    * @param n maximum number of elements to be extracted.
+    * @return number of elements actually extracted.
+    */
+  std::size_t pop(
+    T* y,
+    std::size_t n
+  );
+
+private:
+  /// Size of a cache line, used to separate the indices.
+  static constexpr std::size_t cache_line_ = 64;
+
+  std::vector<T> buffer_; ///< Storage, whose size is a power of two.
+  std::size_t mask_; ///< `capacity()-1`, to wrap the indices.
+  /// Number of elements pushed so far. Written by the producer only.
+  alignas(cache_line_) std::atomic<std::size_t> head_;
+  std::size_t tail_cache_; ///< Copy of `tail_` owned by the producer.
+  /// Number of elements popped so far. Written by the consumer only.
+  alignas(cache_line_) std::atomic<std::size_t> tail_;
+  std::size_t head_cache_; ///< Copy of `head_` owned by the consumer.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/spsc_queue.hxx>
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace digital_filters {
+
+template<class T>
+SpscQueue<T>::SpscQueue(
+  std::size_t capacity
+)
+: mask_(0)
+, head_(0)
+, tail_cache_(0)
+, tail_(0)
+, head_cache_(0)
+{
+  if(capacity == 0)
+    throw std::runtime_error("SpscQueue: the capacity must be positive");
+  std::size_t size = 1;
+  while(size < capacity)
+    size *= 2;
+  buffer_.resize(size);
+  mask_ = size - 1;
+}
+
+
+template<class T>
+std::size_t SpscQueue<T>::writeAvailable() const
+{
+  // the indices only grow, and their difference is not affected by overflows
+  return capacity() - (head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire));
+}
+
+
+template<class T>
+std::size_t SpscQueue<T>::readAvailable() const
+{
+  return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+}
+
+
+template<class T>
+bool SpscQueue<T>::push(
+  const T& x
+)
+{
+  return push(&x, 1) == 1;
+}
+
+
+template<class T>
+std::size_t SpscQueue<T>::push(
+  const T* x,
+  std::size_t n
+)
+{
+  const std::size_t head = head_.load(std::memory_order_relaxed);
+  // refresh the position of the consumer only if needed
+  if(capacity() - (head - tail_cache_) < n)
+    tail_cache_ = tail_.load(std::memory_order_acquire);
+  n = std::min(n, capacity() - (head - tail_cache_));
+  if(n == 0)
+    return 0;
+
+  // copy in (at most) two contiguous pieces
+  const std::size_t start = head & mask_;
+  const std::size_t first = std::min(n, capacity() - start);
+  std::copy(x, x + first, buffer_.begin() + start);
+  std::copy(x + first, x + n, buffer_.begin());
+  head_.store(head + n, std::memory_order_release);
+  return n;
+}
+
+
+template<class T>
+bool SpscQueue<T>::pop(
+  T& y
+)
+{
+  return pop(&y, 1) == 1;
+}
+
+
+template<class T>
+std::size_t SpscQueue<T>::pop(
+  T* y,
+  std::size_t n
+)
+{
+  const std::size_t tail = tail_.load(std::memory_order_relaxed);
+  // refresh the position of the producer only if needed
+  if(head_cache_ - tail < n)
+    head_cache_ = head_.load(std::memory_order_acquire);
+  n = std::min(n, head_cache_ - tail);
+  if(n == 0)
+    return 0;
+
+  const std::size_t start = tail & mask_;
+  const std::size_t first = std::min(n, capacity() - start);
+  std::copy(buffer_.begin() + start, buffer_.begin() + start + first, y);
+  std::copy(buffer_.begin(), buffer_.begin() + (n - first), y + first);
+  tail_.store(tail + n, std::memory_order_release);
+  return n;
+}
+
+} // namespace digital_filters
@@ -0,0 +1,134 @@
+/** @file streaming_stage.hpp
+  * @brief Header file containing the StreamingStage class.
+  */
+#pragma once
+
+#include <digital_filters/spsc_queue.hpp>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace digital_filters {
+
+/// Filter placed between two wait-free queues, to stream across threads.
+/** The stage decouples three roles, each of which must be played by a
+  * single thread at a time:
+  * - the *producer* (*e.g.*, a real-time acquisition thread) calls push();
+  * - the *worker* calls process(), which moves the available samples from
+  *   the input queue through the filter and into the output queue, in
+  *   batches;
+  * - the *consumer* calls pop().
+  *
+  * The worker and the consumer can be the same thread. No call blocks or
+  * allocates memory, and pushing or popping a block costs a couple of atomic
+  * operations. When the producer runs faster than the worker (or the worker
+  * faster than the consumer), samples that do not fit in the input queue are
+  * dropped and counted as overruns; when the consumer asks for more samples
+  * than available, the missing ones are counted as underruns.
+  *
+  * Example, with a worker thread:
+  * @code
+  * digital_filters::StreamingStage<double, digital_filters::Filter<double,double>> stage(
+  *   digital_filters::butterworth<double,double>(4, 10., 1000.),
+  *   4096
+  * );
+  * // acquisition thread
+  * stage.push(samples.data(), samples.size());
+  * // worker thread
+  * stage.process();
+  * // consumer thread
+  * std::size_t n = stage.pop(results.data(), results.size());
+  * @endcode
+  * @tparam DataType Type of the input/output signals.
+  * @tparam Processor Type of the wrapped filter. It must provide the block
+  *   method `filter(const DataType*, DataType*, std::size_t)` and support
+  *   in-place filtering, as Filter, SosFilter and FilterChain do.
+  */
+template <class DataType, class Processor>
+class StreamingStage {
+public:
+  /// Creates a stage.
+  /** @param processor filter applied to the stream.
+    * @param capacity minimum capacity of each queue.
+    * @param batch maximum number of samples filtered at once by process().
+    * @note An exception is thrown if the capacity or the batch are zero.
+    */
+  StreamingStage(
+    Processor processor,
+    std::size_t capacity,
+    std::size_t batch = 256
+  );
+
+  /// Access the wrapped filter.
+  /** The filter is used by process(): it can be safely accessed only by the
+    * worker thread, or while no thread is streaming.
+    */
+  inline Processor& processor() { return processor_; }
+
+  /// Access the wrapped filter (read-only version).
+  inline const Processor& processor() const { return processor_; }
+
+  /// Insert one sample. To be called by the producer.
+  /** @param x new input sample.
+    * @return false if the input queue is full, in which case the sample is
+    *   dropped and counted as an overrun.
+    */
+  bool push(
+    const DataType& x
+  );
+
+  /// Insert a block of samples. To be called by the producer.
+  /** @param x pointer to `n` input samples.
+    * @param n number of samples.
+    * @return number of inserted samples. The remaining ones are dropped and
+    *   counted as overruns.
+    */
+  std::size_t push(
+    const DataType* x,
+    std::size_t n
+  );
+
+  /// Filter the pending samples. To be called by the worker.
+  /** Samples are moved in batches, as long as there are pending inputs and
+    * room in the output queue.
+    * @return number of filtered samples.
+    */
+  std::size_t process();
+
+  /// Extract one filtered sample. To be called by the consumer.
+  /** @param[out] y set to the oldest filtered sample, if any.
+    * @return false if no sample is available, which counts as an underrun.
+    */
+  bool pop(
+    DataType& y
+  );
+
+  /// Extract a block of filtered samples. To be called by the consumer.
+  /** @param y pointer to (at least) `n` samples.
+    * @param n number of requested samples.
+    * @return number of extracted samples. The missing ones are counted as
+    *   underruns.
+    */
+  std::size_t pop(
+    DataType* y,
+    std::size_t n
+  );
+
+  /// Number of input samples dropped because the input queue was full.
+  inline std::size_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+
+  /// Number of samples requested via pop() that were not available.
+  inline std::size_t underruns() const { return underruns_.load(std::memory_order_relaxed); }
+
+private:
+  Processor processor_; ///< Wrapped filter.
+  SpscQueue<DataType> input_; ///< Samples pushed by the producer.
+  SpscQueue<DataType> output_; ///< Samples filtered by the worker.
+  std::vector<DataType> batch_; ///< Samples being filtered by the worker.
+  std::atomic<std::size_t> overruns_; ///< Written by the producer only.
+  std::atomic<std::size_t> underruns_; ///< Written by the consumer only.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/streaming_stage.hxx>
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+
+namespace digital_filters {
+
+template<class DataType, class Processor>
+StreamingStage<DataType,Processor>::StreamingStage(
+  Processor processor,
+  std::size_t capacity,
+  std::size_t batch
+)
+: processor_(std::move(processor))
+, input_(capacity)
+, output_(capacity)
+, overruns_(0)
+, underruns_(0)
+{
+  if(batch == 0)
+    throw std::runtime_error("StreamingStage: the batch size must be positive");
+  batch_.resize(batch);
+}
+
+
+template<class DataType, class Processor>
+bool StreamingStage<DataType,Processor>::push(
+  const DataType& x
+)
+{
+  return push(&x, 1) == 1;
+}
+
+
+template<class DataType, class Processor>
+std::size_t StreamingStage<DataType,Processor>::push(
+  const DataType* x,
+  std::size_t n
+)
+{
+  const std::size_t pushed = input_.push(x, n);
+  // only the producer writes the counter: no read-modify-write is needed
+  if(pushed < n)
+    overruns_.store(overruns_.load(std::memory_order_relaxed) + (n - pushed), std::memory_order_relaxed);
+  return pushed;
+}
+
+
+template<class DataType, class Processor>
+std::size_t StreamingStage<DataType,Processor>::process()
+{
+  std::size_t total = 0;
+  while(true) {
+    // never take more samples than the output queue can hold, so that
+    // filtered samples are never dropped
+    std::size_t n = std::min(batch_.size(), output_.writeAvailable());
+    n = input_.pop(batch_.data(), n);
+    if(n == 0)
+      break;
+    processor_.filter(batch_.data(), batch_.data(), n);
+    output_.push(batch_.data(), n);
+    total += n;
+  }
+  return total;
+}
+
+
+template<class DataType, class Processor>
+bool StreamingStage<DataType,Processor>::pop(
+  DataType& y
+)
+{
+  return pop(&y, 1) == 1;
+}
+
+
+template<class DataType, class Processor>
+std::size_t StreamingStage<DataType,Processor>::pop(
+  DataType* y,
+  std::size_t n
+)
+{
+  const std::size_t popped = output_.pop(y, n);
+  if(popped < n)
+    underruns_.store(underruns_.load(std::memory_order_relaxed) + (n - popped), std::memory_order_relaxed);
+  return popped;
+}
+
+} // namespace digital_filters
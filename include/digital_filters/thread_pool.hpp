@@ -0,0 +1,101 @@
+/** @file thread_pool.hpp
+  * @brief Header file containing the ThreadPool class.
+  */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace digital_filters {
+
+/// Pool of threads that execute independent tasks.
+/** Tasks are identified by an index. When a job is started, the indices are
+  * split into contiguous ranges, one per worker. Each worker consumes its own
+  * range from the front and, when it runs out of tasks, steals from the back
+  * of the ranges of the other workers. This keeps all workers busy even when
+  * tasks have very different costs.
+  *
+  * The thread that starts a job takes part in it as the worker with index
+  * zero. Therefore, a pool with a single worker does not spawn any thread.
+  */
+class ThreadPool {
+public:
+  /// Signature of a job: it receives the index of the task and the index of
+  /// the worker that runs it.
+  typedef std::function<void(std::size_t,std::size_t)> Job;
+
+  /// Creates a pool of threads.
+  /** @param workers number of workers, including the calling thread. If zero,
+    *   the number of hardware threads is used.
+    */
+  explicit ThreadPool(
+    std::size_t workers = 0
+  );
+
+  /// Stops and joins all threads.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Number of workers, including the calling thread.
+  inline std::size_t workers() const { return queues_.size(); }
+
+  /// Runs a job and waits for its completion.
+  /** Tasks might be executed in any order. If some tasks throw, the
+    * remaining ones are still executed, and the first exception is
+    * rethrown once the job is complete.
+    * @param tasks number of tasks to be executed.
+    * @param job function invoked once per task.
+    */
+  void run(
+    std::size_t tasks,
+    const Job& job
+  );
+
+private:
+  /// Tasks assigned to one worker.
+  struct Queue {
+    std::mutex mutex; ///< Protects the tasks.
+    std::deque<std::size_t> tasks; ///< Indices of the pending tasks.
+  };
+
+  /// Main loop of the spawned threads.
+  void loop(
+    std::size_t worker
+  );
+
+  /// Executes tasks until all queues are empty.
+  void work(
+    std::size_t worker,
+    const Job& job
+  );
+
+  /// Extracts a task, either from the own queue or from another one.
+  bool pop(
+    std::size_t worker,
+    std::size_t& task
+  );
+
+  std::vector<std::unique_ptr<Queue>> queues_; ///< One queue per worker.
+  std::vector<std::thread> threads_; ///< Spawned threads.
+  std::mutex mutex_; ///< Protects the fields below.
+  std::condition_variable wake_; ///< Signals new jobs or termination.
+  std::condition_variable done_; ///< Signals that workers left a job.
+  const Job* job_; ///< Running job, if any.
+  std::size_t generation_; ///< Counter of started jobs.
+  std::size_t active_; ///< Spawned threads working on the current job.
+  bool stop_; ///< Tells the spawned threads to terminate.
+  std::exception_ptr error_; ///< First exception thrown by a task.
+};
+
+} // namespace digital_filters
+
+#include <digital_filters/thread_pool.hxx>
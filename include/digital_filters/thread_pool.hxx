@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+
+
+namespace digital_filters {
+
+inline ThreadPool::ThreadPool(
+  std::size_t workers
+)
+: job_(nullptr)
+, generation_(0)
+, active_(0)
+, stop_(false)
+{
+  if(workers == 0)
+    workers = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  for(std::size_t w=0; w<workers; w++)
+    queues_.emplace_back(new Queue);
+  // worker zero is the thread that calls run()
+  for(std::size_t w=1; w<workers; w++)
+    threads_.emplace_back(&ThreadPool::loop, this, w);
+}
+
+
+inline ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for(auto& thread : threads_)
+    thread.join();
+}
+
+
+inline void ThreadPool::run(
+  std::size_t tasks,
+  const Job& job
+)
+{
+  if(tasks == 0)
+    return;
+  // split the tasks into contiguous ranges, one per worker
+  const std::size_t workers = queues_.size();
+  for(std::size_t w=0; w<workers; w++) {
+    std::lock_guard<std::mutex> lock(queues_[w]->mutex);
+    for(std::size_t t=w*tasks/workers; t<(w+1)*tasks/workers; t++)
+      queues_[w]->tasks.push_back(t);
+  }
+  // publish the job and wake up the other workers
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = &job;
+    generation_++;
+    error_ = nullptr;
+  }
+  wake_.notify_all();
+  // take part in the job, then wait for the other workers to leave it
+  work(0, job);
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]{ return active_ == 0; });
+    job_ = nullptr;
+    std::swap(error, error_);
+  }
+  if(error)
+    std::rethrow_exception(error);
+}
+
+
+inline void ThreadPool::loop(
+  std::size_t worker
+)
+{
+  std::size_t seen = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while(true) {
+    wake_.wait(lock, [&]{ return stop_ || (job_ && generation_ != seen); });
+    if(stop_)
+      return;
+    seen = generation_;
+    const Job* job = job_;
+    active_++;
+    lock.unlock();
+    work(worker, *job);
+    lock.lock();
+    if(--active_ == 0)
+      done_.notify_all();
+  }
+}
+
+
+inline void ThreadPool::work(
+  std::size_t worker,
+  const Job& job
+)
+{
+  std::size_t task;
+  while(pop(worker, task)) {
+    try {
+      job(task, worker);
+    }
+    catch(...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if(!error_)
+        error_ = std::current_exception();
+    }
+  }
+}
+
+
+inline bool ThreadPool::pop(
+  std::size_t worker,
+  std::size_t& task
+)
+{
+  // own tasks are consumed from the front...
+  {
+    Queue& queue = *queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if(!queue.tasks.empty()) {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+  // ...while other tasks are stolen from the back
+  for(std::size_t i=1; i<queues_.size(); i++) {
+    Queue& queue = *queues_[(worker+i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if(!queue.tasks.empty()) {
+      task = queue.tasks.back();
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace digital_filters
@@ -2,12 +2,20 @@
 
 #include <vector>
 #include <string>
+#include <cstddef>
 
 
 namespace digital_filters {
 
 /// Computes a polynomial product.
-/** @tparam Scalar type of the polynomal coefficients.
+/** The algorithm depends on the size of the smallest operand: short
+  * polynomials are multiplied directly, while Karatsuba's algorithm is used
+  * from polyProdKaratsubaThreshold() coefficients and, for floating point
+  * types, FFT-based convolution from polyProdFftThreshold() coefficients
+  * (see fftConvolve()). The rounding errors of the last two methods are
+  * relative to the largest coefficients of the product, rather than to each
+  * of them.
+  * @tparam Scalar type of the polynomal coefficients.
   * @param p1 Coefficients of the first polynomial, starting from degree zero.
   * @param p2 Coefficients of the second polynomial, starting from degree zero.
   * @return Coefficients of the polynomal product. As an example, if the two
@@ -21,6 +29,194 @@ std::vector<Scalar> polyProd(
 );
 
 
+/// Minimum size of both operands for polyProd() to use Karatsuba's
+/// algorithm.
+constexpr std::size_t polyProdKaratsubaThreshold() { return 64; }
+
+
+/// Minimum size of both operands for polyProd() to use FFT-based
+/// convolution, if the coefficients are floating point values.
+constexpr std::size_t polyProdFftThreshold() { return 512; }
+
+
+/// Product of two polynomials with the same size, via Karatsuba's
+/// algorithm.
+/** This is used by polyProd() for large operands. Each operand is split in
+  * two halves, so that the product requires three half-size products rather
+  * than four. Below polyProdKaratsubaThreshold() coefficients, products are
+  * evaluated directly.
+  * @tparam Scalar type of the polynomal coefficients.
+  * @param a pointer to the `n` coefficients of the first polynomial.
+  * @param b pointer to the `n` coefficients of the second polynomial.
+  * @param n number of coefficients of both polynomials.
+  * @param[out] r pointer to the `2n-1` coefficients of the product.
+  * @param scratch pointer to a buffer of at least `4n+320` values.
+  */
+template<class Scalar>
+void karatsuba(
+  const Scalar* a,
+  const Scalar* b,
+  std::size_t n,
+  Scalar* r,
+  Scalar* scratch
+);
+
+
+/// Multiplies a polynomial by another one, in-place.
+/** The product is accumulated from the highest degree down, so that no
+  * temporary buffer is needed: memory is only allocated if the capacity of
+  * `p` is not enough to store the result. This is meant for multiplying by
+  * many low-degree factors, *e.g.*, when expanding roots.
+  * @tparam Scalar type of the polynomal coefficients.
+  * @param[in,out] p Coefficients of the first polynomial, starting from
+  *   degree zero. It is replaced by the product.
+  * @param q pointer to the `m` coefficients of the second polynomial,
+  *   starting from degree zero.
+  * @param m number of coefficients of the second polynomial. It must be
+  *   positive.
+  */
+template<class Scalar>
+void polyMultiply(
+  std::vector<Scalar>& p,
+  const Scalar* q,
+  std::size_t m
+);
+
+
+/// Coefficients of the polynomial \f$ (1+x)^n \f$.
+/** They are evaluated in closed form, as the binomial coefficients
+  * \f$ \binom{n}{k} \f$, using the recurrence
+  * \f$ \binom{n}{k+1} = \binom{n}{k} \frac{n-k}{k+1} \f$.
+  * @tparam Scalar type of the polynomal coefficients.
+  * @param n degree of the polynomial.
+  * @return the `n+1` coefficients, starting from degree zero.
+  */
+template<class Scalar>
+std::vector<Scalar> binomialCoefficients(
+  unsigned int n
+);
+
+
+/// Coefficients of the polynomial \f$ (1+x)^n \f$, stored in a given vector.
+/** Same as binomialCoefficients(unsigned int), but the capacity of the
+  * output vector is reused if possible.
+  * @param n degree of the polynomial.
+  * @param c output vector, resized to `n+1` coefficients.
+  */
+template<class Scalar>
+void binomialCoefficients(
+  unsigned int n,
+  std::vector<Scalar>& c
+);
+
+
+/// Computes the steady-state of a filter in Direct Form II Transposed.
+/** When a constant unit input is applied for a long enough time, the output
+  * of a filter settles to its static gain \f$ G = \sum_j b_j / \sum_j a_j \f$
+  * and the state of its Direct Form II Transposed realization settles to:
+  * \f[
+  *   z_i = \sum_{j>i} \left( b_j - a_j G \right)
+  * \f]
+  * Scaling these values by \f$ x \f$ gives the state that produces no
+  * transient when the constant input \f$ x \f$ is filtered. This is the same
+  * quantity computed by SciPy's `lfilter_zi`.
+  * @tparam Scalar type of the polynomal coefficients.
+  * @param b numerator of the filter.
+  * @param a denominator of the filter, normalized so that \f$ a_0 = 1 \f$.
+  *   The sum of its coefficients must not be zero, *i.e.*, the filter must
+  *   not have a pole in \f$ z=1 \f$.
+  * @return state for a unit input, of size `max(b.size(),a.size())-1`.
+  */
+template <class Scalar>
+std::vector<Scalar> steadyState(
+  const std::vector<Scalar>& b,
+  const std::vector<Scalar>& a
+);
+
+
+/// Computes the steady-state of a filter in Direct Form II Transposed.
+/** Same as steadyState(const std::vector<Scalar>&, const std::vector<Scalar>&),
+  * but the result is written into a buffer provided by the caller, so that
+  * no memory is allocated.
+  * @param b numerator of the filter.
+  * @param a denominator of the filter, normalized so that \f$ a_0 = 1 \f$.
+  * @param[out] z pointer to `max(b.size(),a.size())-1` values.
+  */
+template <class Scalar>
+void steadyState(
+  const std::vector<Scalar>& b,
+  const std::vector<Scalar>& a,
+  Scalar* z
+);
+
+
+/// Evaluates the sine of an angle, in a `constexpr`-friendly way.
+/** Standard math functions cannot be used in `constexpr` contexts. This one
+  * is meant to be used while designing filters at compile time: at runtime,
+  * prefer `std::sin`.
+  * @tparam Scalar floating point type.
+  * @param x angle, in radians.
+  * @return \f$ \sin(x) \f$.
+  */
+template <class Scalar>
+constexpr Scalar constexprSin(
+  const Scalar& x
+);
+
+
+/// Evaluates the cosine of an angle, in a `constexpr`-friendly way.
+/** @tparam Scalar floating point type.
+  * @param x angle, in radians.
+  * @return \f$ \cos(x) \f$.
+  * @see constexprSin()
+  */
+template <class Scalar>
+constexpr Scalar constexprCos(
+  const Scalar& x
+);
+
+
+/// Evaluates the tangent of an angle, in a `constexpr`-friendly way.
+/** @tparam Scalar floating point type.
+  * @param x angle, in radians.
+  * @return \f$ \tan(x) \f$.
+  * @see constexprSin()
+  */
+template <class Scalar>
+constexpr Scalar constexprTan(
+  const Scalar& x
+);
+
+
+/// Evaluates the exponential function, in a `constexpr`-friendly way.
+/** @tparam Scalar floating point type.
+  * @param x exponent.
+  * @return \f$ e^x \f$. As for `std::exp`, the result is infinite for
+  *   \f$ x=+\infty \f$ and zero for \f$ x=-\infty \f$.
+  * @see constexprSin()
+  */
+template <class Scalar>
+constexpr Scalar constexprExp(
+  const Scalar& x
+);
+
+
+/// Adds a value to a sum, keeping track of the rounding error.
+/** This is one step of Neumaier's variant of Kahan summation. The accurate
+  * value of the sum is `sum + compensation`.
+  * @tparam Scalar type of the summed values.
+  * @param[in,out] sum running sum.
+  * @param[in,out] compensation accumulated rounding error.
+  * @param value the value to be added.
+  */
+template <class Scalar>
+void compensatedAdd(
+  Scalar& sum,
+  Scalar& compensation,
+  const Scalar& value
+);
+
+
 /// Generates a human readable string that represents the given input vector.
 template <class Scalar>
 std::string vec2str(
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <digital_filters/fft.hpp>
 #include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
 
 
 namespace digital_filters {
@@ -15,21 +21,43 @@ std::vector<Scalar> polyProd(
   // size as p1. To achieve something similar, use references!
   const auto& q1 = p1.size() < p2.size() ? p1 : p2;
   const auto& q2 = p1.size() < p2.size() ? p2 : p1;
-  unsigned int d1 = q1.size();
-  unsigned int d2 = q2.size();
+  std::size_t d1 = q1.size();
+  std::size_t d2 = q2.size();
+
+  // large operands: convolution in the frequency domain...
+  if constexpr(std::is_floating_point<Scalar>::value) {
+    if(d1 >= polyProdFftThreshold())
+      return fftConvolve(q1, q2);
+  }
+
+  // ...or Karatsuba's algorithm, splitting the longest operand into blocks
+  // with the same size as the shortest one
+  if(d1 >= polyProdKaratsubaThreshold()) {
+    std::vector<Scalar> p(d1+d2-1, Scalar(0));
+    std::vector<Scalar> block(d1, Scalar(0)), product(2*d1-1), scratch(4*d1+320);
+    for(std::size_t offset=0; offset<d2; offset+=d1) {
+      const std::size_t length = std::min(d1, d2-offset);
+      std::copy(q2.begin()+offset, q2.begin()+offset+length, block.begin());
+      std::fill(block.begin()+length, block.end(), Scalar(0));
+      karatsuba(q1.data(), block.data(), d1, product.data(), scratch.data());
+      for(std::size_t i=0; i<d1+length-1; i++)
+        p[offset+i] = p[offset+i] + product[i];
+    }
+    return p;
+  }
 
   // preallocate the space
   std::vector<Scalar> p(d1+d2-1);
 
   // initialize the elements while already doing some calculations
-  for(unsigned int i=0; i<d1; i++)
+  for(std::size_t i=0; i<d1; i++)
     p[i] = q1[i] * q2[0];
-  for(unsigned int j=1; j<d2; j++)
+  for(std::size_t j=1; j<d2; j++)
     p[j+d1-1] = q1[d1-1] * q2[j];
 
   // complete the polynomial
-  for(unsigned int i=0; i<d1-1; i++) {
-    for(unsigned int j=1; j<d2; j++) {
+  for(std::size_t i=0; i<d1-1; i++) {
+    for(std::size_t j=1; j<d2; j++) {
       p[i+j] = p[i+j] + q1[i] * q2[j];
     }
   }
@@ -39,6 +67,251 @@ std::vector<Scalar> polyProd(
 }
 
 
+template<class Scalar>
+void karatsuba(
+  const Scalar* a,
+  const Scalar* b,
+  std::size_t n,
+  Scalar* r,
+  Scalar* scratch
+)
+{
+  if(n < polyProdKaratsubaThreshold()) {
+    std::fill(r, r+2*n-1, Scalar(0));
+    for(std::size_t i=0; i<n; i++)
+      for(std::size_t j=0; j<n; j++)
+        r[i+j] = r[i+j] + a[i] * b[j];
+    return;
+  }
+
+  // a = a0 + x^h a1 and b = b0 + x^h b1, with a1 and b1 having m >= h
+  // coefficients: the low and high products go directly in the result
+  const std::size_t h = n / 2;
+  const std::size_t m = n - h;
+  karatsuba(a, b, h, r, scratch);
+  r[2*h-1] = Scalar(0);
+  karatsuba(a+h, b+h, m, r+2*h, scratch);
+
+  // the middle term is (a0+a1)(b0+b1) - a0 b0 - a1 b1
+  Scalar* sa = scratch;
+  Scalar* sb = scratch + m;
+  Scalar* mid = scratch + 2*m;
+  for(std::size_t i=0; i<m; i++) {
+    sa[i] = i < h ? a[i] + a[h+i] : a[h+i];
+    sb[i] = i < h ? b[i] + b[h+i] : b[h+i];
+  }
+  karatsuba(sa, sb, m, mid, scratch + 4*m - 1);
+  for(std::size_t i=0; i<2*h-1; i++)
+    mid[i] = mid[i] - r[i];
+  for(std::size_t i=0; i<2*m-1; i++)
+    mid[i] = mid[i] - r[2*h+i];
+  for(std::size_t i=0; i<2*m-1; i++)
+    r[h+i] = r[h+i] + mid[i];
+}
+
+
+template<class Scalar>
+void polyMultiply(
+  std::vector<Scalar>& p,
+  const Scalar* q,
+  std::size_t m
+)
+{
+  const std::size_t n = p.size();
+  p.resize(n+m-1, Scalar(0));
+  // each coefficient only depends on the ones of lower degree, which are
+  // still untouched when going from the highest degree down
+  for(std::size_t k=n+m-1; k-->0; ) {
+    const std::size_t first = k+1 > n ? k+1-n : 0;
+    const std::size_t last = std::min(k, m-1);
+    Scalar acc = q[first] * p[k-first];
+    for(std::size_t j=first+1; j<=last; j++)
+      acc = acc + q[j] * p[k-j];
+    p[k] = acc;
+  }
+}
+
+
+template<class Scalar>
+std::vector<Scalar> binomialCoefficients(
+  unsigned int n
+)
+{
+  std::vector<Scalar> c;
+  binomialCoefficients(n, c);
+  return c;
+}
+
+
+template<class Scalar>
+void binomialCoefficients(
+  unsigned int n,
+  std::vector<Scalar>& c
+)
+{
+  c.resize(n+1);
+  c[0] = 1;
+  for(unsigned int k=0; k<n; k++)
+    c[k+1] = c[k] * Scalar(n-k) / Scalar(k+1);
+}
+
+
+template <class Scalar>
+std::vector<Scalar> steadyState(
+  const std::vector<Scalar>& b,
+  const std::vector<Scalar>& a
+)
+{
+  std::vector<Scalar> z(std::max(b.size(), a.size()) - 1);
+  steadyState(b, a, z.data());
+  return z;
+}
+
+
+template <class Scalar>
+void steadyState(
+  const std::vector<Scalar>& b,
+  const std::vector<Scalar>& a,
+  Scalar* z
+)
+{
+  // evaluate the static gain
+  Scalar Sb = b.at(0), Sa = a.at(0);
+  for(unsigned int i=1; i<b.size(); i++)
+    Sb = Sb + b[i];
+  for(unsigned int i=1; i<a.size(); i++)
+    Sa = Sa + a[i];
+  if(Sa == Scalar(0))
+    throw std::runtime_error("steadyState: the filter has a pole in z=1");
+  const Scalar G = Sb / Sa;
+
+  // accumulate the contributions starting from the last state
+  Scalar acc = 0;
+  for(unsigned int i=std::max(b.size(), a.size())-1; i>0; i--) {
+    if(i < b.size())
+      acc = acc + b[i];
+    if(i < a.size())
+      acc = acc - a[i] * G;
+    z[i-1] = acc;
+  }
+}
+
+
+template <class Scalar>
+constexpr Scalar constexprSin(
+  const Scalar& x
+)
+{
+  const Scalar pi = static_cast<Scalar>(M_PI);
+  // bring the angle in the range [-pi, pi]
+  Scalar r = x - 2 * pi * static_cast<long long>(x / (2 * pi));
+  if(r > pi)
+    r = r - 2 * pi;
+  if(r < -pi)
+    r = r + 2 * pi;
+  // use sin(pi-r) = sin(r) to further reduce the range to [-pi/2, pi/2]
+  if(r > pi / 2)
+    r = pi - r;
+  if(r < -pi / 2)
+    r = -pi - r;
+  // Taylor series; in the reduced range, 15 terms are more than enough
+  Scalar term = r;
+  Scalar sum = r;
+  for(int n=1; n<15; n++) {
+    term = -term * r * r / static_cast<Scalar>((2*n) * (2*n+1));
+    sum = sum + term;
+  }
+  return sum;
+}
+
+
+template <class Scalar>
+constexpr Scalar constexprCos(
+  const Scalar& x
+)
+{
+  const Scalar pi = static_cast<Scalar>(M_PI);
+  // bring the angle in the range [0, pi], since the cosine is even
+  Scalar r = x - 2 * pi * static_cast<long long>(x / (2 * pi));
+  if(r < 0)
+    r = -r;
+  if(r > pi)
+    r = 2 * pi - r;
+  // use cos(pi-r) = -cos(r) to further reduce the range to [0, pi/2]
+  Scalar sign = 1;
+  if(r > pi / 2) {
+    r = pi - r;
+    sign = -1;
+  }
+  // Taylor series; in the reduced range, 15 terms are more than enough
+  Scalar term = 1;
+  Scalar sum = 1;
+  for(int n=1; n<15; n++) {
+    term = -term * r * r / static_cast<Scalar>((2*n-1) * (2*n));
+    sum = sum + term;
+  }
+  return sign * sum;
+}
+
+
+template <class Scalar>
+constexpr Scalar constexprTan(
+  const Scalar& x
+)
+{
+  return constexprSin(x) / constexprCos(x);
+}
+
+
+template <class Scalar>
+constexpr Scalar constexprExp(
+  const Scalar& x
+)
+{
+  // infinite exponents cannot be halved until they are small enough
+  if(x > std::numeric_limits<Scalar>::max())
+    return x;
+  if(x < std::numeric_limits<Scalar>::lowest())
+    return Scalar(0);
+  // use e^x = (e^(x/2))^2 until the argument is small enough
+  Scalar r = x;
+  unsigned int halvings = 0;
+  while(r > static_cast<Scalar>(0.5) || r < static_cast<Scalar>(-0.5)) {
+    r = r / 2;
+    halvings++;
+  }
+  // Taylor series
+  Scalar term = 1;
+  Scalar sum = 1;
+  for(int n=1; n<20; n++) {
+    term = term * r / static_cast<Scalar>(n);
+    sum = sum + term;
+  }
+  // undo the halvings
+  for(unsigned int i=0; i<halvings; i++)
+    sum = sum * sum;
+  return sum;
+}
+
+
+template <class Scalar>
+void compensatedAdd(
+  Scalar& sum,
+  Scalar& compensation,
+  const Scalar& value
+)
+{
+  using std::abs;
+  const Scalar t = sum + value;
+  // recover the low-order bits lost by the larger operand
+  if(abs(sum) >= abs(value))
+    compensation = compensation + ((sum - t) + value);
+  else
+    compensation = compensation + ((value - t) + sum);
+  sum = t;
+}
+
+
 template <class Scalar>
 std::string vec2str(
   const std::vector<Scalar>& vec,
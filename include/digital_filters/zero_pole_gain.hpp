@@ -0,0 +1,55 @@
+/** @file zero_pole_gain.hpp
+  * @brief Header file containing the ZeroPoleGain representation of transfer
+  *   functions.
+  */
+#pragma once
+
+#include <complex>
+#include <vector>
+
+namespace digital_filters {
+
+/// Transfer function described by its roots.
+/** The transfer function is:
+  * \f[
+  *   H(z) = k \frac{\prod_i \left( 1 - z_i z^{-1} \right)}
+  *                 {\prod_i \left( 1 - p_i z^{-1} \right)}
+  * \f]
+  * Filters are designed more accurately and faster in this form, and then
+  * expanded once into the coefficients of the numerator and of the
+  * denominator, see zpk2tf().
+  * @tparam CoeffType Type of the coefficients of the transfer function.
+  */
+template <class CoeffType>
+struct ZeroPoleGain {
+  std::vector<std::complex<CoeffType>> zeros; ///< Zeros \f$ z_i \f$.
+  std::vector<std::complex<CoeffType>> poles; ///< Poles \f$ p_i \f$.
+  CoeffType gain; ///< Gain \f$ k \f$.
+};
+
+
+/// Expands the roots of a transfer function into its coefficients.
+/** Complex roots must come in conjugate pairs, since the coefficients are
+  * real: each pair is expanded as a single real quadratic factor. Zeros in
+  * \f$ z=-1 \f$, which are very common in lowpass designs, are expanded in
+  * closed form as binomial coefficients. All other factors are multiplied
+  * in-place (see polyMultiply()), without temporary polynomials: if the
+  * output vectors have enough capacity, no memory is allocated for them.
+  * @param zpk roots and gain of the transfer function.
+  * @param[out] numerator numerator of the transfer function, as
+  *   coefficients of increasing powers of \f$ z^{-1} \f$.
+  * @param[out] denominator denominator of the transfer function, in the
+  *   same format. Its first coefficient is one.
+  * @note An exception is thrown if complex roots are not paired with their
+  *   conjugates.
+  */
+template <class CoeffType>
+void zpk2tf(
+  const ZeroPoleGain<CoeffType>& zpk,
+  std::vector<CoeffType>& numerator,
+  std::vector<CoeffType>& denominator
+);
+
+} // namespace digital_filters
+
+#include <digital_filters/zero_pole_gain.hxx>
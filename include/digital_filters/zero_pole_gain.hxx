@@ -0,0 +1,57 @@
+#pragma once
+
+#include <digital_filters/utilities.hpp>
+#include <stdexcept>
+#include <string>
+
+
+namespace digital_filters {
+
+template <class CoeffType>
+void zpk2tf(
+  const ZeroPoleGain<CoeffType>& zpk,
+  std::vector<CoeffType>& numerator,
+  std::vector<CoeffType>& denominator
+)
+{
+  // expands the product of the factors (1 - r z^-1)
+  auto expand = [](const std::vector<std::complex<CoeffType>>& roots, std::vector<CoeffType>& p, const std::string& what) {
+    const std::complex<CoeffType> minus_one(-1, 0);
+    std::size_t ones = 0, upper = 0, lower = 0;
+    for(const auto& r : roots) {
+      if(r == minus_one)
+        ones++;
+      else if(r.imag() > 0)
+        upper++;
+      else if(r.imag() < 0)
+        lower++;
+    }
+    if(upper != lower)
+      throw std::runtime_error("zpk2tf: complex " + what + " must come in conjugate pairs");
+
+    // (1+z^-1)^ones in closed form; the capacity of the output is reused if
+    // possible
+    p.reserve(roots.size() + 1);
+    binomialCoefficients(static_cast<unsigned int>(ones), p);
+    for(const auto& r : roots) {
+      if(r == minus_one || r.imag() < 0)
+        continue;
+      if(r.imag() == 0) {
+        const CoeffType factor[2] = {1, -r.real()};
+        polyMultiply(p, factor, 2);
+      }
+      else {
+        // the root and its conjugate, as a real quadratic factor
+        const CoeffType factor[3] = {1, -2*r.real(), std::norm(r)};
+        polyMultiply(p, factor, 3);
+      }
+    }
+  };
+
+  expand(zpk.zeros, numerator, "zeros");
+  expand(zpk.poles, denominator, "poles");
+  for(auto& n : numerator)
+    n = n * zpk.gain;
+}
+
+} // namespace digital_filters
@@ -0,0 +1,368 @@
+#include <digital_filters/filters.hpp>
+#include <digital_filters/filter_bank.hpp>
+#include <digital_filters/moving_average.hpp>
+#include <digital_filters/batch_filter.hpp>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// Command line options
+struct Options {
+  std::string input; // path to the input file
+  std::string output = "-"; // path to the output file, "-" for stdout
+  std::string type = "f64"; // sample format: "f32" or "f64"
+  std::size_t channels = 1; // number of interleaved channels
+  std::string design; // "butterworth", "average" or "exponential"
+  int order = 2; // order of the Butterworth filter
+  double cutoff = 0; // cutoff frequency of the Butterworth filter
+  double sampling = 0; // sampling frequency
+  int window = 0; // window size of the moving average
+  double alpha = 0; // smoothing coefficient of the exponential filter
+  double time_constant = 0; // time constant of the exponential filter
+  bool backward = false; // whether to filter in both directions
+  std::size_t padding = 0; // samples of odd-reflection padding
+  bool steady = false; // whether to start from the steady state
+  std::size_t block = 1 << 16; // frames processed at once
+  std::size_t threads = 0; // workers used in forward-backward mode
+};
+
+
+// Prints how to use this program
+void usage(
+  const char* name
+)
+{
+  std::fprintf(stderr,
+    "Usage: %s [options] <input> [output]\n"
+    "\n"
+    "Filters raw little-endian samples, optionally with interleaved channels.\n"
+    "The output has the same format as the input; it is written to stdout if\n"
+    "'output' is missing or equal to '-'.\n"
+    "\n"
+    "Data options:\n"
+    "  --type f32|f64         sample format (default: f64)\n"
+    "  --channels N           number of interleaved channels (default: 1)\n"
+    "\n"
+    "Design options:\n"
+    "  --butterworth ORDER    Butterworth filter, requires --cutoff and --sampling\n"
+    "  --cutoff HZ            cutoff frequency\n"
+    "  --sampling HZ          sampling frequency\n"
+    "  --average WINDOW       moving average over WINDOW samples\n"
+    "  --exponential ALPHA    exponential filter with smoothing coefficient ALPHA\n"
+    "  --time-constant SEC    exponential filter with the given time constant,\n"
+    "                         requires --sampling\n"
+    "\n"
+    "Processing options:\n"
+    "  --forward-backward     filter in both directions (zero phase); the whole\n"
+    "                         signal is loaded in memory\n"
+    "  --padding N            odd-reflection padding for --forward-backward\n"
+    "  --steady-state         start from the steady state for the first samples\n"
+    "                         (forward filtering only)\n"
+    "  --block FRAMES         frames processed at once (default: 65536)\n"
+    "  --threads N            threads used by --forward-backward (default: all)\n",
+    name
+  );
+}
+
+
+// Parses the command line, throwing in case of errors
+Options parse(
+  int argc,
+  char** argv
+)
+{
+  Options opts;
+  std::vector<std::string> positional;
+  for(int i=1; i<argc; i++) {
+    const std::string arg = argv[i];
+    // fetch the value of the current option
+    auto value = [&]() -> std::string {
+      if(i+1 >= argc)
+        throw std::runtime_error("missing value for option '" + arg + "'");
+      return argv[++i];
+    };
+    if(arg == "--type")
+      opts.type = value();
+    else if(arg == "--channels")
+      opts.channels = std::stoul(value());
+    else if(arg == "--butterworth") {
+      opts.design = "butterworth";
+      opts.order = std::stoi(value());
+    }
+    else if(arg == "--cutoff")
+      opts.cutoff = std::stod(value());
+    else if(arg == "--sampling")
+      opts.sampling = std::stod(value());
+    else if(arg == "--average") {
+      opts.design = "average";
+      opts.window = std::stoi(value());
+    }
+    else if(arg == "--exponential") {
+      opts.design = "exponential";
+      opts.alpha = std::stod(value());
+    }
+    else if(arg == "--time-constant") {
+      opts.design = "exponential";
+      opts.time_constant = std::stod(value());
+    }
+    else if(arg == "--forward-backward")
+      opts.backward = true;
+    else if(arg == "--padding")
+      opts.padding = std::stoul(value());
+    else if(arg == "--steady-state")
+      opts.steady = true;
+    else if(arg == "--block")
+      opts.block = std::stoul(value());
+    else if(arg == "--threads")
+      opts.threads = std::stoul(value());
+    else if(arg.size() > 1 && arg[0] == '-')
+      throw std::runtime_error("unknown option '" + arg + "'");
+    else
+      positional.push_back(arg);
+  }
+
+  // check the options
+  if(positional.empty() || positional.size() > 2)
+    throw std::runtime_error("expected an input and, optionally, an output file");
+  opts.input = positional[0];
+  if(positional.size() == 2)
+    opts.output = positional[1];
+  if(opts.type != "f32" && opts.type != "f64")
+    throw std::runtime_error("unknown sample format '" + opts.type + "'");
+  if(opts.channels == 0 || opts.block == 0)
+    throw std::runtime_error("channels and block size must be positive");
+  if(opts.design.empty())
+    throw std::runtime_error("no filter design was given");
+  if(opts.design == "butterworth" && (opts.cutoff <= 0 || opts.sampling <= 0))
+    throw std::runtime_error("Butterworth filters require --cutoff and --sampling");
+  if(opts.design == "exponential" && opts.time_constant > 0 && opts.sampling <= 0)
+    throw std::runtime_error("--time-constant requires --sampling");
+  return opts;
+}
+
+
+// Creates the filter selected on the command line
+template <class Scalar>
+digital_filters::Filter<Scalar,Scalar> design(
+  const Options& opts
+)
+{
+  if(opts.design == "butterworth")
+    return digital_filters::butterworth<Scalar,Scalar>(opts.order, opts.cutoff, opts.sampling);
+  if(opts.design == "average")
+    return digital_filters::average<Scalar,Scalar>(opts.window, Scalar(1));
+  if(opts.time_constant > 0)
+    return digital_filters::exponential<Scalar,Scalar>(1/opts.sampling, opts.time_constant);
+  return digital_filters::exponential<Scalar,Scalar>(opts.alpha);
+}
+
+
+// Writes samples to the output, throwing in case of errors
+template <class Scalar>
+void write(
+  const Scalar* data,
+  std::size_t count,
+  std::FILE* out
+)
+{
+  if(std::fwrite(data, sizeof(Scalar), count, out) != count)
+    throw std::runtime_error("failed to write the output");
+}
+
+
+// Filters forward, streaming one block of frames at a time
+template <class Scalar, class Filter>
+void forward(
+  Filter& filter,
+  const Scalar* x,
+  std::size_t frames,
+  std::size_t channels,
+  std::size_t block,
+  std::FILE* out
+)
+{
+  std::vector<Scalar> y(block * channels);
+  for(std::size_t f=0; f<frames; f+=block) {
+    const std::size_t len = std::min(block, frames - f);
+    filter.filter(x + f*channels, y.data(), len);
+    write(y.data(), len*channels, out);
+  }
+}
+
+
+// Filters the samples in the given format
+template <class Scalar>
+void run(
+  const Options& opts,
+  const Scalar* x,
+  std::size_t frames,
+  std::FILE* out
+)
+{
+  const std::size_t channels = opts.channels;
+  if(frames == 0)
+    return;
+
+  if(!opts.backward) {
+    // Moving averages have a dedicated implementation whose cost does not
+    // depend on the window size; other filters share a SIMD bank.
+    if(opts.design == "average") {
+      digital_filters::MovingAverageBank<Scalar,Scalar> bank(opts.window, channels);
+      if(opts.steady)
+        bank.initInput(x);
+      forward(bank, x, frames, channels, opts.block, out);
+    }
+    else if(channels == 1) {
+      // a bank does not pay off for a single channel
+      auto filter = design<Scalar>(opts);
+      if(opts.steady)
+        filter.initSteadyState(x[0]);
+      forward(filter, x, frames, channels, opts.block, out);
+    }
+    else {
+      digital_filters::FilterBank<Scalar,Scalar> bank(design<Scalar>(opts), channels);
+      if(opts.steady)
+        bank.initSteadyState(x);
+      forward(bank, x, frames, channels, opts.block, out);
+    }
+    return;
+  }
+
+  // Forward-backward filtering needs the whole signal of each channel: the
+  // channels are de-interleaved and filtered in parallel.
+  std::vector<Scalar> planar(frames * channels);
+  for(std::size_t f=0; f<frames; f++)
+    for(std::size_t c=0; c<channels; c++)
+      planar[c*frames+f] = x[f*channels+c];
+  if(opts.padding >= frames)
+    throw std::runtime_error("the padding must be shorter than the signal");
+  digital_filters::BatchFilter<Scalar,Scalar> batch(design<Scalar>(opts), opts.threads);
+  batch.filter2(
+    planar.data(),
+    planar.data(),
+    frames,
+    std::vector<std::size_t>(channels, frames),
+    opts.padding
+  );
+  // re-interleave and write one block at a time
+  std::vector<Scalar> y(opts.block * channels);
+  for(std::size_t f=0; f<frames; f+=opts.block) {
+    const std::size_t len = std::min(opts.block, frames - f);
+    for(std::size_t k=0; k<len; k++)
+      for(std::size_t c=0; c<channels; c++)
+        y[k*channels+c] = planar[c*frames+f+k];
+    write(y.data(), len*channels, out);
+  }
+}
+
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+  MappedFile(const std::string& path) : data_(nullptr), size_(0) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+      throw std::runtime_error("cannot open '" + path + "': " + std::strerror(errno));
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+      close(fd);
+      throw std::runtime_error("cannot stat '" + path + "': " + std::strerror(errno));
+    }
+    size_ = st.st_size;
+    if(size_ > 0) {
+      data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(data_ == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("cannot map '" + path + "': " + std::strerror(errno));
+      }
+      // the file is read once, from the beginning to the end
+      madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if(size_ > 0)
+      munmap(data_, size_);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const void* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+private:
+  void* data_;
+  std::size_t size_;
+};
+
+
+int main(int argc, char** argv) {
+  if(__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__) {
+    std::fprintf(stderr, "%s: only little-endian hosts are supported\n", argv[0]);
+    return 1;
+  }
+
+  for(int i=1; i<argc; i++) {
+    if(std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+      usage(argv[0]);
+      return 0;
+    }
+  }
+
+  Options opts;
+  try {
+    opts = parse(argc, argv);
+  }
+  catch(const std::exception& e) {
+    std::fprintf(stderr, "%s: %s\n\n", argv[0], e.what());
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    MappedFile input(opts.input);
+
+    // open the output, using a large buffer
+    std::FILE* out = opts.output == "-" ? stdout : std::fopen(opts.output.c_str(), "wb");
+    if(!out)
+      throw std::runtime_error("cannot open '" + opts.output + "': " + std::strerror(errno));
+    static char buffer[1 << 20];
+    std::setvbuf(out, buffer, _IOFBF, sizeof(buffer));
+
+    // filter the data
+    const std::size_t sample = opts.type == "f32" ? sizeof(float) : sizeof(double);
+    if(input.size() % (sample * opts.channels) != 0) {
+      throw std::runtime_error(
+        "the size of '" + opts.input + "' is not a multiple of " +
+        std::to_string(opts.channels) + " samples"
+      );
+    }
+    const std::size_t frames = input.size() / (sample * opts.channels);
+    if(opts.type == "f32")
+      run(opts, static_cast<const float*>(input.data()), frames, out);
+    else
+      run(opts, static_cast<const double*>(input.data()), frames, out);
+
+    if(std::fflush(out) != 0)
+      throw std::runtime_error("failed to write the output");
+    if(out != stdout)
+      std::fclose(out);
+  }
+  catch(const std::exception& e) {
+    std::fprintf(stderr, "%s: %s\n", argv[0], e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -44,7 +44,7 @@ int main(int argc, char** argv) {
   // write down the header and then the signals
   file << "time raw filter filter2" << std::endl;
   for(unsigned int i=0; i<x.size(); i++) {
-    file << i*dt << " " << x[i] << " " << y1[i] << " " << y2[i] << std::endl;
+    file << i*dt << " " << x[i] << " " << y1[i] << " " << y2[i] << "\n";
   }
 
   // close the file at the end
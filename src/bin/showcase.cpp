@@ -50,7 +50,7 @@ int main(int argc, char** argv) {
       file << " " << filt.second.filter(x);
 
     // don't forget this! ;)
-    file << std::endl;
+    file << "\n";
   }
 
   // close the file at the end
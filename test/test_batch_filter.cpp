@@ -0,0 +1,174 @@
+#include <digital_filters/filters.hpp>
+#include <digital_filters/batch_filter.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+typedef digital_filters::Filter<double,double> FilterDD;
+typedef digital_filters::BatchFilter<double,double> BatchFilterDD;
+
+
+// Signals with different lengths and contents
+std::vector<std::vector<double>> signals(
+  unsigned int count
+)
+{
+  std::vector<std::vector<double>> x(count);
+  for(unsigned int i=0; i<count; i++)
+    for(unsigned int k=0; k<50+37*(i%11); k++)
+      x[i].push_back(std::sin(0.01*k*(i+1)) + 0.5*std::cos(0.1*k + i));
+  return x;
+}
+
+
+// Check that all tasks run exactly once, and that exceptions are forwarded
+TEST(TestBatchFilter, ThreadPool) {
+  for(unsigned int workers : {1, 2, 7}) {
+    digital_filters::ThreadPool pool(workers);
+    ASSERT_EQ(pool.workers(), workers);
+    for(unsigned int repeat=0; repeat<5; repeat++) {
+      std::vector<std::atomic<int>> counts(1000);
+      pool.run(counts.size(), [&](std::size_t task, std::size_t worker) {
+        ASSERT_LT(worker, workers);
+        counts[task]++;
+      });
+      for(unsigned int i=0; i<counts.size(); i++)
+        ASSERT_EQ(counts[i], 1) << "task " << i;
+    }
+    ASSERT_THROW(
+      pool.run(100, [](std::size_t task, std::size_t) {
+        if(task == 42)
+          throw std::runtime_error("failure");
+      }),
+      std::runtime_error
+    );
+  }
+}
+
+
+// Check forward and bi-directional filtering against the sequential API
+TEST(TestBatchFilter, MatchesFilter) {
+  FilterDD F = digital_filters::butterworth<double,double>(4, 10., 100.);
+  F.initInput(0.3);
+  F.initOutput(0.3);
+  auto x = signals(200);
+  BatchFilterDD batch(F, 4);
+  auto y = batch.filter(x);
+  auto z = batch.filter2(x);
+  ASSERT_EQ(y.size(), x.size());
+  ASSERT_EQ(z.size(), x.size());
+  for(unsigned int i=0; i<x.size(); i++) {
+    FilterDD G = F;
+    auto z_ref = F.filter2(x[i]);
+    ASSERT_EQ(y[i].size(), x[i].size());
+    for(unsigned int k=0; k<x[i].size(); k++) {
+      ASSERT_NEAR(G.filter(x[i][k]), y[i][k], 1e-12) << "signal " << i << ", sample " << k;
+      ASSERT_NEAR(z_ref[k], z[i][k], 1e-9) << "signal " << i << ", sample " << k;
+    }
+  }
+}
+
+
+// Check that the results do not depend on the number of threads
+TEST(TestBatchFilter, Deterministic) {
+  FilterDD F = digital_filters::butterworth<double,double>(6, 5., 100.);
+  auto x = signals(300);
+  BatchFilterDD serial(F, 1);
+  auto y_ref = serial.filter2(x);
+  for(unsigned int threads : {2, 3, 8}) {
+    BatchFilterDD batch(F, threads);
+    ASSERT_EQ(batch.filter2(x), y_ref) << "with " << threads << " threads";
+  }
+}
+
+
+// Check the matrix interface and streaming blocks
+TEST(TestBatchFilter, MatrixAndStreams) {
+  FilterDD F = digital_filters::butterworth<double,double>(3, 20., 100.);
+  auto x = signals(40);
+  const std::size_t stride = 500;
+  std::vector<double> matrix(x.size()*stride, 0.);
+  std::vector<std::size_t> lengths;
+  for(unsigned int i=0; i<x.size(); i++) {
+    std::copy(x[i].begin(), x[i].end(), matrix.begin() + i*stride);
+    lengths.push_back(x[i].size());
+  }
+  BatchFilterDD batch(F, 3);
+
+  std::vector<double> y(matrix.size(), 0.), z = matrix;
+  batch.filter(matrix.data(), y.data(), stride, lengths);
+  batch.filter2(z.data(), z.data(), stride, lengths);
+  auto y_ref = batch.filter(x);
+  auto z_ref = batch.filter2(x);
+  for(unsigned int i=0; i<x.size(); i++) {
+    for(unsigned int k=0; k<x[i].size(); k++) {
+      ASSERT_EQ(y[i*stride+k], y_ref[i][k]);
+      ASSERT_EQ(z[i*stride+k], z_ref[i][k]);
+    }
+    // samples beyond the length of the row are untouched
+    ASSERT_EQ(y[i*stride+x[i].size()], 0.);
+  }
+
+  // streams keep their state across blocks
+  std::vector<FilterDD> streams(x.size(), F), references(x.size(), F);
+  const std::size_t n = 20;
+  for(unsigned int block=0; block<2; block++) {
+    batch.filterStreams(streams, matrix.data()+block*n, y.data()+block*n, stride, n);
+  }
+  for(unsigned int i=0; i<x.size(); i++)
+    for(unsigned int k=0; k<2*n; k++)
+      ASSERT_NEAR(references[i].filter(matrix[i*stride+k]), y[i*stride+k], 1e-12);
+}
+
+
+// Check that chunked filtering of a long signal matches the sequential path
+TEST(TestBatchFilter, ParallelInTime) {
+  std::vector<double> x;
+  for(unsigned int k=0; k<200000; k++)
+    x.push_back(std::sin(0.001*k) + 0.5*std::cos(0.3*k) + 2.0);
+  // tolerances relative to the peak output: a few tens of epsilon for well
+  // conditioned filters, looser ones for the poorly conditioned lowpass and
+  // for the integrator, whose rounding errors accumulate
+  const double eps = std::numeric_limits<double>::epsilon();
+  std::vector<std::pair<FilterDD,double>> filters{
+    {digital_filters::butterworth<double,double>(4, 2., 1000.), 1e-7},
+    {digital_filters::butterworth<double,double>(8, 200., 1000.), 32*eps},
+    {FilterDD({0.5, 0.5}, {1.0}), 32*eps},
+    {FilterDD({1.0}, {1.0, -1.0}), 1e-12} // integrator: the state never decays
+  };
+  for(const auto& test : filters) {
+    const FilterDD& F = test.first;
+    const double tolerance = test.second;
+    std::vector<double> x0(F.numerator().size()-1, 1.0);
+    std::vector<double> y0(F.denominator().size()-1, 1.5);
+    auto y_seq = F.filter(x, x0, y0);
+    double peak = 0;
+    for(auto v : y_seq)
+      peak = std::max(peak, std::abs(v));
+    // a single chunk is filtered sequentially, using a different realization
+    BatchFilterDD serial(F, 1);
+    auto y_ref = serial.filter(x, x0, y0);
+    for(unsigned int k=0; k<y_seq.size(); k++)
+      ASSERT_NEAR(y_seq[k], y_ref[k], tolerance*peak) << "sample " << k;
+    // chunks should add errors comparable to the sequential ones
+    for(unsigned int threads : {2, 3, 8}) {
+      BatchFilterDD batch(F, threads);
+      auto y = batch.filter(x, x0, y0);
+      ASSERT_EQ(y.size(), y_ref.size());
+      for(unsigned int k=0; k<y.size(); k++)
+        ASSERT_NEAR(y_ref[k], y[k], tolerance*peak) << "sample " << k << " with " << threads << " threads";
+    }
+  }
+  BatchFilterDD batch(filters[0].first, 2);
+  ASSERT_THROW(batch.filter(x, {}, {}), std::runtime_error);
+}
+
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
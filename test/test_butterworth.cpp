@@ -1,5 +1,7 @@
 #include <digital_filters/filters.hpp>
 #include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
 
 typedef digital_filters::Filter<double,double> FilterDD;
 
@@ -73,6 +75,57 @@ TEST_F(ButterworthFixture, Filtering) {
 }
 
 
+TEST_F(ButterworthFixture, ZeroPoleGain) {
+  digital_filters::ZeroPoleGain<double> zpk;
+  digital_filters::butterworth<double>(order, cutoff, sampling, zpk);
+  ASSERT_EQ(zpk.zeros.size(), order);
+  ASSERT_EQ(zpk.poles.size(), order);
+  for(const auto& p : zpk.poles)
+    EXPECT_LT(std::abs(p), 1.0);
+
+  // the expanded roots are the coefficients of the filter
+  std::vector<double> b, a;
+  digital_filters::zpk2tf(zpk, b, a);
+  ASSERT_EQ(b.size(), filter.numerator().size());
+  ASSERT_EQ(a.size(), filter.denominator().size());
+  for(unsigned int i=0; i<b.size(); i++) {
+    EXPECT_NEAR(b[i], filter.numerator()[i], 1e-12) << "Mismatching b[" << i << "]";
+    EXPECT_NEAR(a[i], filter.denominator()[i], 1e-12) << "Mismatching a[" << i << "]";
+  }
+
+  // roots must come in conjugate pairs
+  zpk.poles.pop_back();
+  if(order % 2 > 0)
+    zpk.poles.pop_back();
+  EXPECT_THROW(digital_filters::zpk2tf(zpk, b, a), std::runtime_error);
+}
+
+
+TEST(Butterworth, HighOrder) {
+  // the static gain is one and the filter matches its second-order sections
+  for(unsigned int order : {1, 2, 15, 32}) {
+    std::vector<double> b, a;
+    digital_filters::butterworth<double>(order, 20., 100., b, a);
+    ASSERT_EQ(b.size(), order+1);
+    ASSERT_EQ(a.size(), order+1);
+    double sb = 0, sa = 0;
+    for(unsigned int i=0; i<=order; i++) {
+      sb += b[i];
+      sa += a[i];
+    }
+    EXPECT_NEAR(sb / sa, 1., 1e-9) << "order " << order;
+
+    const auto S = digital_filters::butterworthSos<double,double>(order, 20., 100.);
+    const auto bs = S.numerator();
+    const auto as = S.denominator();
+    for(unsigned int i=0; i<=order; i++) {
+      EXPECT_NEAR(b[i], bs[i], 1e-9 * (1+std::abs(bs[i]))) << "order " << order << ", b[" << i << "]";
+      EXPECT_NEAR(a[i], as[i], 1e-9 * (1+std::abs(as[i]))) << "order " << order << ", a[" << i << "]";
+    }
+  }
+}
+
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,234 @@
+#include <digital_filters/filter_bank.hpp>
+#include <digital_filters/filter_chain.hpp>
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// Signal used by the tests
+std::vector<double> testSignal(std::size_t n) {
+  std::vector<double> x(n);
+  for(std::size_t k=0; k<n; k++)
+    x[k] = std::sin(0.05*k) + 0.3*std::cos(1.3*k);
+  return x;
+}
+
+
+// Check that restored filters continue exactly where the original stopped
+TEST(TestCheckpoint, Filter) {
+  const auto x = testSignal(600);
+  for(auto realization : {digital_filters::Realization::DirectFormI, digital_filters::Realization::DirectFormIITransposed}) {
+    auto design = digital_filters::butterworth<double,double>(5, 10., 100.);
+    digital_filters::Filter<double,double> F(design.numerator(), design.denominator(), realization);
+    F.setDenormalPolicy(digital_filters::DenormalPolicy::Offset);
+    std::vector<double> y(x.size());
+    F.filter(x.data(), y.data(), 300);
+
+    std::vector<unsigned char> buffer;
+    F.checkpoint(buffer);
+    EXPECT_EQ(buffer.size() % digital_filters::checkpointAlignment(), 0);
+    F.filter(x.data()+300, y.data()+300, 300);
+
+    // restore into a filter with a different structure...
+    digital_filters::Filter<double,double> G({1.}, {1.});
+    EXPECT_EQ(G.restore(buffer.data(), buffer.size()), buffer.size());
+    EXPECT_EQ(G.realization(), realization);
+    EXPECT_EQ(G.numerator(), F.numerator());
+    EXPECT_EQ(G.denominator(), F.denominator());
+    EXPECT_EQ(G.denormalPolicy(), digital_filters::DenormalPolicy::Offset);
+    for(std::size_t k=300; k<x.size(); k++)
+      ASSERT_EQ(G.filter(x[k]), y[k]) << "k=" << k;
+
+    // ...and into the same filter, which is rewound
+    F.restore(buffer.data(), buffer.size());
+    std::vector<double> z(300);
+    F.filter(x.data()+300, z.data(), z.size());
+    EXPECT_TRUE(std::equal(z.begin(), z.end(), y.begin()+300));
+  }
+}
+
+
+// Check a bank with many channels, restored from a memory-mapped file
+TEST(TestCheckpoint, FilterBank) {
+  const std::size_t channels = 1000;
+  const auto design = digital_filters::butterworth<float,double>(4, 5., 100.);
+  digital_filters::FilterBank<float,double> bank(design, channels);
+  std::vector<float> x(20*channels), y(x.size());
+  for(std::size_t i=0; i<x.size(); i++)
+    x[i] = std::sin(0.01f*i);
+  bank.filter(x.data(), y.data(), 10);
+
+  std::vector<unsigned char> buffer;
+  bank.checkpoint(buffer);
+  bank.filter(x.data()+10*channels, y.data()+10*channels, 10);
+
+  const std::string path = ::testing::TempDir() + "test_checkpoint_bank.bin";
+  std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+
+  digital_filters::FilterBank<float,double> other({1.}, {1.}, 1);
+#ifdef __unix__
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  ASSERT_GE(fd, 0);
+  struct stat info;
+  ASSERT_EQ(::fstat(fd, &info), 0);
+  void* mapped = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ASSERT_NE(mapped, MAP_FAILED);
+  EXPECT_EQ(other.restore(mapped, info.st_size), buffer.size());
+  ::munmap(mapped, info.st_size);
+  ::close(fd);
+#else
+  EXPECT_EQ(other.restore(buffer.data(), buffer.size()), buffer.size());
+#endif
+  std::remove(path.c_str());
+
+  EXPECT_EQ(other.channels(), channels);
+  std::vector<float> z(10*channels);
+  other.filter(x.data()+10*channels, z.data(), 10);
+  EXPECT_TRUE(std::equal(z.begin(), z.end(), y.begin()+10*channels));
+}
+
+
+// Check chains, whose records contain the ones of their stages
+TEST(TestCheckpoint, FilterChain) {
+  const auto x = testSignal(1000);
+  digital_filters::FilterChain<double> chain(64);
+  chain.append(digital_filters::exponential<double,double>(0.3));
+  chain.appendFunction([](double v) { return std::max(-0.8, std::min(0.8, v)); });
+  chain.append(digital_filters::butterworthSos<double,double>(6, 10., 100.));
+  std::vector<double> y(x.size());
+  chain.filter(x.data(), y.data(), 500);
+
+  // several records can share the same buffer
+  std::vector<unsigned char> buffer;
+  auto F = digital_filters::exponential<double,double>(0.5);
+  F.checkpoint(buffer);
+  const std::size_t offset = buffer.size();
+  chain.checkpoint(buffer);
+  chain.filter(x.data()+500, y.data()+500, 500);
+
+  auto other = chain;
+  other.setTileSize(0);
+  other.filter(x.data(), y.data(), 10);
+  EXPECT_EQ(other.restore(buffer.data()+offset, buffer.size()-offset), buffer.size()-offset);
+  EXPECT_EQ(other.tileSize(), 64);
+  for(std::size_t k=500; k<x.size(); k++)
+    ASSERT_EQ(other.filter(x[k]), y[k]) << "k=" << k;
+
+  // stages must have the same structure
+  digital_filters::FilterChain<double> shorter;
+  shorter.append(digital_filters::exponential<double,double>(0.3));
+  EXPECT_THROW(shorter.restore(buffer.data()+offset, buffer.size()-offset), std::runtime_error);
+  digital_filters::FilterChain<double> swapped;
+  swapped.append(digital_filters::butterworthSos<double,double>(6, 10., 100.));
+  swapped.appendFunction([](double v) { return v; });
+  swapped.append(digital_filters::exponential<double,double>(0.3));
+  EXPECT_THROW(swapped.restore(buffer.data()+offset, buffer.size()-offset), std::runtime_error);
+
+  // a failed restore does not modify any stage
+  digital_filters::FilterChain<double> mismatched;
+  auto& first = mismatched.append(digital_filters::exponential<double,double>(0.7));
+  mismatched.appendFunction([](double v) { return v; });
+  mismatched.append(digital_filters::exponential<double,double>(0.3));
+  first.filter(1.);
+  auto copy = mismatched;
+  EXPECT_THROW(mismatched.restore(buffer.data()+offset, buffer.size()-offset), std::runtime_error);
+  for(std::size_t k=0; k<10; k++)
+    ASSERT_EQ(mismatched.filter(x[k]), copy.filter(x[k])) << "k=" << k;
+
+  // stages without checkpoints cannot be saved
+  chain.append(digital_filters::MovingAverage<double,double>(4));
+  EXPECT_THROW(chain.checkpoint(buffer), std::runtime_error);
+}
+
+
+// Check that invalid records are rejected without modifying the filter
+TEST(TestCheckpoint, Invalid) {
+  auto F = digital_filters::butterworth<double,double>(2, 10., 100.);
+  F.filter(1.);
+  std::vector<unsigned char> buffer;
+  F.checkpoint(buffer);
+
+  // different template types
+  digital_filters::Filter<float,float> G({1.f}, {1.f});
+  EXPECT_THROW(G.restore(buffer.data(), buffer.size()), std::runtime_error);
+  // different kind of object
+  digital_filters::FilterBank<double,double> bank({1.}, {1.}, 4);
+  EXPECT_THROW(bank.restore(buffer.data(), buffer.size()), std::runtime_error);
+
+  auto H = digital_filters::exponential<double,double>(0.5);
+  const auto b = H.numerator();
+  // truncated record
+  EXPECT_THROW(H.restore(buffer.data(), buffer.size()-16), std::runtime_error);
+  // misaligned record
+  std::vector<unsigned char> shifted(buffer.size()+8);
+  std::copy(buffer.begin(), buffer.end(), shifted.begin()+8);
+  EXPECT_THROW(H.restore(shifted.data()+8, buffer.size()), std::runtime_error);
+  // newer version
+  auto header = digital_filters::checkpointHeader<double>(digital_filters::CheckpointKind::Filter);
+  std::vector<unsigned char> future = buffer;
+  header.version = digital_filters::checkpointVersion() + 1;
+  std::copy_n(reinterpret_cast<const unsigned char*>(&header.version), sizeof(header.version), future.begin()+4);
+  EXPECT_THROW(H.restore(future.data(), future.size()), std::runtime_error);
+  // invalid realization
+  std::vector<unsigned char> corrupted = buffer;
+  corrupted[sizeof(digital_filters::CheckpointHeader)+16] = 7;
+  EXPECT_THROW(H.restore(corrupted.data(), corrupted.size()), std::runtime_error);
+  EXPECT_EQ(H.numerator(), b);
+  // ring-buffer heads outside the histories
+  digital_filters::Filter<double,double> D(F.numerator(), F.denominator(), digital_filters::Realization::DirectFormI);
+  D.filter(1.);
+  std::vector<unsigned char> dfi;
+  D.checkpoint(dfi);
+  const std::size_t fields = sizeof(digital_filters::CheckpointHeader) + 16;
+  for(std::size_t i : {1, 2}) {
+    corrupted = dfi;
+    const std::uint64_t head = 5;
+    std::copy_n(reinterpret_cast<const unsigned char*>(&head), sizeof(head), corrupted.begin()+fields+i*sizeof(head));
+    EXPECT_THROW(H.restore(corrupted.data(), corrupted.size()), std::runtime_error);
+  }
+  // more samples since the last flush than the flushing interval
+  corrupted = dfi;
+  const std::uint64_t unflushed = 1u << 20;
+  std::copy_n(reinterpret_cast<const unsigned char*>(&unflushed), sizeof(unflushed), corrupted.begin()+fields+5*sizeof(unflushed));
+  EXPECT_THROW(H.restore(corrupted.data(), corrupted.size()), std::runtime_error);
+  EXPECT_EQ(H.numerator(), b);
+  EXPECT_EQ(H.restore(dfi.data(), dfi.size()), dfi.size());
+
+  // sections with a0 different from one
+  auto S = digital_filters::butterworthSos<double,double>(4, 10., 100.);
+  std::vector<unsigned char> sos;
+  S.checkpoint(sos);
+  const std::size_t a0 = sizeof(digital_filters::CheckpointHeader) + 16 + 3*sizeof(double);
+  const double zero = 0.;
+  std::copy_n(reinterpret_cast<const unsigned char*>(&zero), sizeof(zero), sos.begin()+a0);
+  digital_filters::SosFilter<double,double> T({});
+  EXPECT_THROW(T.restore(sos.data(), sos.size()), std::runtime_error);
+  EXPECT_TRUE(T.sections().empty());
+  // an empty cascade is the identity filter, which is valid
+  sos.clear();
+  T.checkpoint(sos);
+  EXPECT_EQ(S.restore(sos.data(), sos.size()), sos.size());
+  EXPECT_TRUE(S.sections().empty());
+  EXPECT_EQ(S.filter(2.), 2.);
+
+  EXPECT_TRUE(digital_filters::SupportsCheckpoint<decltype(F)>::value);
+  EXPECT_FALSE((digital_filters::SupportsCheckpoint<digital_filters::MovingAverage<double,double>>::value));
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
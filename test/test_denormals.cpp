@@ -0,0 +1,135 @@
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+// Number of denormal values in a sequence
+std::size_t countDenormals(
+  const std::vector<float>& y
+)
+{
+  std::size_t count = 0;
+  for(const auto& yk : y)
+    if(std::fpclassify(yk) == FP_SUBNORMAL)
+      count++;
+  return count;
+}
+
+
+// Check the threshold and the flushing of small values
+TEST(TestDenormals, Threshold) {
+  const float tf = digital_filters::denormalThreshold<float>();
+  const double td = digital_filters::denormalThreshold<double>();
+  EXPECT_GT(tf, 1e-20f);
+  EXPECT_LT(tf, 1e-18f);
+  EXPECT_GT(td, 1e-155);
+  EXPECT_LT(td, 1e-153);
+  EXPECT_EQ(digital_filters::denormalThreshold<int>(), 0);
+
+  std::vector<float> x = {1e-30f, -1e-25f, 1.f, 0.f, -2e-10f, 1e-40f};
+  digital_filters::flushDenormals(x.data(), x.size());
+  EXPECT_EQ(x, std::vector<float>({0.f, 0.f, 1.f, 0.f, -2e-10f, 0.f}));
+}
+
+
+// Check that the guard sets and restores the flags
+TEST(TestDenormals, Guard) {
+  if(!digital_filters::DenormalGuard::supported())
+    GTEST_SKIP() << "Denormal flags are not supported on this architecture";
+  volatile float x = std::numeric_limits<float>::min();
+  volatile float y = x * 0.5f;
+  ASSERT_EQ(std::fpclassify(y), FP_SUBNORMAL);
+  {
+    digital_filters::DenormalGuard guard;
+    {
+      // nested guards do nothing
+      digital_filters::DenormalGuard inner;
+    }
+    y = x * 0.5f;
+    EXPECT_EQ(y, 0.f);
+  }
+  y = x * 0.5f;
+  EXPECT_EQ(std::fpclassify(y), FP_SUBNORMAL);
+  {
+    digital_filters::DenormalGuard disabled(false);
+    y = x * 0.5f;
+    EXPECT_EQ(std::fpclassify(y), FP_SUBNORMAL);
+  }
+}
+
+
+// Check that all policies prevent denormal outputs after an impulse
+TEST(TestDenormals, Policies) {
+  // slowly decaying filter, with a pole in z=0.99
+  std::vector<float> b, a;
+  digital_filters::exponential<float>(0.01f, b, a);
+  std::vector<float> x(20000, 0.f);
+  x[0] = 1.f;
+
+  for(auto realization : {digital_filters::Realization::DirectFormI, digital_filters::Realization::DirectFormIITransposed}) {
+    digital_filters::Filter<float,float> reference(b, a, realization);
+    std::vector<float> expected(x.size());
+    for(std::size_t k=0; k<x.size(); k++)
+      expected[k] = reference.filter(x[k]);
+    ASSERT_GT(countDenormals(expected), 0);
+
+    for(auto policy : {digital_filters::DenormalPolicy::FlushToZero, digital_filters::DenormalPolicy::Offset, digital_filters::DenormalPolicy::FlushState}) {
+      digital_filters::Filter<float,float> F(b, a, realization);
+      F.setDenormalPolicy(policy);
+      EXPECT_EQ(F.denormalPolicy(), policy);
+      EXPECT_EQ((F.as<float,double>().denormalPolicy()), policy);
+
+      // one sample at a time
+      std::vector<float> y(x.size());
+      for(std::size_t k=0; k<x.size(); k++)
+        y[k] = F.filter(x[k]);
+      EXPECT_EQ(countDenormals(y), 0) << "policy " << int(policy);
+      for(std::size_t k=0; k<1000; k++)
+        ASSERT_NEAR(y[k], expected[k], 1e-6f) << "policy " << int(policy) << ", k=" << k;
+
+      // blocks of different sizes, in-place
+      F.initInput(0.f);
+      F.initOutput(0.f);
+      y = x;
+      for(std::size_t k=0, length=1; k<y.size(); k+=length, length=2*length+1)
+        F.filter(y.data()+k, y.data()+k, std::min(length, y.size()-k));
+      EXPECT_EQ(countDenormals(y), 0) << "policy " << int(policy);
+      for(std::size_t k=0; k<1000; k++)
+        ASSERT_NEAR(y[k], expected[k], 1e-6f) << "policy " << int(policy) << ", k=" << k;
+
+      // bi-directional filtering
+      F.filter2(x.data(), y.data(), x.size());
+      EXPECT_EQ(countDenormals(y), 0) << "policy " << int(policy);
+    }
+  }
+
+  // mixed precision: the Direct Form I feeds back single precision outputs
+  std::vector<double> bd(b.begin(), b.end()), ad(a.begin(), a.end());
+  digital_filters::Filter<float,double> reference(bd, ad, digital_filters::Realization::DirectFormI);
+  std::vector<float> expected(x.size());
+  reference.filter(x.data(), expected.data(), x.size());
+  ASSERT_GT(countDenormals(expected), 0);
+  for(auto policy : {digital_filters::DenormalPolicy::FlushToZero, digital_filters::DenormalPolicy::Offset, digital_filters::DenormalPolicy::FlushState}) {
+    digital_filters::Filter<float,double> F(bd, ad, digital_filters::Realization::DirectFormI);
+    F.setDenormalPolicy(policy);
+    std::vector<float> y(x.size());
+    for(std::size_t k=0; k<x.size(); k++)
+      y[k] = F.filter(x[k]);
+    EXPECT_EQ(countDenormals(y), 0) << "policy " << int(policy);
+    for(std::size_t k=0; k<1000; k++)
+      ASSERT_NEAR(y[k], expected[k], 1e-6f) << "policy " << int(policy) << ", k=" << k;
+
+    F.initInput(0.f);
+    F.initOutput(0.f);
+    F.filter(x.data(), y.data(), x.size());
+    EXPECT_EQ(countDenormals(y), 0) << "policy " << int(policy);
+  }
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
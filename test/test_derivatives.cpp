@@ -0,0 +1,96 @@
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+
+// Check the coefficients against the ones of SciPy's savgol_coeffs
+TEST(TestDerivatives, Coefficients) {
+  // savgol_coeffs(5, 2) and savgol_coeffs(5, 2, deriv=1)
+  const std::vector<double> smooth = {-3./35, 12./35, 17./35, 12./35, -3./35};
+  const std::vector<double> slope = {-0.2, -0.1, 0., 0.1, 0.2};
+  const auto& c0 = digital_filters::savitzkyGolayCoefficients<double>(5, 2, 0);
+  const auto& c1 = digital_filters::savitzkyGolayCoefficients<double>(5, 2, 1);
+  ASSERT_EQ(c0.size(), 5);
+  ASSERT_EQ(c1.size(), 5);
+  for(unsigned int i=0; i<5; i++) {
+    EXPECT_NEAR(c0[i], smooth[i], 1e-14) << "i=" << i;
+    EXPECT_NEAR(c1[i], slope[i], 1e-14) << "i=" << i;
+  }
+  // tables are cached
+  EXPECT_EQ(&c0, &digital_filters::savitzkyGolayCoefficients<double>(5, 2, 0));
+
+  // the numerator starts from the newest sample
+  const auto F = digital_filters::savitzkyGolay<double,double>(5, 2, 1, 0.5);
+  for(unsigned int i=0; i<5; i++)
+    EXPECT_NEAR(F.numerator()[i], slope[4-i] / 0.5, 1e-14) << "i=" << i;
+
+  EXPECT_THROW(digital_filters::savitzkyGolayCoefficients<double>(4, 2, 0), std::runtime_error);
+  EXPECT_THROW(digital_filters::savitzkyGolayCoefficients<double>(5, 5, 0), std::runtime_error);
+  EXPECT_THROW(digital_filters::savitzkyGolayCoefficients<double>(5, 2, 3), std::runtime_error);
+  EXPECT_THROW((digital_filters::SavitzkyGolay<double,double>(0, 0, 0)), std::runtime_error);
+}
+
+
+// Check that polynomial signals and their derivatives are reproduced exactly
+TEST(TestDerivatives, Polynomials) {
+  const double dt = 0.01;
+  auto p = [](double t) { return 1 - 2*t + 3*t*t - 0.5*t*t*t; };
+  auto dp = [](double t) { return -2 + 6*t - 1.5*t*t; };
+  auto ddp = [](double t) { return 6 - 3*t; };
+
+  for(unsigned int window : {7, 21}) {
+    digital_filters::SavitzkyGolay<double,double> S(window, 3, 2, dt);
+    EXPECT_EQ(S.windowSize(), window);
+    EXPECT_EQ(S.delay(), (window - 1) / 2);
+    for(int k=0; k<100; k++) {
+      const auto& y = S.filter(p(k*dt));
+      ASSERT_EQ(y.size(), 3);
+      if(k + 1 < int(window))
+        continue;
+      const double t = (k - int(S.delay())) * dt;
+      EXPECT_NEAR(y[0], p(t), 1e-10) << "window " << window << ", k=" << k;
+      EXPECT_NEAR(y[1], dp(t), 1e-8) << "window " << window << ", k=" << k;
+      EXPECT_NEAR(y[2], ddp(t), 1e-5) << "window " << window << ", k=" << k;
+    }
+  }
+}
+
+
+// Check that the kernel matches the equivalent FIR filters
+TEST(TestDerivatives, SameAsFilters) {
+  const unsigned int window = 11, polyorder = 4, derivatives = 3;
+  const double dt = 0.1;
+  digital_filters::SavitzkyGolay<double,double> S(window, polyorder, derivatives, dt);
+  std::vector<digital_filters::Filter<double,double>> filters;
+  for(unsigned int d=0; d<=derivatives; d++) {
+    filters.push_back(digital_filters::savitzkyGolay<double,double>(window, polyorder, d, dt));
+    const auto h = S.coefficients(d);
+    ASSERT_EQ(h.size(), window);
+    for(unsigned int i=0; i<window; i++)
+      EXPECT_NEAR(h[i], filters[d].numerator()[i], 1e-12) << "derivative " << d << ", i=" << i;
+  }
+
+  const std::size_t n = 300;
+  std::vector<double> x(n), y(n*(derivatives+1));
+  for(std::size_t k=0; k<n; k++)
+    x[k] = std::sin(0.05*k) + 0.2*std::cos(0.9*k);
+  S.filter(x.data(), y.data(), n);
+  for(std::size_t k=0; k<n; k++)
+    for(unsigned int d=0; d<=derivatives; d++)
+      ASSERT_NEAR(y[k*(derivatives+1)+d], filters[d].filter(x[k]), 1e-9) << "derivative " << d << ", k=" << k;
+
+  // a constant window is smoothed into itself, with zero derivatives
+  S.initInput(2.5);
+  const auto& z = S.filter(2.5);
+  EXPECT_NEAR(z[0], 2.5, 1e-12);
+  for(unsigned int d=1; d<=derivatives; d++)
+    EXPECT_NEAR(z[d], 0., 1e-9);
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,86 @@
+#include <digital_filters/design_cache.hpp>
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+typedef digital_filters::Filter<double,double> FilterDD;
+
+
+// Check that cached designs match the ones of the design functions
+TEST(TestDesignCache, SameAsDesign) {
+  digital_filters::DesignCache<double> cache;
+  // designs are not normalized, hence filters are compared
+  auto check = [](const digital_filters::DesignCache<double>::Design& design, const FilterDD& filter) {
+    const FilterDD cached(design.numerator, design.denominator);
+    ASSERT_EQ(cached.numerator().size(), filter.numerator().size());
+    ASSERT_EQ(cached.denominator().size(), filter.denominator().size());
+    for(unsigned int i=0; i<cached.numerator().size(); i++)
+      EXPECT_NEAR(cached.numerator()[i], filter.numerator()[i], 1e-12) << "b[" << i << "]";
+    for(unsigned int i=0; i<cached.denominator().size(); i++)
+      EXPECT_NEAR(cached.denominator()[i], filter.denominator()[i], 1e-12) << "a[" << i << "]";
+  };
+  check(cache.butterworth(4, 10., 100.), digital_filters::butterworth<double,double>(4, 10., 100.));
+  check(cache.average(5), digital_filters::average<double,double>(5));
+  check(cache.exponential(0.2), digital_filters::exponential<double,double>(0.2));
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_EQ(cache.misses(), 3);
+  EXPECT_EQ(cache.hits(), 0);
+}
+
+
+// Check that repeated requests are served from the cache
+TEST(TestDesignCache, Hits) {
+  digital_filters::DesignCache<double> cache(2);
+  const auto* first = &cache.butterworth(3, 10., 100.);
+  // the key is the normalized cutoff
+  EXPECT_EQ(first, &cache.butterworth(3, 20., 200.));
+  EXPECT_NE(first, &cache.butterworth(2, 10., 100.));
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 2);
+
+  // the least recently used design is evicted
+  cache.butterworth(3, 10., 100.);
+  cache.exponential(0.5);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(first, &cache.butterworth(3, 10., 100.));
+  EXPECT_EQ(cache.misses(), 3);
+
+  // invalid designs are not stored
+  EXPECT_THROW(cache.butterworth(3, 60., 100.), std::runtime_error);
+  EXPECT_EQ(cache.size(), 2);
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.hits(), 0);
+  EXPECT_THROW(digital_filters::DesignCache<double>(0), std::runtime_error);
+}
+
+
+// Check retuning a running filter with cached designs
+TEST(TestDesignCache, Retune) {
+  digital_filters::DesignCache<double> cache;
+  const double fs = 1000.;
+  for(auto realization : {
+    digital_filters::Realization::DirectFormI,
+    digital_filters::Realization::DirectFormIITransposed
+  })
+  {
+    const auto& initial = cache.butterworth(4, 50., fs);
+    FilterDD F(initial.numerator, initial.denominator, realization);
+    F.initSteadyState(1.0);
+    // a constant signal goes through unchanged, whatever the cutoff
+    for(int k=0; k<1000; k++) {
+      const auto& design = cache.butterworth(4, 50. + 10.*(k % 7), fs);
+      F.setCoefficients(design.numerator, design.denominator);
+      ASSERT_NEAR(F.filter(1.0), 1.0, 1e-9) << "at step k=" << k;
+    }
+  }
+  EXPECT_EQ(cache.misses(), 7);
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
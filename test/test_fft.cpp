@@ -0,0 +1,108 @@
+#include <digital_filters/fft_filter.hpp>
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+typedef digital_filters::Filter<double,double> FilterDD;
+typedef digital_filters::FftFilter<double,double> FftFilterDD;
+
+
+// Random sequence used in most tests
+std::vector<double> randomVector(
+  unsigned int size,
+  unsigned int seed
+)
+{
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  std::vector<double> v(size);
+  for(auto& vi : v)
+    vi = dist(gen);
+  return v;
+}
+
+
+// Compare transforms against the definition of the DFT
+TEST(TestFft, Transform) {
+  const unsigned int N = 16;
+  auto re = randomVector(N, 1);
+  auto im = randomVector(N, 2);
+  std::vector<std::complex<double>> x(N);
+  for(unsigned int i=0; i<N; i++)
+    x[i] = std::complex<double>(re[i], im[i]);
+  auto X = x;
+  digital_filters::FftPlan<double> plan(N);
+  plan.forward(X.data());
+  for(unsigned int k=0; k<N; k++) {
+    std::complex<double> Xk;
+    for(unsigned int n=0; n<N; n++)
+      Xk += x[n] * std::polar(1.0, -2*M_PI*k*n/N);
+    ASSERT_NEAR(Xk.real(), X[k].real(), 1e-12) << "at k=" << k;
+    ASSERT_NEAR(Xk.imag(), X[k].imag(), 1e-12) << "at k=" << k;
+  }
+  plan.inverse(X.data());
+  for(unsigned int n=0; n<N; n++) {
+    ASSERT_NEAR(x[n].real(), X[n].real(), 1e-12) << "at n=" << n;
+    ASSERT_NEAR(x[n].imag(), X[n].imag(), 1e-12) << "at n=" << n;
+  }
+  ASSERT_THROW(digital_filters::FftPlan<double>(12), std::runtime_error);
+}
+
+
+// FFT-based convolution should be the same as a polynomial product
+TEST(TestFft, Convolution) {
+  auto p1 = randomVector(37, 3);
+  auto p2 = randomVector(100, 4);
+  auto pa = digital_filters::polyProd(p1, p2);
+  auto pb = digital_filters::fftConvolve(p1, p2);
+  ASSERT_EQ(pa.size(), pb.size());
+  for(unsigned int i=0; i<pa.size(); i++)
+    ASSERT_NEAR(pa[i], pb[i], 1e-12) << "at i=" << i;
+}
+
+
+// Long FIR filters should give the same result with and without FFT
+TEST(TestFft, FilterSequence) {
+  FilterDD F(randomVector(300, 5), {2.0});
+  auto x = randomVector(5000, 6);
+  auto x0 = randomVector(299, 7);
+  ASSERT_LE(F.fftThreshold(), 300);
+  auto yfft = F.filter(x, x0, {});
+  F.setFftThreshold(0);
+  auto ydirect = F.filter(x, x0, {});
+  ASSERT_EQ(yfft.size(), ydirect.size());
+  for(unsigned int i=0; i<x.size(); i++)
+    ASSERT_NEAR(ydirect[i], yfft[i], 1e-11) << "at i=" << i;
+}
+
+
+// Partitioned convolution should behave as a regular filter
+TEST(TestFft, FftFilter) {
+  auto x = randomVector(3000, 8);
+  for(unsigned int taps : {1, 10, 16, 17, 64, 500}) {
+    for(std::size_t partition : {0, 16, 64}) {
+      FilterDD F(randomVector(taps, taps), {1.0});
+      FftFilterDD G(F, partition);
+      auto x0 = randomVector(taps-1, 9);
+      F.initInput(x0);
+      G.initInput(x0);
+      // filter the first half sample-by-sample, then the rest in one block
+      std::vector<double> y(x.size());
+      for(unsigned int i=0; i<x.size()/2; i++)
+        y[i] = G.filter(x[i]);
+      G.filter(&x[x.size()/2], &y[x.size()/2], x.size()-x.size()/2);
+      for(unsigned int i=0; i<x.size(); i++)
+        ASSERT_NEAR(F.filter(x[i]), y[i], 1e-11) << "taps=" << taps << ", partition=" << G.partition() << ", i=" << i;
+    }
+  }
+  // only FIR filters can be converted
+  FilterDD iir({1.0}, {1.0, 0.5});
+  ASSERT_THROW(FftFilterDD G(iir), std::runtime_error);
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,140 @@
+#include <digital_filters/filter_bank.hpp>
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <algorithm>
+
+typedef digital_filters::Filter<double,double> FilterDD;
+typedef digital_filters::FilterBank<double,double> FilterBankDD;
+
+
+// Input of the channel c at the time t
+double signal(
+  unsigned int c,
+  double t
+)
+{
+  return std::sin(t + 0.1*c) + 0.5*std::cos((10+c)*t);
+}
+
+
+// Check that a bank behaves as one filter per channel
+template <class DataType>
+void checkBank(
+  const digital_filters::Filter<DataType,DataType>& design,
+  unsigned int channels,
+  bool in_place
+)
+{
+  digital_filters::FilterBank<DataType,DataType> bank(design, channels);
+  std::vector<digital_filters::Filter<DataType,DataType>> filters(channels, design);
+  std::vector<DataType> x(channels), y(channels);
+  for(double t=0; t<5.0; t+=0.01) {
+    for(unsigned int c=0; c<channels; c++)
+      x[c] = signal(c, t);
+    if(in_place) {
+      y = x;
+      bank.filter(y.data(), y.data());
+    }
+    else {
+      bank.filter(x.data(), y.data());
+    }
+    for(unsigned int c=0; c<channels; c++) {
+      ASSERT_NEAR(filters[c].filter(x[c]), y[c], 1e-5) << "channel " << c << " at time t=" << t;
+    }
+  }
+}
+
+
+// Check filtering with different numbers of channels and types
+TEST(TestFilterBank, SameAsFilter) {
+  for(unsigned int channels : {1, 7, 37, 64}) {
+    checkBank(digital_filters::butterworth<double,double>(5, 10., 100.), channels, false);
+    checkBank(digital_filters::butterworth<float,float>(4, 10.f, 100.f), channels, true);
+    checkBank(digital_filters::exponential<double,double>(0.1), channels, false);
+    checkBank(digital_filters::average<float,float>(4), channels, true);
+    checkBank(FilterDD({3.0, -2.0}, {1.7, 0.5,-0.8}), channels, false);
+    checkBank(FilterDD({0.5}, {1.0}), channels, true);
+  }
+}
+
+
+// Check interleaved multi-frame filtering and steady-state initialization
+TEST(TestFilterBank, Frames) {
+  const unsigned int channels = 13;
+  const unsigned int frames = 50;
+  FilterBankDD bank(digital_filters::butterworth<double,double>(3, 10., 100.), channels);
+  std::vector<double> x(channels*frames);
+  for(unsigned int k=0; k<frames; k++)
+    for(unsigned int c=0; c<channels; c++)
+      x[k*channels+c] = c;
+  bank.initSteadyState(x.data());
+  bank.filter(x.data(), x.data(), frames);
+  for(unsigned int k=0; k<frames; k++)
+    for(unsigned int c=0; c<channels; c++)
+      ASSERT_NEAR(x[k*channels+c], c, 1e-9) << "channel " << c << " at frame " << k;
+}
+
+
+// Check replacing the coefficients of a running bank
+TEST(TestFilterBank, SetCoefficients) {
+  const unsigned int channels = 21;
+  const auto before = digital_filters::butterworth<double,double>(3, 10., 100.);
+  const auto after = digital_filters::butterworth<double,double>(3, 25., 100.);
+  FilterBankDD bank(before, channels);
+  std::vector<FilterDD> filters(channels, FilterDD(
+    before.numerator(),
+    before.denominator(),
+    digital_filters::Realization::DirectFormIITransposed
+  ));
+  std::vector<double> x(channels), y(channels);
+  for(double t=0; t<2.0; t+=0.01) {
+    // switch in the middle of the signal
+    if(std::abs(t-1.0) < 1e-9) {
+      bank.setCoefficients(after.numerator(), after.denominator(), x.data());
+      for(auto& F : filters)
+        F.setCoefficients(after.numerator(), after.denominator());
+    }
+    for(unsigned int c=0; c<channels; c++)
+      x[c] = signal(c, t);
+    bank.filter(x.data(), y.data());
+    for(unsigned int c=0; c<channels; c++)
+      ASSERT_NEAR(filters[c].filter(x[c]), y[c], 1e-9) << "channel " << c << " at time t=" << t;
+  }
+  ASSERT_THROW(bank.setCoefficients({1.0}, after.denominator()), std::runtime_error);
+}
+
+
+// Check that float samples are accumulated in double precision
+TEST(TestFilterBank, MixedPrecision) {
+  typedef digital_filters::FilterBank<float,double> FilterBankFD;
+  const unsigned int channels = 37;
+  const auto design = digital_filters::butterworth<double,double>(4, 2., 1000.);
+  FilterBankDD reference(design, channels);
+  FilterBankFD mixed(design.numerator(), design.denominator(), channels);
+  digital_filters::FilterBank<float,float> single(design.as<float,float>(), channels);
+  std::vector<double> xd(channels), yd(channels);
+  std::vector<float> xf(channels), yf(channels), ys(channels);
+  double mixed_error = 0;
+  double single_error = 0;
+  for(double t=0; t<5.0; t+=0.001) {
+    for(unsigned int c=0; c<channels; c++)
+      xd[c] = xf[c] = signal(c, t);
+    reference.filter(xd.data(), yd.data());
+    mixed.filter(xf.data(), yf.data());
+    single.filter(xf.data(), ys.data());
+    for(unsigned int c=0; c<channels; c++) {
+      mixed_error = std::max(mixed_error, std::abs(yf[c] - yd[c]));
+      single_error = std::max(single_error, std::abs(ys[c] - yd[c]));
+    }
+  }
+  // the only errors come from rounding the inputs and the outputs
+  EXPECT_LT(mixed_error, 1e-5);
+  EXPECT_LT(mixed_error, single_error);
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
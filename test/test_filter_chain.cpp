@@ -0,0 +1,104 @@
+#include <digital_filters/filter_chain.hpp>
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+typedef digital_filters::Filter<double,double> FilterDD;
+typedef digital_filters::SosFilter<double,double> SosFilterDD;
+typedef digital_filters::MovingAverage<double,double> MovingAverageDD;
+
+
+// Signal used by the tests
+std::vector<double> testSignal(std::size_t n) {
+  std::vector<double> x(n);
+  for(std::size_t k=0; k<n; k++)
+    x[k] = std::sin(0.05*k) + 0.3*std::cos(1.3*k);
+  return x;
+}
+
+
+// Check that a chain matches its stages applied one after the other
+TEST(TestFilterChain, SameAsStages) {
+  const auto x = testSignal(5000);
+  auto E = digital_filters::exponential<double,double>(0.3);
+  auto B = digital_filters::butterworthSos<double,double>(4, 10., 100.);
+  MovingAverageDD M(8);
+  auto clip = [](double v) { return std::max(-0.8, std::min(0.8, v)); };
+
+  // reference: one full pass per stage
+  std::vector<double> expected(x.size());
+  {
+    auto e = E;
+    auto b = B;
+    auto m = M;
+    e.filter(x.data(), expected.data(), x.size());
+    b.filter(expected.data(), expected.data(), x.size());
+    for(auto& v : expected)
+      v = clip(v);
+    m.filter(expected.data(), expected.data(), x.size());
+  }
+
+  for(std::size_t tile : {1, 7, 256, 10000}) {
+    digital_filters::FilterChain<double> chain(tile);
+    chain.append(E);
+    chain.append(B);
+    chain.appendFunction(clip);
+    chain.append(M);
+    EXPECT_EQ(chain.size(), 4);
+    EXPECT_EQ(chain.tileSize(), tile);
+
+    // blocks of uneven length, the second one in-place
+    std::vector<double> y(x.size());
+    chain.filter(x.data(), y.data(), 1234);
+    std::copy(x.begin() + 1234, x.end(), y.begin() + 1234);
+    chain.filter(y.data() + 1234, y.data() + 1234, x.size() - 1234);
+    for(std::size_t k=0; k<x.size(); k++)
+      ASSERT_NEAR(y[k], expected[k], 1e-12) << "tile " << tile << ", sample " << k;
+  }
+
+  // sample by sample
+  digital_filters::FilterChain<double> chain;
+  chain.append(E);
+  chain.append(B);
+  chain.appendFunction(clip);
+  chain.append(M);
+  for(std::size_t k=0; k<x.size(); k++)
+    ASSERT_NEAR(chain.filter(x[k]), expected[k], 1e-12) << "sample " << k;
+}
+
+
+// Check that stages can be retuned and that copies are independent
+TEST(TestFilterChain, Stages) {
+  const auto x = testSignal(300);
+  digital_filters::FilterChain<double> chain;
+  EXPECT_EQ(chain.tileSize(), 1024);
+  // an empty chain does not change the signal
+  std::vector<double> y(x.size());
+  chain.filter(x.data(), y.data(), x.size());
+  EXPECT_EQ(y, x);
+
+  auto& F = chain.append(digital_filters::butterworth<double,double>(2, 10., 100.));
+  auto copy = chain;
+  const auto design = digital_filters::butterworth<double,double>(2, 20., 100.);
+  F.setCoefficients(design.numerator(), design.denominator());
+
+  auto reference = design;
+  std::vector<double> z(x.size());
+  chain.filter(x.data(), y.data(), x.size());
+  reference.filter(x.data(), z.data(), x.size());
+  EXPECT_EQ(y, z);
+
+  // the copy still uses the initial design
+  reference = digital_filters::butterworth<double,double>(2, 10., 100.);
+  copy.filter(x.data(), y.data(), x.size());
+  reference.filter(x.data(), z.data(), x.size());
+  EXPECT_EQ(y, z);
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
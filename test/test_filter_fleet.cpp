@@ -0,0 +1,108 @@
+#include <digital_filters/filter_fleet.hpp>
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+typedef digital_filters::Filter<double,double> FilterDD;
+
+
+// Designs used by the tests, with different orders
+std::vector<FilterDD> testDesigns() {
+  return {
+    digital_filters::butterworth<double,double>(2, 10., 100.),
+    digital_filters::exponential<double,double>(0.3),
+    digital_filters::butterworth<double,double>(5, 3., 100.),
+    FilterDD({0.5, 0.5}, {1.})
+  };
+}
+
+
+// Check that channels with different designs match separate filters
+TEST(TestFilterFleet, Heterogeneous) {
+  const auto designs = testDesigns();
+  digital_filters::FilterFleet<double,double> fleet;
+  std::vector<std::size_t> ids;
+  for(const auto& design : designs)
+    ids.push_back(fleet.addDesign(design));
+  EXPECT_EQ(fleet.designs(), designs.size());
+
+  const std::size_t channels = 37;
+  std::vector<FilterDD> filters;
+  for(std::size_t c=0; c<channels; c++) {
+    const std::size_t d = (c*7) % designs.size();
+    EXPECT_EQ(fleet.add(ids[d]), c);
+    EXPECT_EQ(fleet.design(c), ids[d]);
+    filters.emplace_back(designs[d].numerator(), designs[d].denominator(), digital_filters::Realization::DirectFormIITransposed);
+  }
+  EXPECT_EQ(fleet.channels(), channels);
+
+  const std::size_t frames = 200;
+  std::vector<double> x(frames*channels), y(x.size());
+  for(std::size_t i=0; i<x.size(); i++)
+    x[i] = std::sin(0.03*i) + 0.2*std::cos(1.1*i);
+  fleet.filter(x.data(), y.data(), frames/2);
+  for(std::size_t k=frames/2; k<frames; k++)
+    fleet.filter(x.data()+k*channels, y.data()+k*channels);
+  for(std::size_t k=0; k<frames; k++)
+    for(std::size_t c=0; c<channels; c++)
+      ASSERT_NEAR(y[k*channels+c], filters[c].filter(x[k*channels+c]), 1e-12) << "k=" << k << ", c=" << c;
+
+  // single channels can be filtered on their own
+  EXPECT_NEAR(fleet.filter(3, 1.), filters[3].filter(1.), 1e-12);
+
+  // steady-state and reset
+  std::vector<double> input(channels, 2.), output(channels);
+  fleet.initSteadyState(input.data());
+  fleet.filter(input.data(), output.data());
+  for(std::size_t c=0; c<channels; c++) {
+    const auto& b = fleet.numerator(fleet.design(c));
+    const auto& a = fleet.denominator(fleet.design(c));
+    const double gain = std::accumulate(b.begin(), b.end(), 0.) / std::accumulate(a.begin(), a.end(), 0.);
+    EXPECT_NEAR(output[c], 2.*gain, 1e-9);
+  }
+  fleet.reset();
+  std::vector<double> zeros(channels, 0.);
+  fleet.filter(zeros.data(), output.data());
+  EXPECT_EQ(output, zeros);
+}
+
+
+// Check that designs are interned and validated
+TEST(TestFilterFleet, Designs) {
+  digital_filters::FilterFleet<float,double> fleet;
+  const auto d0 = fleet.addDesign({1., 2., 1.}, {4., -1., 0.5});
+  const auto d1 = fleet.addDesign({2., 4., 2.}, {8., -2., 1.});
+  const auto d2 = fleet.addDesign({1.}, {1., -0.5});
+  EXPECT_EQ(d0, d1);
+  EXPECT_NE(d0, d2);
+  EXPECT_EQ(fleet.designs(), 2);
+  EXPECT_EQ(fleet.numerator(d0), std::vector<double>({0.25, 0.5, 0.25}));
+  EXPECT_EQ(fleet.denominator(d0), std::vector<double>({1., -0.25, 0.125}));
+
+  EXPECT_THROW(fleet.addDesign({}, {1.}), std::runtime_error);
+  EXPECT_THROW(fleet.addDesign({1.}, {0., 1.}), std::runtime_error);
+  EXPECT_THROW(fleet.add(2), std::runtime_error);
+
+  // reserved channels are added without allocating
+  fleet.reserve(1000, 1500);
+  const std::size_t usage = fleet.memoryUsage();
+  for(int c=0; c<1000; c++)
+    fleet.add(c % 2 ? d0 : d2);
+  EXPECT_EQ(fleet.memoryUsage(), usage);
+  // a few bytes per channel, besides its state
+  EXPECT_LE(fleet.memoryUsage(), 1000*8 + 1500*sizeof(double));
+
+  // the steady-state is not defined with a pole in z=1
+  fleet.add(fleet.addDesign({1.}, {1., -1.}));
+  std::vector<float> input(fleet.channels(), 1.f);
+  EXPECT_THROW(fleet.initSteadyState(input.data()), std::runtime_error);
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
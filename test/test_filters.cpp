@@ -1,6 +1,9 @@
 #include <digital_filters/filters.hpp>
 #include <gtest/gtest.h>
 #include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
 
 typedef digital_filters::Filter<double,double> FilterDD;
 typedef digital_filters::Filter<float,float> FilterFF;
@@ -53,6 +56,62 @@ TEST(TestFilters, FilterSequence) {
 }
 
 
+// Make sure that sequences and single samples use the same initial conditions
+TEST(TestFilters, FilterSequenceInitialConditions) {
+  FilterDD G({3.0, -2.0, 1.0, -0.05}, {1.7, 0.5,-0.8});
+  std::vector<double> x0 = {-1.0, 0.5, 2.0};
+  std::vector<double> y0 = {0.3, -0.7};
+  G.initInput(x0);
+  G.initOutput(y0);
+
+  std::vector<double> xseq;
+  for(double t=0; t<1.0; t+=0.01)
+    xseq.push_back(std::sin(t) + 0.5*std::cos(10*t));
+  auto yseq = G.filter(xseq, x0, y0);
+
+  for(unsigned int i=0; i<xseq.size(); i++) {
+    ASSERT_FLOAT_EQ(G.filter(xseq.at(i)), yseq.at(i)) << "at step i=" << i;
+  }
+}
+
+
+// Make sure that block filtering matches sample-by-sample filtering
+TEST(TestFilters, FilterBlocks) {
+  for(auto realization : {
+    digital_filters::Realization::DirectFormI,
+    digital_filters::Realization::DirectFormIITransposed
+  })
+  {
+    FilterDD G1({3.0, -2.0, 1.0, -0.05}, {1.7, 0.5,-0.8}, realization);
+    FilterDD G2 = G1;
+    FilterDD G3 = G1;
+    std::vector<double> x;
+    for(double t=0; t<10.0; t+=0.01)
+      x.push_back(std::sin(t) + 0.5*std::cos(10*t));
+
+    // filter in blocks of different sizes, the second time in-place
+    std::vector<double> y(x.size());
+    std::vector<double> z(x);
+    for(std::size_t k=0, len=1; k<x.size(); k+=len, len=len%11+1) {
+      len = std::min(len, x.size()-k);
+      G1.filter(&x[k], &y[k], len);
+      G2.filter(&z[k], &z[k], len);
+    }
+
+    for(unsigned int i=0; i<x.size(); i++) {
+      double yi = G3.filter(x[i]);
+      ASSERT_FLOAT_EQ(yi, y[i]) << "at step i=" << i;
+      ASSERT_FLOAT_EQ(yi, z[i]) << "at step i=" << i;
+    }
+
+    // the state should be the same after the blocks
+    double y3 = G3.filter(1.0);
+    ASSERT_FLOAT_EQ(G1.filter(1.0), y3);
+    ASSERT_FLOAT_EQ(G2.filter(1.0), y3);
+  }
+}
+
+
 // Check that filtering with H=G*F is the same as filtering with F and then G
 TEST(TestFilters, ConcatenateFilters) {
   // Create two filters
@@ -74,6 +133,189 @@ TEST(TestFilters, ConcatenateFilters) {
 }
 
 
+// Check that all realizations produce the same output
+TEST(TestFilters, Realizations) {
+  // Create the same filter twice, using two different realizations
+  FilterDD G1({3.0, -2.0, 1.0, -0.05}, {1.7, 0.5,-0.8});
+  FilterDD G2(
+    {3.0, -2.0, 1.0, -0.05},
+    {1.7, 0.5,-0.8},
+    digital_filters::Realization::DirectFormIITransposed
+  );
+  ASSERT_EQ(G2.realization(), digital_filters::Realization::DirectFormIITransposed);
+
+  // init both filters in the same way
+  for(auto* G : {&G1, &G2}) {
+    G->initInput(std::vector<double>{-1.0, 0.5, 2.0});
+    G->initOutput(std::vector<double>{0.3, -0.7});
+  }
+
+  // make sure that we get the same outputs (up to a small tolerance)
+  for(double t=0; t<10.0; t+=0.01) {
+    double x = std::sin(t) + 0.5*std::cos(10*t);
+    ASSERT_FLOAT_EQ(G1.filter(x), G2.filter(x)) << "at time t=" << t;
+  }
+}
+
+
+// Make sure that the state is preserved while changing types
+TEST(TestFilters, TypeChangeWithState) {
+  for(auto realization : {
+    digital_filters::Realization::DirectFormI,
+    digital_filters::Realization::DirectFormIITransposed
+  })
+  {
+    FilterDD filterdd({1.0, 0.5, 0.2}, {1.0, 0.25, -0.1}, realization);
+    filterdd.initInput(std::vector<double>{1.0, 2.0});
+    filterdd.initOutput(std::vector<double>{-1.0, 3.0});
+    // filter a few samples before the conversion
+    for(unsigned int i=0; i<5; i++)
+      filterdd.filter(0.1*i);
+    FilterFF filterff = filterdd.as<float,float>();
+    ASSERT_EQ(filterff.realization(), realization);
+    for(unsigned int i=0; i<20; i++) {
+      float yf = filterff.filter(1.0f);
+      double yd = filterdd.filter(1.0);
+      ASSERT_NEAR(yf, yd, 1e-5) << "at step i=" << i;
+    }
+  }
+}
+
+
+// Check that float samples are accumulated using the coefficients type
+TEST(TestFilters, MixedPrecision) {
+  typedef digital_filters::Filter<float,double> FilterFD;
+  static_assert(std::is_same<FilterFD::Accumulator,double>::value, "unexpected accumulator");
+  const FilterDD design = digital_filters::butterworth<double,double>(2, 5., 1000.);
+  for(auto realization : {
+    digital_filters::Realization::DirectFormI,
+    digital_filters::Realization::DirectFormIITransposed
+  })
+  {
+    FilterDD reference(design.numerator(), design.denominator(), realization);
+    FilterFD mixed(design.numerator(), design.denominator(), realization);
+    FilterFF single = FilterDD(design.numerator(), design.denominator(), realization).as<float,float>();
+    std::vector<float> x(5000), y(x.size()), ys(x.size());
+    for(unsigned int k=0; k<x.size(); k++)
+      x[k] = std::sin(0.01*k) + 0.5*std::cos(0.1*k);
+    mixed.filter(x.data(), y.data(), x.size());
+    single.filter(x.data(), ys.data(), x.size());
+    double mixed_error = 0;
+    double single_error = 0;
+    for(unsigned int k=0; k<x.size(); k++) {
+      const double yk = reference.filter(x[k]);
+      mixed_error = std::max(mixed_error, std::abs(y[k] - yk));
+      single_error = std::max(single_error, std::abs(ys[k] - yk));
+    }
+    // the Direct Form I still rounds the past outputs to float
+    EXPECT_LT(mixed_error, 1e-4);
+    EXPECT_LT(mixed_error, single_error);
+  }
+}
+
+
+// Check replacing the coefficients of a running filter
+TEST(TestFilters, SetCoefficients) {
+  // The Direct Form I keeps the past samples: after the switch, it behaves
+  // as a new filter initialized with the same history
+  FilterDD F({1.0, 0.5, 0.2}, {1.0, 0.25, -0.1});
+  std::vector<double> x_hist, y_hist;
+  for(unsigned int i=0; i<10; i++) {
+    const double x = std::sin(0.3*i);
+    x_hist.push_back(x);
+    y_hist.push_back(F.filter(x));
+  }
+  const std::vector<double> b{0.3, -0.2, 0.1};
+  const std::vector<double> a{2.0, -0.4, 0.2};
+  F.setCoefficients(b, a);
+  ASSERT_DOUBLE_EQ(F.numerator()[0], 0.15);
+  ASSERT_DOUBLE_EQ(F.denominator()[0], 1.0);
+  FilterDD G(b, a);
+  G.initInput(std::vector<double>(x_hist.end()-2, x_hist.end()));
+  G.initOutput(std::vector<double>(y_hist.end()-2, y_hist.end()));
+  for(unsigned int i=0; i<20; i++) {
+    const double x = std::cos(0.2*i);
+    ASSERT_DOUBLE_EQ(F.filter(x), G.filter(x)) << "at step i=" << i;
+  }
+
+  // The transposed state is shifted: a filter at rest stays at rest
+  FilterDD T({0.2, 0.3, 0.1}, {1.0, -0.5, 0.2}, digital_filters::Realization::DirectFormIITransposed);
+  T.initSteadyState(2.0);
+  T.setCoefficients({0.1, 0.2, 0.1}, {1.0, -0.9, 0.3});
+  for(unsigned int i=0; i<20; i++)
+    ASSERT_NEAR(T.filter(2.0), 2.0, 1e-12) << "at step i=" << i;
+
+  // sizes must match
+  ASSERT_THROW(F.setCoefficients({1.0}, a), std::runtime_error);
+  ASSERT_THROW(F.setCoefficients(b, {0.0, 1.0, 1.0}), std::runtime_error);
+}
+
+
+// Check steady-state initialization of the streaming filter
+TEST(TestFilters, SteadyState) {
+  for(auto realization : {
+    digital_filters::Realization::DirectFormI,
+    digital_filters::Realization::DirectFormIITransposed
+  })
+  {
+    FilterDD G({0.2, 0.3, 0.1}, {1.0, -0.5, 0.2}, realization);
+    const double gain = 0.6 / 0.7;
+    G.initSteadyState(2.0);
+    for(unsigned int i=0; i<20; i++)
+      ASSERT_NEAR(G.filter(2.0), 2.0*gain, 1e-12) << "at step i=" << i;
+  }
+  // integrators have no steady state
+  FilterDD I({1.0}, {1.0, -1.0});
+  ASSERT_THROW(I.initSteadyState(1.0), std::runtime_error);
+}
+
+
+// Check bi-directional filtering against an explicit implementation
+TEST(TestFilters, Filter2) {
+  FilterDD F = digital_filters::butterworth<double,double>(3, 5., 100.);
+  std::vector<double> x;
+  for(double t=0; t<5.0; t+=0.01)
+    x.push_back(std::sin(t) + 0.5*std::cos(10*t) + 1.0);
+
+  for(std::size_t padding : {0, 1, 12, 100}) {
+    // extend the signal with odd reflections
+    std::vector<double> ext;
+    for(std::size_t i=padding; i>0; i--)
+      ext.push_back(2*x.front() - x[i]);
+    ext.insert(ext.end(), x.begin(), x.end());
+    for(std::size_t i=0; i<padding; i++)
+      ext.push_back(2*x.back() - x[x.size()-2-i]);
+    // filter forward and backward, starting from the steady state
+    FilterDD G(F.numerator(), F.denominator());
+    G.initSteadyState(ext.front());
+    for(auto& v : ext)
+      v = G.filter(v);
+    std::reverse(ext.begin(), ext.end());
+    G.initSteadyState(ext.front());
+    for(auto& v : ext)
+      v = G.filter(v);
+    std::reverse(ext.begin(), ext.end());
+
+    auto y = F.filter2(x, padding);
+    std::vector<double> z = x;
+    F.filter2(z.data(), z.data(), z.size(), padding);
+    ASSERT_EQ(y.size(), x.size());
+    for(unsigned int i=0; i<x.size(); i++) {
+      ASSERT_NEAR(ext[i+padding], y[i], 1e-12) << "at step i=" << i << " with padding " << padding;
+      ASSERT_EQ(y[i], z[i]) << "at step i=" << i << " with padding " << padding;
+    }
+  }
+
+  // constant signals produce no transients
+  auto y = F.filter2(std::vector<double>(100, 3.0));
+  for(unsigned int i=0; i<y.size(); i++)
+    ASSERT_NEAR(y[i], 3.0, 1e-12) << "at step i=" << i;
+
+  ASSERT_THROW(F.filter2(x, x.size()), std::runtime_error);
+  ASSERT_TRUE(F.filter2(std::vector<double>()).empty());
+}
+
+
 TEST(TestFilters, ConstructFilters) {
   FilterDD butter = digital_filters::butterworth<double,double>(4, 20, 100);
   FilterDD avg1 = digital_filters::average<double,double>(5);
@@ -0,0 +1,112 @@
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+
+typedef digital_filters::Filter<double,double> FilterDD;
+
+
+// Filters a step at compile time, returning the last output
+template <class FixedFilterType>
+constexpr double stepResponse(
+  FixedFilterType filter,
+  unsigned int samples
+)
+{
+  double y = 0;
+  for(unsigned int i=0; i<samples; i++)
+    y = filter.filter(1.0);
+  return y;
+}
+
+
+// Check that a fixed filter behaves as its dynamic counterpart
+template <class FixedFilterType>
+void checkSameOutput(
+  FixedFilterType fixed,
+  FilterDD dynamic
+)
+{
+  for(double t=0; t<10.0; t+=0.01) {
+    double x = std::sin(t) + 0.5*std::cos(10*t);
+    ASSERT_NEAR(fixed.filter(x), dynamic.filter(x), 1e-9) << "at time t=" << t;
+  }
+}
+
+
+// Make sure that designs can be evaluated at compile time
+TEST(TestFixedFilter, CompileTimeDesign) {
+  constexpr auto butter = digital_filters::butterworth<7,double,double>(40., 100.);
+  static_assert(butter.denominator().size() == 8, "wrong denominator size");
+  static_assert(butter.numerator().size() == 8, "wrong numerator size");
+
+  // these are the same coefficients used in test_butterworth.cpp
+  std::vector<double> a = { 1.0, 4.182330089320615, 7.871719202212808, 8.530942129298456, 5.7099448078894826, 2.3492472280524366, 0.5482647747786813, 0.05584467100692739 };
+  std::vector<double> b = { 0.2363147883012453, 1.6542035181087171, 4.962610554326151, 8.271017590543586, 8.271017590543586, 4.962610554326151, 1.6542035181087171, 0.2363147883012453 };
+  for(unsigned int i=0; i<a.size(); i++) {
+    ASSERT_NEAR(a.at(i), butter.denominator().at(i), 1e-12) << "Mismatching a[" << i << "]";
+    ASSERT_NEAR(b.at(i), butter.numerator().at(i), 1e-12) << "Mismatching b[" << i << "]";
+  }
+
+  // low-pass filters should converge to the input after a step
+  constexpr double y = stepResponse(digital_filters::butterworth<3,double,double>(5., 100.), 200);
+  static_assert(y > 0.999 && y < 1.001, "wrong step response");
+  constexpr double z = stepResponse(digital_filters::fixedExponential<double,double>(0.01, 0.05), 200);
+  static_assert(z > 0.999 && z < 1.001, "wrong step response");
+}
+
+
+// Make sure that fixed filters match dynamic ones
+TEST(TestFixedFilter, SameAsFilter) {
+  checkSameOutput(
+    digital_filters::butterworth<4,double,double>(20., 100.),
+    digital_filters::butterworth<double,double>(4, 20., 100.)
+  );
+  checkSameOutput(
+    digital_filters::butterworth<5,double,double>(3., 100.),
+    digital_filters::butterworth<double,double>(5, 3., 100.)
+  );
+  checkSameOutput(
+    digital_filters::average<5,double,double>(),
+    digital_filters::average<double,double>(5)
+  );
+  checkSameOutput(
+    digital_filters::average<5,double,double>(3.5),
+    digital_filters::average<double,double>(5, 3.5)
+  );
+  checkSameOutput(
+    digital_filters::fixedExponential<double,double>(0.8),
+    digital_filters::exponential<double,double>(0.8)
+  );
+  checkSameOutput(
+    digital_filters::fixedExponential<double,double>(0.01, 0.05),
+    digital_filters::exponential<double,double>(0.01, 0.05)
+  );
+  // a zero time constant gives a pass-through filter
+  checkSameOutput(
+    digital_filters::fixedExponential<double,double>(0.01, 0.),
+    digital_filters::exponential<double,double>(0.01, 0.)
+  );
+}
+
+
+// Make sure that initial conditions and type changes work as in Filter
+TEST(TestFixedFilter, InitAndTypeChange) {
+  digital_filters::FixedFilter<double,double,2,3> fixed({1.0, 0.5}, {1.0, 0.25, -0.1});
+  FilterDD dynamic({1.0, 0.5}, {1.0, 0.25, -0.1});
+  fixed.initInput({-1.0});
+  fixed.initOutput({-2.0, 3.0});
+  dynamic.initInput(std::vector<double>{-1.0});
+  dynamic.initOutput(std::vector<double>{-2.0, 3.0});
+  auto fixedf = fixed.as<float,float>();
+  for(unsigned int i=0; i<20; i++) {
+    double yd = dynamic.filter(5.0);
+    ASSERT_FLOAT_EQ(fixed.filter(5.0), yd) << "at step i=" << i;
+    ASSERT_NEAR(fixedf.filter(5.0f), yd, 1e-5) << "at step i=" << i;
+  }
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,141 @@
+#include <digital_filters/fixed_point_filter.hpp>
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+using digital_filters::Q15;
+using digital_filters::Q31;
+typedef digital_filters::SosFilter<double,double> SosFilterDD;
+
+
+// Input of the channel c at the time t, within [-0.75,0.75]
+double signal(
+  unsigned int c,
+  double t
+)
+{
+  return 0.5*std::sin(t + 0.1*c) + 0.25*std::cos((10+c)*t);
+}
+
+
+// Check conversions and saturating arithmetic
+TEST(TestFixedPoint, Arithmetic) {
+  EXPECT_EQ(Q15(0.5).raw(), 16384);
+  EXPECT_EQ(Q15(-1.0).raw(), -32768);
+  EXPECT_EQ(Q15(1.0).raw(), 32767);
+  EXPECT_EQ(Q15(-3.0), Q15::min());
+  EXPECT_EQ(Q31(0.25).raw(), 1 << 29);
+  EXPECT_DOUBLE_EQ(Q15::fromRaw(-8192).toDouble(), -0.25);
+
+  // sums and differences saturate instead of wrapping around
+  EXPECT_EQ(Q15(0.75) + Q15(0.75), Q15::max());
+  EXPECT_EQ(Q15(-0.75) - Q15(0.75), Q15::min());
+  EXPECT_EQ(-Q15::min(), Q15::max());
+  EXPECT_EQ(Q31(0.75) + Q31(0.5), Q31::max());
+
+  // products are rounded
+  EXPECT_EQ((Q15(0.5) * Q15(0.5)).raw(), 8192);
+  EXPECT_EQ((Q15::fromRaw(1) * Q15(0.5)).raw(), 1);
+  EXPECT_EQ(Q15::min() * Q15::min(), Q15::max());
+  EXPECT_NEAR((Q31(0.3) * Q31(-0.7)).toDouble(), -0.21, 1e-9);
+}
+
+
+// Compare a quantized filter with its floating point reference
+template <class Format>
+double quantizationError(
+  const SosFilterDD& design,
+  unsigned int channels
+)
+{
+  digital_filters::QuantizationReport report;
+  auto quantized = digital_filters::quantize<Format>(design, channels, &report);
+  EXPECT_EQ(report.shifts.size(), design.sections().size());
+  EXPECT_LT(report.gain_error, 1e-2);
+  std::vector<SosFilterDD> references(channels, design);
+  std::vector<Format> x(channels), y(channels);
+  double error = 0;
+  for(double t=0; t<10.0; t+=0.01) {
+    for(unsigned int c=0; c<channels; c++)
+      x[c] = Format(signal(c, t));
+    quantized.filter(x.data(), y.data());
+    for(unsigned int c=0; c<channels; c++)
+      error = std::max(error, std::abs(y[c].toDouble() - references[c].filter(x[c].toDouble())));
+  }
+  return error;
+}
+
+
+// Check quantized Butterworth filters
+TEST(TestFixedPoint, Butterworth) {
+  const auto design = digital_filters::butterworthSos<double,double>(4, 10., 100.);
+  for(unsigned int channels : {1, 19, 64}) {
+    EXPECT_LT(quantizationError<Q15>(design, channels), 2e-3) << channels << " channels";
+    EXPECT_LT(quantizationError<Q31>(design, channels), 1e-7) << channels << " channels";
+  }
+}
+
+
+// Check that channels are independent, whether they are packed or not
+TEST(TestFixedPoint, Channels) {
+  const unsigned int channels = 37;
+  const unsigned int frames = 200;
+  const auto design = digital_filters::butterworthSos<double,double>(3, 20., 100.);
+  auto bank = digital_filters::quantize<Q15>(design, channels);
+  std::vector<Q15> x(channels*frames);
+  for(unsigned int k=0; k<frames; k++)
+    for(unsigned int c=0; c<channels; c++)
+      x[k*channels+c] = Q15(signal(c, 0.01*k));
+  std::vector<Q15> y(x.size());
+  bank.filter(x.data(), y.data(), frames);
+  for(unsigned int c=0; c<channels; c++) {
+    auto single = digital_filters::quantize<Q15>(design);
+    for(unsigned int k=0; k<frames; k++) {
+      Q15 yk;
+      single.filter(&x[k*channels+c], &yk);
+      ASSERT_EQ(yk, y[k*channels+c]) << "channel " << c << " at frame " << k;
+    }
+  }
+
+  // in-place filtering after a reset gives the same result
+  bank.reset();
+  bank.filter(x.data(), x.data(), frames);
+  EXPECT_TRUE(x == y);
+}
+
+
+// Check saturation and quantization of transfer functions
+TEST(TestFixedPoint, Saturation) {
+  // a gain of 1.5 needs a shift of one bit and saturates large inputs
+  digital_filters::QuantizationReport report;
+  auto gain = digital_filters::quantize<Q15>(digital_filters::Filter<double,double>({1.5}, {1.0}), 1, &report);
+  ASSERT_EQ(report.shifts.size(), 1);
+  EXPECT_EQ(report.shifts[0], 1);
+  EXPECT_EQ(report.coefficient_error, 0);
+  EXPECT_EQ(report.gain_error, 0);
+  Q15 x(0.5), y;
+  gain.filter(&x, &y);
+  EXPECT_EQ(y, Q15(0.75));
+  x = Q15(0.9);
+  gain.filter(&x, &y);
+  EXPECT_EQ(y, Q15::max());
+  x = Q15(-0.9);
+  gain.filter(&x, &y);
+  EXPECT_EQ(y, Q15::min());
+
+  // the report includes the error on the coefficients
+  digital_filters::quantize<Q15>(digital_filters::exponential<double,double>(0.1), 1, &report);
+  EXPECT_GT(report.coefficient_error, 0);
+  EXPECT_LE(report.coefficient_error, std::ldexp(1.0, -16));
+
+  // coefficients that cannot be represented are rejected
+  EXPECT_THROW(digital_filters::quantize<Q15>(digital_filters::Filter<double,double>({1e6}, {1.0})), std::runtime_error);
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
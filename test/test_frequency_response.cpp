@@ -0,0 +1,135 @@
+#include <digital_filters/frequency_response.hpp>
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+typedef digital_filters::FrequencyAnalyzer<double> AnalyzerD;
+
+
+// Direct evaluation of a transfer function, used as reference
+std::complex<double> transferFunction(
+  const std::vector<double>& b,
+  const std::vector<double>& a,
+  double omega
+)
+{
+  std::complex<double> num = 0, den = 0;
+  for(std::size_t k=0; k<b.size(); k++)
+    num += b[k] * std::polar(1.0, -omega*k);
+  for(std::size_t k=0; k<a.size(); k++)
+    den += a[k] * std::polar(1.0, -omega*k);
+  return num / den;
+}
+
+
+// Check the responses against the direct evaluation
+TEST(TestFrequencyResponse, Response) {
+  const double fs = 100.;
+  // both Horner's method and FFTs are used for 64 points
+  const auto F = digital_filters::butterworth<double,double>(5, 10., fs);
+  const auto G = F * digital_filters::butterworth<double,double>(12, 20., fs);
+  for(std::size_t points : {64, 100}) {
+    AnalyzerD analyzer(points, fs);
+    EXPECT_EQ(analyzer.fftThreshold(), points == 64 ? 14 : 0);
+    const auto HG = analyzer.evaluate(G);
+    for(std::size_t i=0; i<points; i++) {
+      const double omega = 2*M_PI * analyzer.frequencies()[i] / fs;
+      const auto expected = transferFunction(G.numerator(), G.denominator(), omega);
+      EXPECT_NEAR(std::abs(HG.response[i] - expected), 0., 1e-10) << points << " points, frequency " << i;
+    }
+    ASSERT_EQ(analyzer.frequencies().size(), points);
+    const auto H = analyzer.evaluate(F);
+    ASSERT_EQ(H.response.size(), points);
+    for(std::size_t i=0; i<points; i++) {
+      const double omega = 2*M_PI * analyzer.frequencies()[i] / fs;
+      const auto expected = transferFunction(F.numerator(), F.denominator(), omega);
+      EXPECT_NEAR(std::abs(H.response[i] - expected), 0., 1e-12) << points << " points, frequency " << i;
+    }
+  }
+
+  // the magnitude at the cutoff frequency is 1/sqrt(2)
+  AnalyzerD analyzer(std::vector<double>{0., 10., 40.}, fs);
+  const auto m = analyzer.evaluate(F).magnitude();
+  EXPECT_NEAR(m[0], 1., 1e-12);
+  EXPECT_NEAR(m[1], 1./std::sqrt(2.), 1e-12);
+  EXPECT_LT(m[2], 1e-3);
+
+  EXPECT_THROW(AnalyzerD(0, fs), std::runtime_error);
+  EXPECT_THROW(AnalyzerD(16, 0.), std::runtime_error);
+}
+
+
+// Check the group delay against known values and the phase
+TEST(TestFrequencyResponse, GroupDelay) {
+  // symmetric FIR filters have a constant delay, also when they are longer
+  // than the transform
+  const auto A = digital_filters::average<double,double>(41);
+  for(std::size_t points : {16, 50}) {
+    const auto H = AnalyzerD(points, 1.).evaluate(A);
+    for(std::size_t i=0; i<points; i++) {
+      // the delay is not defined at the zeros of the average
+      if(std::abs(H.response[i]) > 1e-6) {
+        EXPECT_NEAR(H.group_delay[i], 20., 1e-9) << points << " points, frequency " << i;
+      }
+    }
+  }
+
+  // the group delay is the derivative of the phase
+  const auto F = digital_filters::butterworth<double,double>(4, 10., 100.);
+  AnalyzerD analyzer(4096, 100.);
+  const auto H = analyzer.evaluate(F);
+  const auto phase = H.phase();
+  const double step = 2*M_PI * (analyzer.frequencies()[1] - analyzer.frequencies()[0]) / 100.;
+  for(std::size_t i=1; i+1<phase.size(); i++) {
+    // skip the stop-band, where the phase is dominated by rounding errors
+    if(std::abs(H.response[i]) < 1e-4)
+      continue;
+    const double derivative = -(phase[i+1] - phase[i-1]) / (2*step);
+    EXPECT_NEAR(H.group_delay[i], derivative, 1e-3 * std::max(1., std::abs(derivative))) << "frequency " << i;
+  }
+}
+
+
+// Check that SOS filters and expanded polynomials give the same result
+TEST(TestFrequencyResponse, Sos) {
+  const auto S = digital_filters::butterworthSos<double,double>(6, 5., 100.);
+  for(std::size_t points : {256, 300}) {
+    AnalyzerD analyzer(points, 100.);
+    const auto Hs = analyzer.evaluate(S);
+    const auto Hp = analyzer.evaluate(S.numerator(), S.denominator());
+    for(std::size_t i=0; i<points; i++) {
+      EXPECT_NEAR(std::abs(Hs.response[i] - Hp.response[i]), 0., 1e-9) << "frequency " << i;
+      // close to the multiple zero at the Nyquist frequency, the expanded
+      // numerator is not accurate enough to evaluate the group delay
+      if(std::abs(Hs.response[i]) > 1e-4) {
+        EXPECT_NEAR(Hs.group_delay[i], Hp.group_delay[i], 1e-6) << "frequency " << i;
+      }
+    }
+  }
+}
+
+
+// Check the evaluation of many designs in parallel
+TEST(TestFrequencyResponse, Batch) {
+  std::vector<digital_filters::Filter<double,double>> designs;
+  for(int i=1; i<=40; i++)
+    designs.push_back(digital_filters::butterworth<double,double>(1 + i % 6, 0.5*i, 100.));
+  AnalyzerD analyzer(128, 100.);
+  digital_filters::ThreadPool pool(3);
+  const auto responses = analyzer.evaluate(designs, pool);
+  ASSERT_EQ(responses.size(), designs.size());
+  for(std::size_t d=0; d<designs.size(); d++) {
+    const auto expected = analyzer.evaluate(designs[d]);
+    EXPECT_EQ(responses[d].response, expected.response) << "design " << d;
+    EXPECT_EQ(responses[d].group_delay, expected.group_delay) << "design " << d;
+  }
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
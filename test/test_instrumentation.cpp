@@ -0,0 +1,113 @@
+#ifndef DIGITAL_FILTERS_INSTRUMENTATION
+#define DIGITAL_FILTERS_INSTRUMENTATION
+#endif
+#include <digital_filters/filters.hpp>
+#include <digital_filters/batch_filter.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+
+// Check that samples, blocks and their latencies are counted
+TEST(TestInstrumentation, Counters) {
+  ASSERT_TRUE(digital_filters::instrumentationEnabled());
+  auto F = digital_filters::butterworth<double,double>(4, 10., 100.);
+  auto probe = digital_filters::ProbeRegistry::global().probe("lowpass");
+  EXPECT_EQ(probe, digital_filters::ProbeRegistry::global().probe("lowpass"));
+  F.setProbe(probe);
+
+  std::vector<double> x(1000, 1.);
+  for(int k=0; k<10; k++)
+    F.filter(x[k]);
+  F.filter(x.data(), x.data(), x.size());
+  F.filter2(x.data(), x.data(), x.size(), 10);
+  // copies report to the same probe
+  auto G = F;
+  G.filter(x.data(), x.data(), 500);
+  // filters without probes are not counted
+  auto H = F.as<double,double>();
+  H.filter(x.data(), x.data(), x.size());
+
+  const auto s = probe->snapshot();
+  EXPECT_EQ(s.name, "lowpass");
+  EXPECT_EQ(s.samples, 10 + 1000 + 1000 + 500);
+  EXPECT_EQ(s.blocks, 3);
+  EXPECT_EQ(std::accumulate(s.latency.begin(), s.latency.end(), std::uint64_t(0)), 3);
+  EXPECT_FALSE(s.diverged());
+  EXPECT_EQ(s.denormals, 0);
+
+  probe->reset();
+  EXPECT_EQ(probe->snapshot().samples, 0);
+}
+
+
+// Check that invalid outputs are flagged
+TEST(TestInstrumentation, InvalidOutputs) {
+  auto probe = digital_filters::ProbeRegistry::global().probe("unstable");
+  probe->reset();
+
+  // unstable filter: the output grows until it becomes infinite
+  digital_filters::Filter<double,double> F({1.}, {1., -2.});
+  F.setProbe(probe);
+  std::vector<double> x(2000, 1.);
+  F.filter(x.data(), x.data(), x.size());
+  auto s = probe->snapshot();
+  EXPECT_TRUE(s.diverged());
+  EXPECT_GT(s.infinities, 0);
+
+  // a NaN input propagates to the outputs
+  F.initInput(0.);
+  F.initOutput(0.);
+  F.filter(std::numeric_limits<double>::quiet_NaN());
+  EXPECT_EQ(probe->snapshot().nans, 1);
+
+  // a decaying filter reaches denormal values
+  digital_filters::Filter<float,float> G({1.f}, {1.f, -0.5f});
+  G.setProbe(probe);
+  probe->reset();
+  G.filter(1.f);
+  for(int k=0; k<200; k++)
+    G.filter(0.f);
+  s = probe->snapshot();
+  EXPECT_FALSE(s.diverged());
+  EXPECT_GT(s.denormals, 0);
+}
+
+
+// Check that batch workers report to the probe of the design
+TEST(TestInstrumentation, Batch) {
+  auto F = digital_filters::butterworth<double,double>(2, 5., 100.);
+  auto probe = digital_filters::ProbeRegistry::global().probe("batch");
+  probe->reset();
+  F.setProbe(probe);
+  digital_filters::BatchFilter<double,double> B(F, 3);
+
+  std::vector<std::vector<double>> signals(7, std::vector<double>(100, 1.));
+  B.filter(signals);
+  B.filter2(signals, 5);
+  auto s = probe->snapshot();
+  EXPECT_EQ(s.samples, 1400);
+  EXPECT_EQ(s.blocks, 14);
+
+  std::vector<double> x(20000, 1.), x0(2, 0.), y0(2, 0.);
+  B.filter(x, x0, y0);
+  s = probe->snapshot();
+  EXPECT_EQ(s.samples, 21400);
+  EXPECT_EQ(s.blocks, 15);
+
+  // all probes can be scraped at once, sorted by name
+  digital_filters::ProbeRegistry::global().probe("zzz");
+  const auto all = digital_filters::ProbeRegistry::global().snapshot();
+  ASSERT_GE(all.size(), 2);
+  EXPECT_EQ(all.front().name, "batch");
+  EXPECT_EQ(all.back().name, "zzz");
+  EXPECT_EQ(all.front().samples, 21400);
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
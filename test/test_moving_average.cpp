@@ -0,0 +1,164 @@
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+typedef digital_filters::Filter<double,double> FilterDD;
+typedef digital_filters::MovingAverage<double,double> MovingAverageDD;
+typedef digital_filters::MovingAverageBank<double,double> MovingAverageBankDD;
+using digital_filters::Summation;
+
+
+// Signal used in most tests
+double signal(
+  double t
+)
+{
+  return std::sin(t) + 0.5*std::cos(10*t);
+}
+
+
+// Check that all summation strategies match the equivalent filter
+TEST(TestMovingAverage, MatchesAverage) {
+  for(auto summation : {Summation::Running, Summation::Compensated, Summation::Periodic}) {
+    FilterDD F = digital_filters::average<double,double>(7, 2.0);
+    MovingAverageDD M = digital_filters::movingAverage<double,double>(7, 2.0, summation);
+    ASSERT_EQ(M.windowSize(), 7);
+    ASSERT_EQ(M.numerator(), std::vector<double>(7, 2.0));
+    ASSERT_EQ(M.denominator(), std::vector<double>{7.0});
+    F.initInput(1.0);
+    M.initInput(1.0);
+    for(double t=0; t<10.0; t+=0.01) {
+      ASSERT_NEAR(F.filter(signal(t)), M.filter(signal(t)), 1e-12) << "at time t=" << t;
+    }
+  }
+}
+
+
+// Check initial conditions and whole-sequence filtering
+TEST(TestMovingAverage, Sequences) {
+  FilterDD F = digital_filters::average<double,double>(5);
+  MovingAverageDD M(5);
+  std::vector<double> x, x0{1., 2., 3., 4.};
+  for(double t=0; t<5.0; t+=0.01)
+    x.push_back(signal(t));
+
+  auto y = F.filter(x, x0, {});
+  auto z = M.filter(x, x0, {});
+  ASSERT_EQ(y.size(), z.size());
+  for(unsigned int i=0; i<y.size(); i++)
+    ASSERT_NEAR(y[i], z[i], 1e-12) << "at sample " << i;
+
+  y = F.filter2(x);
+  z = M.filter2(x);
+  for(unsigned int i=0; i<y.size(); i++)
+    ASSERT_NEAR(y[i], z[i], 1e-12) << "at sample " << i;
+
+  // vector initialization of the streaming filter
+  F.initInput(x0);
+  M.initInput(x0);
+  for(double t=0; t<1.0; t+=0.01)
+    ASSERT_NEAR(F.filter(signal(t)), M.filter(signal(t)), 1e-12) << "at time t=" << t;
+
+  ASSERT_THROW(M.initInput(std::vector<double>(3, 0.)), std::runtime_error);
+  ASSERT_THROW(M.initOutput(std::vector<double>(1, 0.)), std::runtime_error);
+  ASSERT_THROW(MovingAverageDD(0), std::runtime_error);
+}
+
+
+// Check that blocks of any size (including in-place) match per-sample calls
+TEST(TestMovingAverage, Blocks) {
+  MovingAverageDD M1(13), M2(13), M3(13);
+  std::vector<double> x, y(1000);
+  for(unsigned int i=0; i<1000; i++)
+    x.push_back(signal(0.01*i));
+  std::vector<double> z = x;
+  unsigned int k = 0;
+  for(unsigned int len : {1, 5, 13, 27, 100, 854}) {
+    M2.filter(x.data()+k, y.data()+k, len);
+    M3.filter(z.data()+k, z.data()+k, len);
+    k += len;
+  }
+  ASSERT_EQ(k, x.size());
+  for(unsigned int i=0; i<x.size(); i++) {
+    double y1 = M1.filter(x[i]);
+    ASSERT_DOUBLE_EQ(y1, y[i]) << "at sample " << i;
+    ASSERT_DOUBLE_EQ(y1, z[i]) << "at sample " << i;
+  }
+}
+
+
+// Check that drift is bounded when the input has a large offset
+TEST(TestMovingAverage, Drift) {
+  const unsigned int W = 100;
+  MovingAverageDD running(W, 1., Summation::Running);
+  MovingAverageDD compensated(W, 1., Summation::Compensated);
+  MovingAverageDD periodic(W, 1., Summation::Periodic);
+  std::vector<double> window(W, 0.);
+  double err_running = 0, err_compensated = 0, err_periodic = 0;
+  for(unsigned int i=0; i<1000000; i++) {
+    // alternate huge and tiny values, to maximize rounding errors
+    double x = (i % 2 == 0) ? 1e8 + 0.1*std::sin(0.001*i) : 1e-3*std::cos(0.1*i);
+    window[i % W] = x;
+    double yr = running.filter(x);
+    double yc = compensated.filter(x);
+    double yp = periodic.filter(x);
+    if(i % 1000 == 999) {
+      double exact = 0;
+      for(auto v : window)
+        exact += v;
+      exact /= W;
+      err_running = std::max(err_running, std::abs(yr - exact));
+      err_compensated = std::max(err_compensated, std::abs(yc - exact));
+      err_periodic = std::max(err_periodic, std::abs(yp - exact));
+    }
+  }
+  ASSERT_LT(err_compensated, 1e-6);
+  ASSERT_LT(err_periodic, 1e-6);
+  ASSERT_LE(err_compensated, err_running);
+}
+
+
+// Check that conversions preserve the state
+TEST(TestMovingAverage, TypeChange) {
+  MovingAverageDD M(6);
+  for(double t=0; t<1.0; t+=0.01)
+    M.filter(signal(t));
+  auto N = M.as<float,float>();
+  for(double t=1.0; t<2.0; t+=0.01)
+    ASSERT_NEAR(M.filter(signal(t)), N.filter(signal(t)), 1e-5) << "at time t=" << t;
+}
+
+
+// Check that each channel of a bank behaves as an independent filter
+TEST(TestMovingAverage, Bank) {
+  const unsigned int C = 11;
+  for(auto summation : {Summation::Running, Summation::Compensated, Summation::Periodic}) {
+    MovingAverageBankDD bank(9, C, 3.0, summation);
+    ASSERT_EQ(bank.channels(), C);
+    std::vector<MovingAverageDD> filters(C, MovingAverageDD(9, 3.0));
+    std::vector<double> init(C);
+    for(unsigned int c=0; c<C; c++) {
+      init[c] = c;
+      filters[c].initInput(init[c]);
+    }
+    bank.initInput(init.data());
+
+    const unsigned int frames = 500;
+    std::vector<double> x(frames*C), y(frames*C);
+    for(unsigned int f=0; f<frames; f++)
+      for(unsigned int c=0; c<C; c++)
+        x[f*C+c] = signal(0.01*f + c);
+    bank.filter(x.data(), y.data(), frames);
+    for(unsigned int f=0; f<frames; f++)
+      for(unsigned int c=0; c<C; c++)
+        ASSERT_NEAR(filters[c].filter(x[f*C+c]), y[f*C+c], 1e-12) << "at frame " << f << ", channel " << c;
+  }
+}
+
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,199 @@
+#include <digital_filters/multirate.hpp>
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+typedef digital_filters::Filter<double,double> FilterDD;
+
+
+// Random signal used by the tests
+std::vector<double> randomSignal(std::size_t n) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1., 1.);
+  std::vector<double> x(n);
+  for(auto& xk : x)
+    xk = dist(gen);
+  return x;
+}
+
+
+// Check that the decimator matches filtering followed by downsampling
+TEST(TestMultirate, FirDecimator) {
+  const auto x = randomSignal(1000);
+  for(unsigned int factor : {1, 2, 3, 7}) {
+    const auto taps = digital_filters::windowedSinc<double>(25, 0.4 / factor, 1.);
+    FilterDD F(taps, {1.});
+    digital_filters::FirDecimator<double,double> D(taps, factor);
+    EXPECT_EQ(D.outputs(x.size()), (x.size() + factor - 1) / factor);
+
+    // sample by sample
+    std::size_t count = 0;
+    for(std::size_t k=0; k<x.size(); k++) {
+      const double expected = F.filter(x[k]);
+      double y;
+      const bool output = D.filter(x[k], y);
+      ASSERT_EQ(output, k % factor == 0);
+      if(output) {
+        EXPECT_NEAR(y, expected, 1e-12) << "factor " << factor << ", sample " << k;
+        count++;
+      }
+    }
+    EXPECT_EQ(count, (x.size() + factor - 1) / factor);
+
+    // in blocks of uneven length, in-place
+    D.reset();
+    F.initInput(0.);
+    std::vector<double> y = x;
+    std::size_t written = 0;
+    for(std::size_t start=0, len=1; start<x.size(); start+=len, len+=3) {
+      len = std::min(len, x.size() - start);
+      const std::size_t expected = D.outputs(len);
+      const std::size_t produced = D.filter(y.data() + start, y.data() + written, len);
+      ASSERT_EQ(produced, expected);
+      written += produced;
+    }
+    ASSERT_EQ(written, count);
+    for(std::size_t k=0; k<x.size(); k++) {
+      const double expected = F.filter(x[k]);
+      if(k % factor == 0) {
+        EXPECT_NEAR(y[k / factor], expected, 1e-12) << "factor " << factor << ", sample " << k;
+      }
+    }
+  }
+  EXPECT_THROW((digital_filters::FirDecimator<double,double>({1.}, 0)), std::runtime_error);
+}
+
+
+// Check that the interpolator matches zero-stuffing followed by filtering
+TEST(TestMultirate, FirInterpolator) {
+  const auto x = randomSignal(200);
+  for(unsigned int factor : {1, 2, 3, 5}) {
+    // a length that is not a multiple of the factor
+    const auto taps = digital_filters::windowedSinc<double>(10*factor + 2, 0.5 / factor, 1.);
+    FilterDD F(taps, {1.});
+    digital_filters::FirInterpolator<double,double> I(taps, factor);
+    std::vector<double> y(x.size() * factor);
+    I.filter(x.data(), y.data(), x.size() / 2);
+    for(std::size_t k=x.size()/2; k<x.size(); k++)
+      I.filter(x[k], y.data() + k*factor);
+    for(std::size_t k=0; k<y.size(); k++) {
+      const double expected = F.filter(k % factor == 0 ? x[k / factor] : 0.);
+      EXPECT_NEAR(y[k], expected, 1e-12) << "factor " << factor << ", sample " << k;
+    }
+  }
+}
+
+
+// Check the CIC decimator against a cascade of moving sums
+TEST(TestMultirate, CicDecimator) {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<std::int32_t> dist(-1000, 1000);
+  std::vector<std::int32_t> x(5000);
+  for(auto& xk : x)
+    xk = dist(gen);
+
+  const unsigned int stages = 3, factor = 16, delay = 2;
+  digital_filters::CicDecimator<std::int32_t> C(stages, factor, delay);
+  EXPECT_DOUBLE_EQ(C.gain(), std::pow(factor * delay, stages));
+  EXPECT_EQ(C.bitGrowth(), 15u);
+
+  // reference: N moving sums of length RM, in wide arithmetic
+  std::vector<long long> ref(x.begin(), x.end());
+  for(unsigned int s=0; s<stages; s++) {
+    std::vector<long long> sum(ref.size());
+    long long acc = 0;
+    for(std::size_t k=0; k<ref.size(); k++) {
+      acc += ref[k];
+      if(k >= factor * delay)
+        acc -= ref[k - factor * delay];
+      sum[k] = acc;
+    }
+    ref = sum;
+  }
+
+  // integrators overflow, but the outputs fit in 32 bits
+  std::vector<std::int32_t> y(C.outputs(x.size()));
+  ASSERT_EQ(C.filter(x.data(), y.data(), x.size()), y.size());
+  for(std::size_t m=0; m<y.size(); m++)
+    ASSERT_EQ(y[m], ref[m * factor]) << "output " << m;
+
+  // a constant input is amplified by the gain
+  C.reset();
+  std::int32_t out = 0;
+  for(unsigned int k=0; k<10*factor; k++)
+    C.filter(std::int32_t(3), out);
+  EXPECT_EQ(out, 3 * C.gain());
+  EXPECT_THROW(digital_filters::CicDecimator<int>(0, 4), std::runtime_error);
+}
+
+
+// Check that the IIR decimator matches filtering followed by downsampling
+TEST(TestMultirate, IirDecimator) {
+  const auto x = randomSignal(2000);
+  for(unsigned int factor : {1, 3, 10}) {
+    auto D = digital_filters::iirDecimator<double,double>(factor, 6);
+    auto F = D.design();
+    // blocks longer than the internal chunks
+    std::vector<double> y = x;
+    std::size_t written = D.filter(y.data(), y.data(), 700);
+    written += D.filter(y.data() + 700, y.data() + written, 1);
+    written += D.filter(y.data() + 701, y.data() + written, x.size() - 701);
+    ASSERT_EQ(written, (x.size() + factor - 1) / factor);
+    for(std::size_t k=0; k<x.size(); k++) {
+      const double expected = F.filter(x[k]);
+      if(k % factor == 0) {
+        EXPECT_NEAR(y[k / factor], expected, 1e-12) << "factor " << factor << ", sample " << k;
+      }
+    }
+  }
+}
+
+
+// Check that the designed filters preserve low frequencies and reject aliases
+TEST(TestMultirate, AntiAliasing) {
+  const unsigned int factor = 4;
+  const std::size_t n = 4000;
+  auto amplitude = [&](auto&& decimator, double frequency) {
+    double peak = 0;
+    std::size_t m = 0;
+    for(std::size_t k=0; k<n; k++) {
+      double y;
+      if(decimator.filter(std::sin(2*M_PI*frequency*k), y) && m++ > 200)
+        peak = std::max(peak, std::abs(y));
+    }
+    return peak;
+  };
+
+  // static gain
+  auto fir = digital_filters::firDecimator<double,double>(factor);
+  double y = 0;
+  for(int k=0; k<500; k++)
+    fir.filter(1.0, y);
+  EXPECT_NEAR(y, 1.0, 1e-9);
+
+  // tones above the new Nyquist frequency are rejected
+  const double alias = 0.75 / factor;
+  EXPECT_LT(amplitude(digital_filters::firDecimator<double,double>(factor), alias), 0.01);
+  EXPECT_LT(amplitude(digital_filters::iirDecimator<double,double>(factor), alias), 0.01);
+  EXPECT_GT(amplitude(digital_filters::firDecimator<double,double>(factor), 0.05 / factor), 0.95);
+  EXPECT_GT(amplitude(digital_filters::iirDecimator<double,double>(factor), 0.05 / factor), 0.95);
+
+  // the interpolator preserves the amplitude of the signal
+  auto interp = digital_filters::firInterpolator<double,double>(factor);
+  std::vector<double> out(factor);
+  for(int k=0; k<500; k++)
+    interp.filter(1.0, out.data());
+  for(auto yk : out)
+    EXPECT_NEAR(yk, 1.0, 1e-2);
+
+  EXPECT_THROW(digital_filters::windowedSinc<double>(11, 0.6, 1.), std::runtime_error);
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
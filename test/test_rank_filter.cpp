@@ -0,0 +1,104 @@
+#include <digital_filters/rank_filter.hpp>
+#include <digital_filters/filter_chain.hpp>
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+// Rank of the last samples, evaluated by sorting them
+double bruteForce(
+  const std::vector<double>& x,
+  std::size_t k,
+  std::size_t window,
+  std::size_t rank
+)
+{
+  // past inputs are zero, as in the filter
+  std::vector<double> w(window, 0.);
+  for(std::size_t i=0; i<window && i<=k; i++)
+    w[i] = x[k-i];
+  std::nth_element(w.begin(), w.begin() + rank, w.end());
+  return w[rank];
+}
+
+
+// Check the filter against sorting, for several windows and ranks
+TEST(TestRankFilter, BruteForce) {
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> dist(-1., 1.);
+  std::uniform_int_distribution<int> integers(-3, 3);
+  std::vector<double> x(2000);
+  for(std::size_t k=0; k<x.size(); k++)
+    // many repeated values in the second half
+    x[k] = k < x.size()/2 ? dist(gen) : integers(gen);
+
+  for(std::size_t window : {1, 2, 5, 8, 63}) {
+    for(std::size_t rank : {std::size_t(0), (window-1)/2, window-1}) {
+      digital_filters::RankFilter<double> R(window, rank);
+      EXPECT_EQ(R.windowSize(), window);
+      EXPECT_EQ(R.rank(), rank);
+      for(std::size_t k=0; k<x.size(); k++)
+        ASSERT_EQ(R.filter(x[k]), bruteForce(x, k, window, rank)) << "window " << window << ", rank " << rank << ", sample " << k;
+    }
+  }
+  EXPECT_THROW(digital_filters::RankFilter<double>(0, 0), std::runtime_error);
+  EXPECT_THROW(digital_filters::RankFilter<double>(4, 4), std::runtime_error);
+}
+
+
+// Check the helpers and the block interface
+TEST(TestRankFilter, Median) {
+  auto M = digital_filters::medianFilter<double>(5);
+  EXPECT_EQ(M.rank(), 2);
+  EXPECT_EQ(digital_filters::percentileFilter<double>(11, 0.9).rank(), 9);
+  EXPECT_EQ(digital_filters::percentileFilter<double>(11, 0.).rank(), 0);
+  EXPECT_THROW(digital_filters::percentileFilter<double>(11, 1.5), std::runtime_error);
+
+  // spikes shorter than half of the window are removed, steps are preserved
+  std::vector<double> x(40, 1.);
+  x[10] = 100.;
+  x[11] = -50.;
+  for(std::size_t k=25; k<x.size(); k++)
+    x[k] = 2.;
+  M.initInput(1.);
+  std::vector<double> y = x;
+  M.filter(y.data(), y.data(), y.size());
+  for(std::size_t k=0; k<x.size(); k++)
+    EXPECT_EQ(y[k], k < 27 ? 1. : 2.) << "sample " << k;
+}
+
+
+// Check spike suppression ahead of a linear filter
+TEST(TestRankFilter, Chain) {
+  const std::size_t n = 500;
+  std::vector<double> x(n), clean(n);
+  for(std::size_t k=0; k<n; k++) {
+    clean[k] = std::sin(0.02*k);
+    x[k] = clean[k] + (k % 50 == 7 ? 20. : 0.);
+  }
+  digital_filters::FilterChain<double> chain(64);
+  chain.append(digital_filters::medianFilter<double>(5));
+  chain.append(digital_filters::butterworth<double,double>(2, 5., 100.));
+
+  auto M = digital_filters::medianFilter<double>(5);
+  auto B = digital_filters::butterworth<double,double>(2, 5., 100.);
+  std::vector<double> y(n);
+  chain.filter(x.data(), y.data(), n);
+  for(std::size_t k=0; k<n; k++) {
+    ASSERT_EQ(y[k], B.filter(M.filter(x[k]))) << "sample " << k;
+    // no spike reaches the output
+    if(k > 50) {
+      EXPECT_LT(std::abs(y[k]), 1.1) << "sample " << k;
+    }
+  }
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
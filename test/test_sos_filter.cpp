@@ -0,0 +1,133 @@
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+typedef digital_filters::Filter<double,double> FilterDD;
+typedef digital_filters::SosFilter<double,double> SosFilterDD;
+
+
+// Signal used in most tests
+double signal(
+  double t
+)
+{
+  return std::sin(t) + 0.5*std::cos(10*t);
+}
+
+
+// Check that the sections describe the same butterworth filter
+TEST(TestSosFilter, Butterworth) {
+  FilterDD F = digital_filters::butterworth<double,double>(7, 40., 100.);
+  SosFilterDD S = digital_filters::butterworthSos<double,double>(7, 40., 100.);
+  ASSERT_EQ(S.sections().size(), 4);
+
+  // expanded polynomials should match
+  auto b = S.numerator();
+  auto a = S.denominator();
+  for(unsigned int i=0; i<F.numerator().size(); i++) {
+    ASSERT_NEAR(F.numerator()[i], b[i], 1e-9) << "Mismatching b[" << i << "]";
+    ASSERT_NEAR(F.denominator()[i], a[i], 1e-9) << "Mismatching a[" << i << "]";
+  }
+
+  // and so should the outputs
+  for(double t=0; t<10.0; t+=0.01) {
+    ASSERT_NEAR(F.filter(signal(t)), S.filter(signal(t)), 1e-9) << "at time t=" << t;
+  }
+}
+
+
+// Check that concatenation appends sections
+TEST(TestSosFilter, Concatenation) {
+  FilterDD F({1.0, 0.5}, {1.0, 0.25});
+  FilterDD G({3.0, -2.0, 1.0}, {1.7, 0.5,-0.8});
+  SosFilterDD H = SosFilterDD(F) * G;
+  ASSERT_EQ(H.sections().size(), 2);
+  for(double t=0; t<10.0; t+=0.01) {
+    auto yfg = G.filter(F.filter(signal(t)));
+    ASSERT_FLOAT_EQ(yfg, H.filter(signal(t))) << "at time t=" << t;
+  }
+  // filters of order three cannot be used as sections
+  ASSERT_THROW(H * FilterDD({1.0, 0.0, 0.0, 1.0}, {1.0}), std::runtime_error);
+}
+
+
+// Make sure that block filtering matches sample-by-sample filtering
+TEST(TestSosFilter, Blocks) {
+  SosFilterDD S1 = digital_filters::butterworthSos<double,double>(5, 10., 100.);
+  SosFilterDD S2 = S1;
+  std::vector<double> x;
+  for(double t=0; t<10.0; t+=0.01)
+    x.push_back(signal(t));
+
+  // filter in blocks of different sizes, the second time in-place
+  std::vector<double> y(x.size());
+  std::vector<double> z(x);
+  for(std::size_t k=0, len=1; k<x.size(); k+=len, len=len%7+1) {
+    len = std::min(len, x.size()-k);
+    S1.filter(&x[k], &y[k], len);
+    S2.filter(&z[k], &z[k], len);
+  }
+
+  SosFilterDD S3 = digital_filters::butterworthSos<double,double>(5, 10., 100.);
+  for(unsigned int i=0; i<x.size(); i++) {
+    double yi = S3.filter(x[i]);
+    ASSERT_FLOAT_EQ(yi, y[i]) << "at step i=" << i;
+    ASSERT_FLOAT_EQ(yi, z[i]) << "at step i=" << i;
+  }
+}
+
+
+// Check that high-order filters are well-behaved
+TEST(TestSosFilter, HighOrder) {
+  SosFilterDD S = digital_filters::butterworthSos<double,double>(16, 1., 1000.);
+  // after a long enough time, the step response should settle
+  double y = 0;
+  for(unsigned int i=0; i<100000; i++)
+    y = S.filter(1.0);
+  ASSERT_NEAR(y, 1.0, 1e-9);
+  // steady-state initialization should produce no transients at all
+  S.initSteadyState(2.0);
+  for(unsigned int i=0; i<100; i++)
+    ASSERT_NEAR(S.filter(2.0), 2.0, 1e-9) << "at step i=" << i;
+}
+
+
+// Forward-backward filtering of a constant signal should not alter it
+TEST(TestSosFilter, Filter2) {
+  SosFilterDD S = digital_filters::butterworthSos<double,double>(6, 5., 100.);
+  std::vector<double> x(200, 3.0);
+  auto y = S.filter2(x);
+  ASSERT_EQ(x.size(), y.size());
+  for(unsigned int i=0; i<x.size(); i++)
+    ASSERT_NEAR(x[i], y[i], 1e-9) << "at step i=" << i;
+}
+
+
+// Sections with a pole in z=1 have no steady-state
+TEST(TestSosFilter, Integrator) {
+  SosFilterDD S({{1., 0., 0., 1., -1., 0.}});
+  S.filter(1.0);
+  EXPECT_THROW(S.initSteadyState(1.0), std::runtime_error);
+  EXPECT_EQ(S.filter(1.0), 2.0);
+
+  // both passes start from a zero state
+  std::vector<double> x(50);
+  for(unsigned int i=0; i<x.size(); i++)
+    x[i] = signal(0.1*i);
+  std::vector<double> expected(x);
+  for(unsigned int i=1; i<x.size(); i++)
+    expected[i] += expected[i-1];
+  for(unsigned int i=x.size()-1; i-->0; )
+    expected[i] += expected[i+1];
+  auto y = S.filter2(x);
+  ASSERT_EQ(x.size(), y.size());
+  for(unsigned int i=0; i<x.size(); i++)
+    ASSERT_NEAR(y[i], expected[i], 1e-9) << "at step i=" << i;
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
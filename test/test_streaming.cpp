@@ -0,0 +1,140 @@
+#include <digital_filters/streaming_stage.hpp>
+#include <digital_filters/filters.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+typedef digital_filters::Filter<double,double> FilterDD;
+
+
+// Check order and wrap-around of the queue
+TEST(TestStreaming, Queue) {
+  digital_filters::SpscQueue<int> queue(5);
+  EXPECT_EQ(queue.capacity(), 8);
+  EXPECT_EQ(queue.writeAvailable(), 8);
+  EXPECT_EQ(queue.readAvailable(), 0);
+
+  int next_in = 0, next_out = 0;
+  std::vector<int> block(9);
+  for(int round=0; round<50; round++) {
+    // insert a few elements, possibly more than the free space
+    const std::size_t n = 1 + (round * 5) % 9;
+    for(std::size_t i=0; i<n; i++)
+      block[i] = next_in + i;
+    const std::size_t expected = std::min(n, queue.writeAvailable());
+    const std::size_t pushed = queue.push(block.data(), n);
+    ASSERT_EQ(pushed, expected);
+    next_in += pushed;
+
+    // extract some of them, in order
+    const std::size_t m = 1 + (round * 3) % 7;
+    const std::size_t popped = queue.pop(block.data(), m);
+    ASSERT_EQ(popped, std::min<std::size_t>(m, next_in - next_out));
+    for(std::size_t i=0; i<popped; i++)
+      ASSERT_EQ(block[i], next_out++);
+  }
+
+  int x;
+  while(queue.pop(x))
+    ASSERT_EQ(x, next_out++);
+  EXPECT_EQ(next_out, next_in);
+  EXPECT_THROW(digital_filters::SpscQueue<int>(0), std::runtime_error);
+}
+
+
+// Check the counters and the output of a stage on a single thread
+TEST(TestStreaming, Counters) {
+  auto F = digital_filters::butterworth<double,double>(3, 10., 100.);
+  digital_filters::StreamingStage<double,FilterDD> stage(F, 16, 4);
+
+  std::vector<double> x(20);
+  for(std::size_t k=0; k<x.size(); k++)
+    x[k] = std::sin(0.1*k);
+
+  // the input queue holds 16 samples
+  EXPECT_EQ(stage.push(x.data(), x.size()), 16);
+  EXPECT_EQ(stage.overruns(), 4);
+  EXPECT_EQ(stage.process(), 16);
+  EXPECT_EQ(stage.process(), 0);
+
+  // only 16 filtered samples are available
+  std::vector<double> y(20);
+  EXPECT_EQ(stage.pop(y.data(), y.size()), 16);
+  EXPECT_EQ(stage.underruns(), 4);
+  double yk;
+  EXPECT_FALSE(stage.pop(yk));
+  EXPECT_EQ(stage.underruns(), 5);
+
+  for(std::size_t k=0; k<16; k++)
+    EXPECT_DOUBLE_EQ(y[k], F.filter(x[k])) << "sample " << k;
+
+  // the worker does not drop samples when the output queue is full
+  EXPECT_EQ(stage.push(x.data(), 16), 16);
+  stage.process();
+  EXPECT_EQ(stage.push(x.data(), 10), 10);
+  EXPECT_EQ(stage.process(), 0);
+  EXPECT_EQ(stage.pop(y.data(), 16), 16);
+  EXPECT_EQ(stage.process(), 10);
+  EXPECT_EQ(stage.overruns(), 4);
+
+  EXPECT_THROW((digital_filters::StreamingStage<double,FilterDD>(F, 16, 0)), std::runtime_error);
+}
+
+
+// Stream a signal across three threads
+TEST(TestStreaming, Threads) {
+  const std::size_t n = 200000;
+  std::vector<double> x(n);
+  for(std::size_t k=0; k<n; k++)
+    x[k] = std::sin(0.01*k) + 0.1*std::cos(0.7*k);
+  auto F = digital_filters::butterworthSos<double,double>(4, 10., 100.);
+  std::vector<double> expected(n);
+  auto reference = F;
+  reference.filter(x.data(), expected.data(), n);
+
+  digital_filters::StreamingStage<double,digital_filters::SosFilter<double,double>> stage(F, 1024, 64);
+  std::atomic<bool> produced(false), consumed(false);
+
+  // the producer retries the samples that did not fit, hence overruns are
+  // expected, but no sample is lost
+  std::thread producer([&]() {
+    std::size_t k = 0;
+    while(k < n) {
+      k += stage.push(x.data() + k, std::min<std::size_t>(37, n - k));
+      std::this_thread::yield();
+    }
+    produced = true;
+  });
+  std::thread worker([&]() {
+    while(!consumed) {
+      if(stage.process() == 0)
+        std::this_thread::yield();
+    }
+  });
+
+  std::vector<double> y(n);
+  std::size_t k = 0;
+  while(k < n) {
+    const std::size_t popped = stage.pop(y.data() + k, std::min<std::size_t>(100, n - k));
+    if(popped == 0)
+      std::this_thread::yield();
+    k += popped;
+  }
+  consumed = true;
+  producer.join();
+  worker.join();
+
+  EXPECT_TRUE(produced);
+  for(std::size_t i=0; i<n; i++)
+    ASSERT_EQ(y[i], expected[i]) << "sample " << i;
+}
+
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,6 @@
 #include <digital_filters/utilities.hpp>
 #include <gtest/gtest.h>
+#include <cmath>
 
 
 void checkEquals(
@@ -48,6 +49,69 @@ TEST(TestUtilities, PolyProd) {
 }
 
 
+// Direct evaluation of a polynomial product
+template <class Scalar>
+std::vector<Scalar> directProduct(
+  const std::vector<Scalar>& p1,
+  const std::vector<Scalar>& p2
+)
+{
+  std::vector<Scalar> p(p1.size()+p2.size()-1, Scalar(0));
+  for(unsigned int i=0; i<p1.size(); i++)
+    for(unsigned int j=0; j<p2.size(); j++)
+      p[i+j] += p1[i] * p2[j];
+  return p;
+}
+
+
+TEST(TestUtilities, PolyProdLarge) {
+  // sizes around the thresholds of Karatsuba and FFT, with unequal operands
+  for(unsigned int n1 : {31, 32, 33, 100, 255, 256, 700}) {
+    for(unsigned int n2 : {n1, n1+1, 3*n1+7}) {
+      std::vector<long long> i1(n1), i2(n2);
+      std::vector<double> d1(n1), d2(n2);
+      for(unsigned int i=0; i<n1; i++) {
+        i1[i] = static_cast<long long>((i * 7919) % 201) - 100;
+        d1[i] = std::sin(0.3*i);
+      }
+      for(unsigned int i=0; i<n2; i++) {
+        i2[i] = static_cast<long long>((i * 104729) % 51) - 25;
+        d2[i] = std::cos(0.7*i) + 0.5;
+      }
+      // integers are multiplied exactly (Karatsuba is never replaced by FFT)
+      EXPECT_EQ(digital_filters::polyProd(i1, i2), directProduct(i1, i2)) << "sizes " << n1 << ", " << n2;
+      EXPECT_EQ(digital_filters::polyProd(i2, i1), directProduct(i1, i2)) << "sizes " << n2 << ", " << n1;
+      checkEquals(directProduct(d1, d2), digital_filters::polyProd(d1, d2), 1e-9);
+    }
+  }
+}
+
+
+TEST(TestUtilities, PolyMultiply) {
+  // (1+x+x**2) * (1+x) in-place, without reallocating
+  std::vector<double> p = {1.0, 1.0, 1.0};
+  p.reserve(4);
+  const double* data = p.data();
+  const double q[2] = {1.0, 1.0};
+  digital_filters::polyMultiply(p, q, 2);
+  checkEquals({1.0, 2.0, 2.0, 1.0}, p, 1e-15);
+  EXPECT_EQ(data, p.data());
+
+  // longer factors
+  std::vector<double> p1 = { 1.0, -2.0, 0.0, 1.5};
+  std::vector<double> p2 = {-0.2, 0.0, -2.5, -1.5};
+  digital_filters::polyMultiply(p1, p2.data(), p2.size());
+  checkEquals({-0.2, 0.4, -2.5, 3.2, 3.0, -3.75, -2.25}, p1, 1e-12);
+
+  // binomial coefficients, against repeated products
+  std::vector<double> b = {1.0};
+  for(unsigned int n=0; n<30; n++) {
+    checkEquals(b, digital_filters::binomialCoefficients<double>(n), 0.0);
+    b = digital_filters::polyProd(b, std::vector<double>{1.0, 1.0});
+  }
+}
+
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();